@@ -18,6 +18,8 @@
 #include <epicsAlgorithm.h>
 #include <epicsStdlib.h>
 #include <limits.h>
+#include <float.h>
+#include <math.h>
 #include "epicsStdio.h"
 #include "cvtFast.h"
 
@@ -36,6 +38,274 @@ int aitNoConvert(void* /*dest*/,const void* /*src*/,aitIndex /*count*/, const gd
 #undef AIT_FROM_NET_CONVERT
 #endif
 
+/* ------- fast paths for the string conversions --------- */
+
+// the powers of ten that are exactly representable as a double
+static const double aitExactPowersOfTen[] = {
+    1e0, 1e1, 1e2, 1e3, 1e4, 1e5, 1e6, 1e7, 1e8, 1e9, 1e10,
+    1e11, 1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18, 1e19, 1e20,
+    1e21, 1e22
+};
+static const int aitMaxExactPowerOfTen = 22;
+
+//
+// Converts the common forms of a decimal number, optional blanks, an
+// optional sign, at most 15 significant digits with an optional point,
+// and an optional exponent. The result is correctly rounded when the
+// digits fit in a double and the power of ten is exact, which is all
+// that strtod() can do better, so the result is the same as strtod().
+// Returns false, and leaves the rest to the slow path, for any other
+// string including those with trailing characters.
+//
+static bool aitFastScanDouble ( const char * pString, double & result )
+{
+    const char * p = pString;
+    while ( *p == ' ' ) {
+        p++;
+    }
+    bool negative = false;
+    if ( *p == '-' || *p == '+' ) {
+        negative = *p == '-';
+        p++;
+    }
+    // exact, because 15 digits are always fewer than the 53 bit mantissa
+    double mantissa = 0.0;
+    unsigned nSignificant = 0u;
+    unsigned nDigits = 0u;
+    int exp10 = 0;
+    while ( *p >= '0' && *p <= '9' ) {
+        if ( mantissa || *p != '0' ) {
+            mantissa = mantissa * 10.0 + ( *p - '0' );
+            nSignificant++;
+        }
+        nDigits++;
+        p++;
+    }
+    if ( *p == '.' ) {
+        p++;
+        while ( *p >= '0' && *p <= '9' ) {
+            if ( mantissa || *p != '0' ) {
+                mantissa = mantissa * 10.0 + ( *p - '0' );
+                nSignificant++;
+            }
+            nDigits++;
+            exp10--;
+            p++;
+        }
+    }
+    if ( nDigits == 0u || nSignificant > 15u ) {
+        return false;
+    }
+    if ( *p == 'e' || *p == 'E' ) {
+        p++;
+        bool negativeExp = false;
+        if ( *p == '-' || *p == '+' ) {
+            negativeExp = *p == '-';
+            p++;
+        }
+        if ( *p < '0' || *p > '9' ) {
+            return false;
+        }
+        int exp = 0;
+        while ( *p >= '0' && *p <= '9' ) {
+            if ( exp < 10000 ) {
+                exp = exp * 10 + ( *p - '0' );
+            }
+            p++;
+        }
+        exp10 += negativeExp ? -exp : exp;
+    }
+    while ( *p == ' ' ) {
+        p++;
+    }
+    if ( *p != '\0' ) {
+        return false;
+    }
+    if ( exp10 > aitMaxExactPowerOfTen ||
+            exp10 < -aitMaxExactPowerOfTen ) {
+        return false;
+    }
+    double value = mantissa;
+    if ( exp10 < 0 ) {
+        value /= aitExactPowersOfTen[-exp10];
+    }
+    else {
+        value *= aitExactPowersOfTen[exp10];
+    }
+    result = negative ? -value : value;
+    return true;
+}
+
+//
+// Rounds a finite positive double to six significant
+// digits as the "%g" format does, setting digits in [100000,999999] and
+// the decimal exponent of the first digit. Integers that fit in an
+// unsigned are rounded exactly, half to even. Other values are scaled by an exact power of ten, which
+// is in error by at most half an ulp, so false is returned when the
+// scaled value is too close to a tie, or to a change of the exponent,
+// to be sure of the rounding.
+//
+static bool aitRoundToSixDigits ( double mag,
+    aitUint32 & digits, int & exp10 )
+{
+    if ( mag <= UINT_MAX &&
+            mag == static_cast < double > ( static_cast < unsigned > ( mag ) ) ) {
+        unsigned n = static_cast < unsigned > ( mag );
+        int nDigits = 1;
+        for ( unsigned t = n; t >= 10u; t /= 10u ) {
+            nDigits++;
+        }
+        exp10 = nDigits - 1;
+        if ( nDigits <= 6 ) {
+            digits = static_cast < aitUint32 > ( n *
+                static_cast < unsigned > ( aitExactPowersOfTen[6 - nDigits] ) );
+            return true;
+        }
+        unsigned divisor = static_cast < unsigned >
+            ( aitExactPowersOfTen[nDigits - 6] );
+        unsigned q = n / divisor;
+        unsigned r = n % divisor;
+        if ( r > divisor - r || ( r == divisor - r && ( q & 1u ) ) ) {
+            q++;
+        }
+        if ( q > 999999u ) {
+            q /= 10u;
+            exp10++;
+        }
+        digits = static_cast < aitUint32 > ( q );
+        return true;
+    }
+
+    // estimate the exponent from the binary exponent
+    int exp2;
+    frexp ( mag, & exp2 );
+    exp10 = static_cast < int > ( floor ( ( exp2 - 1 ) * 0.30102999566398120 ) );
+    for ( unsigned pass = 0u; pass < 2u; pass++ ) {
+        int scale = 5 - exp10;
+        if ( scale > aitMaxExactPowerOfTen || scale < -aitMaxExactPowerOfTen ) {
+            return false;
+        }
+        double scaled = scale >= 0 ?
+            mag * aitExactPowersOfTen[scale] :
+            mag / aitExactPowersOfTen[-scale];
+        // the error in scaled is below 1e-10, this leaves a wide margin
+        static const double margin = 1e-7;
+        if ( scaled < 100000.0 - margin ) {
+            exp10--;
+            continue;
+        }
+        if ( scaled >= 999999.5 + margin ) {
+            exp10++;
+            continue;
+        }
+        if ( scaled < 100000.0 + margin ) {
+            return false;
+        }
+        double whole = floor ( scaled );
+        double fraction = scaled - whole;
+        if ( fraction > 0.5 - margin && fraction < 0.5 + margin ) {
+            return false;
+        }
+        digits = static_cast < aitUint32 > ( whole );
+        if ( fraction > 0.5 ) {
+            digits++;
+        }
+        if ( digits > 999999u ) {
+            digits = 100000u;
+            exp10++;
+        }
+        return true;
+    }
+    return false;
+}
+
+//
+// Writes a finite double using the "%g" format, with the same text as
+// printf() but without the locale and the format parsing. Returns the
+// number of characters written, or -1 when the slow path must be used.
+//
+static int aitFastFormatDouble ( double in, char * pString, size_t strSize )
+{
+    // sign, 6 digits, point, and "e+308", or sign, "0.000", and 6 digits
+    static const size_t maxSize = 16u;
+    // zero, which may be negative, nan, and infinity are left to printf()
+    if ( strSize < maxSize || in == 0.0 || in != in ||
+            in > DBL_MAX || in < -DBL_MAX ) {
+        return -1;
+    }
+    char * p = pString;
+    double mag = in;
+    if ( in < 0.0 ) {
+        *p++ = '-';
+        mag = -in;
+    }
+    aitUint32 digits;
+    int exp10;
+    if ( ! aitRoundToSixDigits ( mag, digits, exp10 ) ) {
+        return -1;
+    }
+    char text[6];
+    for ( int i = 5; i >= 0; i-- ) {
+        text[i] = static_cast < char > ( '0' + digits % 10u );
+        digits /= 10u;
+    }
+    // trailing zeros are not written
+    int nText = 6;
+    while ( nText > 1 && text[nText - 1] == '0' ) {
+        nText--;
+    }
+    if ( exp10 >= -4 && exp10 < 6 ) {
+        if ( exp10 < 0 ) {
+            *p++ = '0';
+            *p++ = '.';
+            for ( int i = -1; i > exp10; i-- ) {
+                *p++ = '0';
+            }
+            for ( int i = 0; i < nText; i++ ) {
+                *p++ = text[i];
+            }
+        }
+        else {
+            int i = 0;
+            for ( ; i <= exp10; i++ ) {
+                *p++ = i < nText ? text[i] : '0';
+            }
+            if ( i < nText ) {
+                *p++ = '.';
+                for ( ; i < nText; i++ ) {
+                    *p++ = text[i];
+                }
+            }
+        }
+    }
+    else {
+        *p++ = text[0];
+        if ( nText > 1 ) {
+            *p++ = '.';
+            for ( int i = 1; i < nText; i++ ) {
+                *p++ = text[i];
+            }
+        }
+        *p++ = 'e';
+        unsigned exp;
+        if ( exp10 < 0 ) {
+            *p++ = '-';
+            exp = static_cast < unsigned > ( -exp10 );
+        }
+        else {
+            *p++ = '+';
+            exp = static_cast < unsigned > ( exp10 );
+        }
+        if ( exp >= 100u ) {
+            *p++ = static_cast < char > ( '0' + exp / 100u );
+        }
+        *p++ = static_cast < char > ( '0' + exp / 10u % 10u );
+        *p++ = static_cast < char > ( '0' + exp % 10u );
+    }
+    *p = '\0';
+    return static_cast < int > ( p - pString );
+}
+
 /* put the fixed conversion functions here (ones not generated) */
 
 bool getStringAsDouble ( const char * pString, 
@@ -49,7 +319,7 @@ bool getStringAsDouble ( const char * pString,
     if ( pEST && pEST->getIndex ( pString, itmp ) ) {
         ftmp = itmp;
     }
-    else {
+    else if ( ! aitFastScanDouble ( pString, ftmp ) ) {
         int j = epicsScanDouble ( pString, &ftmp );
         if ( j != 1 ) {
             j = sscanf ( pString, "%lf", &ftmp );
@@ -94,8 +364,11 @@ bool putDoubleToString (
         nChar = cvtDoubleToString ( in, pString, 4 );
     }
     else {
-	    nChar = epicsSnprintf ( 
-            pString, strSize-1, "%g", in );
+        nChar = aitFastFormatDouble ( in, pString, strSize );
+        if ( nChar < 0 ) {
+            nChar = epicsSnprintf (
+                pString, strSize-1, "%g", in );
+        }
     }
     if ( nChar < 1 ) {
         return false;
@@ -19,6 +19,7 @@
 #include "gddApps.h"
 #include "gddAppTable.h"
 #include "dbMapper.h"
+#include "gddView.h"
 // #include "templates/dbMapperTempl.h"
 
 // hardcoded in same order as aitConvert.h
@@ -102,6 +103,23 @@ epicsShareDef gddDbrToAitTable gddDbrToAit[DBM_N_DBR_TYPES] = {
 static gddApplicationTypeTable* type_table = NULL;
 static aitDataFormat local_data_format=aitLocalDataFormat;
 
+//
+// Copy the value when the DD already holds the DBR's primitive type,
+// which avoids the aitConvert() dispatch in the common case.  Returns
+// -1 when the types differ and a conversion is needed.
+//
+template <class T>
+static inline int mapGddToSameType(T* dbv, aitIndex count, const gdd& dd)
+{
+	gddArrayView<const T> view(dd);
+	if(!view.valid() || view.size()<count) return -1;
+	if(count==1u)
+		dbv[0]=view[0];
+	else
+		memcpy(dbv,view.pointer(),count*sizeof(T));
+	return (int)(count*sizeof(T));
+}
+
 extern epicsShareDef const unsigned gddAitToDbrNElem = 
         sizeof(gddDbrToAit)/sizeof(gddDbrToAit[0]);
 
@@ -141,7 +159,7 @@ static smartGDDPointer mapStringToGdd(void* v,aitIndex count) {
         dd->unreference();
         aitFixedString* pCopy = new aitFixedString [count];
         memcpy (pCopy,db,sizeof(aitFixedString)*count);
-		dd->putRef(db,new dbMapperFixedStringDestructor);
+		dd->putRef(pCopy,new dbMapperFixedStringDestructor);
 	    return dd;
 	}
 }
@@ -208,8 +226,10 @@ static int mapGddToShort(void* vd, aitIndex count, const gdd &dd,
 
 	if (local_data_format==aitLocalDataFormat) {
 		if((dbr_short_t*)v!=sv) {
-			status = aitConvert(aitEnumInt16,sv,
-                dd.primitiveType(),v,count, &enumStringTable);
+			status = mapGddToSameType(sv,count,dd);
+			if(status<0)
+				status = aitConvert(aitEnumInt16,sv,
+                    dd.primitiveType(),v,count, &enumStringTable);
 		}
 		else {
 			status = count*sizeof(dbr_short_t);
@@ -256,8 +276,10 @@ static int mapGddToFloat(void* vd, aitIndex count,
 
 	if(local_data_format==aitLocalDataFormat) {
 		if((dbr_float_t*)v!=sv) {
-			status = aitConvert(aitEnumFloat32,sv,
-                dd.primitiveType(),v,count, &enumStringTable);
+			status = mapGddToSameType(sv,count,dd);
+			if(status<0)
+				status = aitConvert(aitEnumFloat32,sv,
+                    dd.primitiveType(),v,count, &enumStringTable);
 		}
 		else {
 			status = sz*sizeof(dbr_float_t);
@@ -304,8 +326,10 @@ static int mapGddToEnum(void* vd, aitIndex count, const gdd & dd,
 
 	if(local_data_format==aitLocalDataFormat) {
 		if((dbr_enum_t*)v!=sv) {
-			status = aitConvert(aitEnumEnum16,sv,
-                dd.primitiveType(),v,count, &enumStringTable);
+			status = mapGddToSameType(sv,count,dd);
+			if(status<0)
+				status = aitConvert(aitEnumEnum16,sv,
+                    dd.primitiveType(),v,count, &enumStringTable);
 		}
 		else {
 			status = sizeof(dbr_enum_t)*count;
@@ -352,8 +376,13 @@ static int mapGddToChar(void* vd, aitIndex count,
 
 	if (local_data_format==aitLocalDataFormat) {
 		if((dbr_char_t*)v!=sv) {
-			status = aitConvert(aitEnumInt8,sv,
-                dd.primitiveType(),v,count, &enumStringTable);
+			// the DBR char is copied bit for bit from either 8 bit type
+			status = mapGddToSameType((aitInt8*)sv,count,dd);
+			if(status<0)
+				status = mapGddToSameType((aitUint8*)sv,count,dd);
+			if(status<0)
+				status = aitConvert(aitEnumInt8,sv,
+                    dd.primitiveType(),v,count, &enumStringTable);
 		}
 		else {
 			status = sz*sizeof(dbr_char_t);
@@ -400,8 +429,10 @@ static int mapGddToLong(void* vd, aitIndex count, const gdd & dd,
 
 	if (local_data_format==aitLocalDataFormat) {
 		if ((dbr_long_t*)v!=sv) {
-			status = aitConvert(aitEnumInt32,sv,
-                dd.primitiveType(),v,count, &enumStringTable);
+			status = mapGddToSameType(sv,count,dd);
+			if(status<0)
+				status = aitConvert(aitEnumInt32,sv,
+                    dd.primitiveType(),v,count, &enumStringTable);
 		}
 		else {
 			status = count*sizeof(dbr_long_t);
@@ -448,8 +479,10 @@ static int mapGddToDouble(void* vd, aitIndex count, const gdd & dd,
 
 	if (local_data_format==aitLocalDataFormat) {
 		if ((dbr_double_t*)v!=sv) {
-			status = aitConvert(aitEnumFloat64,sv,
-                dd.primitiveType(),v,count, &enumStringTable);
+			status = mapGddToSameType(sv,count,dd);
+			if(status<0)
+				status = aitConvert(aitEnumFloat64,sv,
+                    dd.primitiveType(),v,count, &enumStringTable);
 		}
 		else {
 			status = count*sizeof(dbr_double_t);
@@ -463,6 +496,210 @@ static int mapGddToDouble(void* vd, aitIndex count, const gdd & dd,
 	return status;
 }
 
+// ********************************************************************
+//                  templates for the structure encoders
+// ********************************************************************
+
+// The encoders for the sts, time, graphic, and control structures of the
+// numeric and string types are instantiated from the templates below, one
+// per DBR structure, and installed in gddMapDbr.  The enum graphic and
+// control structures, the ack structures, and the class name are still
+// encoded by hand.
+
+// the value of each DBR structure is encoded by the atomic mapper
+static inline int mapGddToValue(dbr_string_t* v, aitIndex count,
+	const gdd& dd, const gddEnumStringTable& enumStringTable)
+	{ return mapGddToString(v,count,dd,enumStringTable); }
+static inline int mapGddToValue(dbr_short_t* v, aitIndex count,
+	const gdd& dd, const gddEnumStringTable& enumStringTable)
+	{ return mapGddToShort(v,count,dd,enumStringTable); }
+static inline int mapGddToValue(dbr_float_t* v, aitIndex count,
+	const gdd& dd, const gddEnumStringTable& enumStringTable)
+	{ return mapGddToFloat(v,count,dd,enumStringTable); }
+static inline int mapGddToValue(dbr_enum_t* v, aitIndex count,
+	const gdd& dd, const gddEnumStringTable& enumStringTable)
+	{ return mapGddToEnum(v,count,dd,enumStringTable); }
+static inline int mapGddToValue(dbr_char_t* v, aitIndex count,
+	const gdd& dd, const gddEnumStringTable& enumStringTable)
+	{ return mapGddToChar(v,count,dd,enumStringTable); }
+static inline int mapGddToValue(dbr_long_t* v, aitIndex count,
+	const gdd& dd, const gddEnumStringTable& enumStringTable)
+	{ return mapGddToLong(v,count,dd,enumStringTable); }
+static inline int mapGddToValue(dbr_double_t* v, aitIndex count,
+	const gdd& dd, const gddEnumStringTable& enumStringTable)
+	{ return mapGddToDouble(v,count,dd,enumStringTable); }
+
+// the padding is cleared to shut up purify
+template <class DBR>
+static inline void clearPad(DBR&) {}
+static inline void clearPad(dbr_sts_char& db) { db.RISC_pad='\0'; }
+static inline void clearPad(dbr_sts_double& db) { db.RISC_pad=0; }
+static inline void clearPad(dbr_time_short& db) { db.RISC_pad=0; }
+static inline void clearPad(dbr_time_enum& db) { db.RISC_pad=0; }
+static inline void clearPad(dbr_time_char& db)
+	{ db.RISC_pad0=0; db.RISC_pad1='\0'; }
+static inline void clearPad(dbr_time_double& db) { db.RISC_pad=0; }
+static inline void clearPad(dbr_gr_float& db) { db.RISC_pad0=0; }
+static inline void clearPad(dbr_gr_char& db) { db.RISC_pad='\0'; }
+static inline void clearPad(dbr_gr_double& db) { db.RISC_pad0=0; }
+static inline void clearPad(dbr_ctrl_float& db) { db.RISC_pad=0; }
+static inline void clearPad(dbr_ctrl_char& db) { db.RISC_pad='\0'; }
+static inline void clearPad(dbr_ctrl_double& db) { db.RISC_pad0=0; }
+
+//
+// A limit is usually posted as a scalar of the DBR's own type or as an
+// aitFloat64.  Either is converted here with a cast, which is what
+// aitConvert() would do, without the dispatch through its tables.
+//
+template <class T>
+static inline void mapGddToLimit(T& limit, const gdd& dd)
+{
+	if(dd.isScalar())
+	{
+		const aitType& d=dd.getData();
+		switch(dd.primitiveType())
+		{
+		case aitEnumInt8:		limit=(T)d.Int8; return;
+		case aitEnumUint8:		limit=(T)d.Uint8; return;
+		case aitEnumInt16:		limit=(T)d.Int16; return;
+		case aitEnumUint16:		limit=(T)d.Uint16; return;
+		case aitEnumEnum16:		limit=(T)d.Enum16; return;
+		case aitEnumInt32:		limit=(T)d.Int32; return;
+		case aitEnumUint32:		limit=(T)d.Uint32; return;
+		case aitEnumFloat32:	limit=(T)d.Float32; return;
+		case aitEnumFloat64:	limit=(T)d.Float64; return;
+		default: break;
+		}
+	}
+	dd.get(limit);
+}
+
+// the positions of the fields in the graphic and control containers
+template <class DBR> struct dbMapperIndex;
+
+#define DBMAPPER_GRAPHIC_INDEX(DBR) \
+template <> struct dbMapperIndex<DBR> { \
+	enum { \
+		units=gddAppTypeIndex_##DBR##_units, \
+		alarmLowWarning=gddAppTypeIndex_##DBR##_alarmLowWarning, \
+		alarmHighWarning=gddAppTypeIndex_##DBR##_alarmHighWarning, \
+		alarmLow=gddAppTypeIndex_##DBR##_alarmLow, \
+		alarmHigh=gddAppTypeIndex_##DBR##_alarmHigh, \
+		graphicLow=gddAppTypeIndex_##DBR##_graphicLow, \
+		graphicHigh=gddAppTypeIndex_##DBR##_graphicHigh, \
+		value=gddAppTypeIndex_##DBR##_value \
+	}; \
+};
+
+#define DBMAPPER_CONTROL_INDEX(DBR) \
+template <> struct dbMapperIndex<DBR> { \
+	enum { \
+		units=gddAppTypeIndex_##DBR##_units, \
+		alarmLowWarning=gddAppTypeIndex_##DBR##_alarmLowWarning, \
+		alarmHighWarning=gddAppTypeIndex_##DBR##_alarmHighWarning, \
+		alarmLow=gddAppTypeIndex_##DBR##_alarmLow, \
+		alarmHigh=gddAppTypeIndex_##DBR##_alarmHigh, \
+		controlLow=gddAppTypeIndex_##DBR##_controlLow, \
+		controlHigh=gddAppTypeIndex_##DBR##_controlHigh, \
+		graphicLow=gddAppTypeIndex_##DBR##_graphicLow, \
+		graphicHigh=gddAppTypeIndex_##DBR##_graphicHigh, \
+		value=gddAppTypeIndex_##DBR##_value \
+	}; \
+};
+
+DBMAPPER_GRAPHIC_INDEX(dbr_gr_short)
+DBMAPPER_GRAPHIC_INDEX(dbr_gr_float)
+DBMAPPER_GRAPHIC_INDEX(dbr_gr_char)
+DBMAPPER_GRAPHIC_INDEX(dbr_gr_long)
+DBMAPPER_GRAPHIC_INDEX(dbr_gr_double)
+DBMAPPER_CONTROL_INDEX(dbr_ctrl_short)
+DBMAPPER_CONTROL_INDEX(dbr_ctrl_float)
+DBMAPPER_CONTROL_INDEX(dbr_ctrl_char)
+DBMAPPER_CONTROL_INDEX(dbr_ctrl_long)
+DBMAPPER_CONTROL_INDEX(dbr_ctrl_double)
+
+// only the floating point structures carry a precision
+template <class DBR>
+static inline void mapGddToPrecision(DBR&, const gdd&) {}
+
+#define DBMAPPER_PRECISION(DBR) \
+static inline void mapGddToPrecision(DBR& db, const gdd& dd) \
+	{ mapGddToLimit(db.precision,dd[gddAppTypeIndex_##DBR##_precision]); }
+
+DBMAPPER_PRECISION(dbr_gr_float)
+DBMAPPER_PRECISION(dbr_gr_double)
+DBMAPPER_PRECISION(dbr_ctrl_float)
+DBMAPPER_PRECISION(dbr_ctrl_double)
+
+// the fields common to the graphic and control structures
+template <class DBR>
+static inline void mapGddToGraphic(DBR& db, const gdd& dd)
+{
+	typedef dbMapperIndex<DBR> index;
+	const aitString* str;
+
+	dd[index::units].getRef(str);
+	if(str->string()) {
+		strncpy(db.units,str->string(), sizeof(db.units));
+		db.units[sizeof(db.units)-1u] = '\0';
+	}
+
+	mapGddToPrecision(db,dd);
+	mapGddToLimit(db.lower_disp_limit,dd[index::graphicLow]);
+	mapGddToLimit(db.upper_disp_limit,dd[index::graphicHigh]);
+	mapGddToLimit(db.lower_alarm_limit,dd[index::alarmLow]);
+	mapGddToLimit(db.upper_alarm_limit,dd[index::alarmHigh]);
+	mapGddToLimit(db.lower_warning_limit,dd[index::alarmLowWarning]);
+	mapGddToLimit(db.upper_warning_limit,dd[index::alarmHighWarning]);
+	clearPad(db);
+}
+
+template <class DBR>
+static int mapStsGddToDbr(void* v, aitIndex count, const gdd & dd, const gddEnumStringTable &enumStringTable)
+{
+	DBR* db = (DBR*)v;
+	dd.getStatSevr(db->status,db->severity);
+	clearPad(*db);
+	return mapGddToValue(&db->value,count,dd,enumStringTable);
+}
+
+template <class DBR>
+static int mapTimeGddToDbr(void* v, aitIndex count, const gdd & dd, const gddEnumStringTable &enumStringTable)
+{
+	DBR* db = (DBR*)v;
+	dd.getStatSevr(db->status,db->severity);
+	dd.getTimeStamp(&db->stamp);
+	clearPad(*db);
+	return mapGddToValue(&db->value,count,dd,enumStringTable);
+}
+
+template <class DBR>
+static int mapGraphicGddToDbr(void* v, aitIndex count, const gdd & dd, const gddEnumStringTable &enumStringTable)
+{
+	DBR* db = (DBR*)v;
+	const gdd& vdd = dd[dbMapperIndex<DBR>::value];
+
+	mapGddToGraphic(*db,dd);
+
+	vdd.getStatSevr(db->status,db->severity);
+	return mapGddToValue(&db->value,count,vdd,enumStringTable);
+}
+
+template <class DBR>
+static int mapControlGddToDbr(void* v, aitIndex count, const gdd & dd, const gddEnumStringTable &enumStringTable)
+{
+	typedef dbMapperIndex<DBR> index;
+	DBR* db = (DBR*)v;
+	const gdd& vdd = dd[index::value];
+
+	mapGddToGraphic(*db,dd);
+	mapGddToLimit(db->lower_ctrl_limit,dd[index::controlLow]);
+	mapGddToLimit(db->upper_ctrl_limit,dd[index::controlHigh]);
+
+	vdd.getStatSevr(db->status,db->severity);
+	return mapGddToValue(&db->value,count,vdd,enumStringTable);
+}
+
 // ********************************************************************
 //                      sts structure mappings
 // ********************************************************************
@@ -494,15 +731,6 @@ static smartGDDPointer mapStsStringToGdd(void* v,aitIndex count)
 	return dd;
 }
 
-static int mapStsGddToString(void* v, aitIndex count, const gdd & dd, const gddEnumStringTable &enumStringTable)
-{
-	dbr_sts_string* db = (dbr_sts_string*)v;
-	aitFixedString* dbv = (aitFixedString*)db->value;
-
-	dd.getStatSevr(db->status,db->severity);
-	return mapGddToString(dbv, count, dd, enumStringTable);
-}
-
 static smartGDDPointer mapStsShortToGdd(void* v,aitIndex count)
 {
 	dbr_sts_short* dbv = (dbr_sts_short*)v;
@@ -511,13 +739,6 @@ static smartGDDPointer mapStsShortToGdd(void* v,aitIndex count)
 	return dd;
 }
 
-static int mapStsGddToShort(void* v, aitIndex count, const gdd & dd, const gddEnumStringTable &enumStringTable)
-{
-	dbr_sts_short* dbv = (dbr_sts_short*)v;
-	dd.getStatSevr(dbv->status,dbv->severity);
-	return mapGddToShort(&dbv->value, count, dd, enumStringTable);
-}
-
 static smartGDDPointer mapStsFloatToGdd(void* v,aitIndex count)
 {
 	dbr_sts_float* dbv = (dbr_sts_float*)v;
@@ -526,13 +747,6 @@ static smartGDDPointer mapStsFloatToGdd(void* v,aitIndex count)
 	return dd;
 }
 
-static int mapStsGddToFloat(void* v, aitIndex count, const gdd & dd, const gddEnumStringTable &enumStringTable)
-{
-	dbr_sts_float* dbv = (dbr_sts_float*)v;
-	dd.getStatSevr(dbv->status,dbv->severity);
-	return mapGddToFloat(&dbv->value,count,dd, enumStringTable);
-}
-
 static smartGDDPointer mapStsEnumToGdd(void* v,aitIndex count)
 {
 	dbr_sts_enum* dbv = (dbr_sts_enum*)v;
@@ -541,13 +755,6 @@ static smartGDDPointer mapStsEnumToGdd(void* v,aitIndex count)
 	return dd;
 }
 
-static int mapStsGddToEnum(void* v, aitIndex count, const gdd & dd, const gddEnumStringTable &enumStringTable)
-{
-	dbr_sts_enum* dbv = (dbr_sts_enum*)v;
-	dd.getStatSevr(dbv->status,dbv->severity);
-	return mapGddToEnum(&dbv->value,count,dd, enumStringTable);
-}
-
 static smartGDDPointer mapStsCharToGdd(void* v,aitIndex count)
 {
 	dbr_sts_char* dbv = (dbr_sts_char*)v;
@@ -556,14 +763,6 @@ static smartGDDPointer mapStsCharToGdd(void* v,aitIndex count)
 	return dd;
 }
 
-static int mapStsGddToChar(void* v, aitIndex count, const gdd & dd, const gddEnumStringTable &enumStringTable)
-{
-	dbr_sts_char* dbv = (dbr_sts_char*)v;
-	dd.getStatSevr(dbv->status,dbv->severity);
-	dbv->RISC_pad = '\0'; // shut up purify
-	return mapGddToChar(&dbv->value,count,dd, enumStringTable);
-}
-
 static smartGDDPointer mapStsLongToGdd(void* v,aitIndex count)
 {
 	dbr_sts_long* dbv = (dbr_sts_long*)v;
@@ -572,13 +771,6 @@ static smartGDDPointer mapStsLongToGdd(void* v,aitIndex count)
 	return dd;
 }
 
-static int mapStsGddToLong(void* v, aitIndex count, const gdd & dd, const gddEnumStringTable &enumStringTable)
-{
-	dbr_sts_long* dbv = (dbr_sts_long*)v;
-	dd.getStatSevr(dbv->status,dbv->severity);
-	return mapGddToLong(&dbv->value,count,dd, enumStringTable);
-}
-
 static smartGDDPointer mapStsDoubleToGdd(void* v,aitIndex count)
 {
 	dbr_sts_double* dbv = (dbr_sts_double*)v;
@@ -587,14 +779,6 @@ static smartGDDPointer mapStsDoubleToGdd(void* v,aitIndex count)
 	return dd;
 }
 
-static int mapStsGddToDouble(void* v, aitIndex count, const gdd & dd, const gddEnumStringTable &enumStringTable)
-{
-	dbr_sts_double* dbv = (dbr_sts_double*)v;
-	dd.getStatSevr(dbv->status,dbv->severity);
-	dbv->RISC_pad = 0; // shut up purify
-	return mapGddToDouble(&dbv->value,count,dd, enumStringTable);
-}
-
 // ********************************************************************
 //                      time structure mappings
 // ********************************************************************
@@ -627,16 +811,6 @@ static smartGDDPointer mapTimeStringToGdd(void* v,aitIndex count)
 	return dd;
 }
 
-static int mapTimeGddToString(void* v, aitIndex count, const gdd & dd, const gddEnumStringTable &enumStringTable)
-{
-	dbr_time_string* db = (dbr_time_string*)v;
-	aitFixedString* dbv = (aitFixedString*)db->value;
-
-	dd.getStatSevr(db->status,db->severity);
-	dd.getTimeStamp(&db->stamp);
-	return mapGddToString(dbv, count, dd, enumStringTable);
-}
-
 static smartGDDPointer mapTimeShortToGdd(void* v,aitIndex count)
 {
 	dbr_time_short* dbv = (dbr_time_short*)v;
@@ -646,15 +820,6 @@ static smartGDDPointer mapTimeShortToGdd(void* v,aitIndex count)
 	return dd;
 }
 
-static int mapTimeGddToShort(void* v, aitIndex count, const gdd & dd, const gddEnumStringTable &enumStringTable)
-{
-	dbr_time_short* dbv = (dbr_time_short*)v;
-	dd.getStatSevr(dbv->status,dbv->severity);
-	dd.getTimeStamp(&dbv->stamp);
-	dbv->RISC_pad = 0; // shut up purify
-	return mapGddToShort(&dbv->value,count,dd, enumStringTable);
-}
-
 static smartGDDPointer mapTimeFloatToGdd(void* v,aitIndex count)
 {
 	dbr_time_float* dbv = (dbr_time_float*)v;
@@ -664,14 +829,6 @@ static smartGDDPointer mapTimeFloatToGdd(void* v,aitIndex count)
 	return dd;
 }
 
-static int mapTimeGddToFloat(void* v, aitIndex count, const gdd & dd, const gddEnumStringTable &enumStringTable)
-{
-	dbr_time_float* dbv = (dbr_time_float*)v;
-	dd.getStatSevr(dbv->status,dbv->severity);
-	dd.getTimeStamp(&dbv->stamp);
-	return mapGddToFloat(&dbv->value,count,dd, enumStringTable);
-}
-
 static smartGDDPointer mapTimeEnumToGdd(void* v,aitIndex count)
 {
 	dbr_time_enum* dbv = (dbr_time_enum*)v;
@@ -681,15 +838,6 @@ static smartGDDPointer mapTimeEnumToGdd(void* v,aitIndex count)
 	return dd;
 }
 
-static int mapTimeGddToEnum(void* v, aitIndex count, const gdd & dd, const gddEnumStringTable &enumStringTable)
-{
-	dbr_time_enum* dbv = (dbr_time_enum*)v;
-	dd.getStatSevr(dbv->status,dbv->severity);
-	dd.getTimeStamp(&dbv->stamp);
-	dbv->RISC_pad = 0; // shut up purify
-	return mapGddToEnum(&dbv->value,count,dd, enumStringTable);
-}
-
 static smartGDDPointer mapTimeCharToGdd(void* v,aitIndex count)
 {
 	dbr_time_char* dbv = (dbr_time_char*)v;
@@ -699,16 +847,6 @@ static smartGDDPointer mapTimeCharToGdd(void* v,aitIndex count)
 	return dd;
 }
 
-static int mapTimeGddToChar(void* v, aitIndex count, const gdd & dd, const gddEnumStringTable &enumStringTable)
-{
-	dbr_time_char* dbv = (dbr_time_char*)v;
-	dd.getStatSevr(dbv->status,dbv->severity);
-	dd.getTimeStamp(&dbv->stamp);
-	dbv->RISC_pad0 = 0; // shut up purify
-	dbv->RISC_pad1 = '\0'; // shut up purify
-	return mapGddToChar(&dbv->value,count,dd, enumStringTable);
-}
-
 static smartGDDPointer mapTimeLongToGdd(void* v,aitIndex count)
 {
 	dbr_time_long* dbv = (dbr_time_long*)v;
@@ -718,14 +856,6 @@ static smartGDDPointer mapTimeLongToGdd(void* v,aitIndex count)
 	return dd;
 }
 
-static int mapTimeGddToLong(void* v, aitIndex count, const gdd & dd, const gddEnumStringTable &enumStringTable)
-{
-	dbr_time_long* dbv = (dbr_time_long*)v;
-	dd.getStatSevr(dbv->status,dbv->severity);
-	dd.getTimeStamp(&dbv->stamp);
-	return mapGddToLong(&dbv->value,count,dd, enumStringTable);
-}
-
 static smartGDDPointer mapTimeDoubleToGdd(void* v,aitIndex count)
 {
 	dbr_time_double* dbv = (dbr_time_double*)v;
@@ -735,15 +865,6 @@ static smartGDDPointer mapTimeDoubleToGdd(void* v,aitIndex count)
 	return dd;
 }
 
-static int mapTimeGddToDouble(void* v, aitIndex count, const gdd & dd, const gddEnumStringTable &enumStringTable)
-{
-	dbr_time_double* dbv = (dbr_time_double*)v;
-	dd.getStatSevr(dbv->status,dbv->severity);
-	dd.getTimeStamp(&dbv->stamp);
-	dbv->RISC_pad = 0; // shut up purify
-	return mapGddToDouble(&dbv->value,count,dd, enumStringTable);
-}
-
 // ********************************************************************
 //                      graphic structure mappings
 // ********************************************************************
@@ -821,54 +942,6 @@ static smartGDDPointer mapControlShortToGdd(void* v, aitIndex count)
 	return dd;
 }
 
-static int mapGraphicGddToShort(void* v, aitIndex count, const gdd & dd, const gddEnumStringTable &enumStringTable)
-{
-	const aitString* str;
-	dbr_gr_short* db = (dbr_gr_short*)v;
-	const gdd& vdd = dd[gddAppTypeIndex_dbr_gr_short_value];
-
-	dd[gddAppTypeIndex_dbr_gr_short_units].getRef(str);
-	if(str->string()) {
-		strncpy(db->units,str->string(), sizeof(db->units));
-		db->units[sizeof(db->units)-1u] = '\0';	
-	}
-
-	db->lower_disp_limit=dd[gddAppTypeIndex_dbr_gr_short_graphicLow];
-	db->upper_disp_limit=dd[gddAppTypeIndex_dbr_gr_short_graphicHigh];
-	db->lower_alarm_limit=dd[gddAppTypeIndex_dbr_gr_short_alarmLow];
-	db->upper_alarm_limit=dd[gddAppTypeIndex_dbr_gr_short_alarmHigh];
-	db->lower_warning_limit=dd[gddAppTypeIndex_dbr_gr_short_alarmLowWarning];
-	db->upper_warning_limit=dd[gddAppTypeIndex_dbr_gr_short_alarmHighWarning];
-
-	vdd.getStatSevr(db->status,db->severity);
-	return mapGddToShort(&db->value,count,vdd, enumStringTable);
-}
-
-static int mapControlGddToShort(void* v, aitIndex count, const gdd & dd, const gddEnumStringTable &enumStringTable)
-{
-	const aitString* str;
-	dbr_ctrl_short* db = (dbr_ctrl_short*)v;
-	const gdd& vdd = dd[gddAppTypeIndex_dbr_ctrl_short_value];
-
-	dd[gddAppTypeIndex_dbr_ctrl_short_units].getRef(str);
-	if(str->string()) {
-		strncpy(db->units,str->string(), sizeof(db->units));
-		db->units[sizeof(db->units)-1u] = '\0';	
-	}
-
-	db->lower_disp_limit=dd[gddAppTypeIndex_dbr_ctrl_short_graphicLow];
-	db->upper_disp_limit=dd[gddAppTypeIndex_dbr_ctrl_short_graphicHigh];
-	db->lower_ctrl_limit=dd[gddAppTypeIndex_dbr_ctrl_short_controlLow];
-	db->upper_ctrl_limit=dd[gddAppTypeIndex_dbr_ctrl_short_controlHigh];
-	db->lower_alarm_limit=dd[gddAppTypeIndex_dbr_ctrl_short_alarmLow];
-	db->upper_alarm_limit=dd[gddAppTypeIndex_dbr_ctrl_short_alarmHigh];
-	db->lower_warning_limit=dd[gddAppTypeIndex_dbr_ctrl_short_alarmLowWarning];
-	db->upper_warning_limit=dd[gddAppTypeIndex_dbr_ctrl_short_alarmHighWarning];
-
-	vdd.getStatSevr(db->status,db->severity);
-	return mapGddToShort(&db->value,count,vdd, enumStringTable);
-}
-
 // -------------map the float structures----------------
 static smartGDDPointer mapGraphicFloatToGdd(void* v, aitIndex count)
 {
@@ -944,58 +1017,6 @@ static smartGDDPointer mapControlFloatToGdd(void* v, aitIndex count)
 	return dd;
 }
 
-static int mapGraphicGddToFloat(void* v, aitIndex count, const gdd & dd, const gddEnumStringTable &enumStringTable)
-{
-	const aitString* str;
-	dbr_gr_float* db = (dbr_gr_float*)v;
-	const gdd& vdd = dd[gddAppTypeIndex_dbr_gr_float_value];
-
-	dd[gddAppTypeIndex_dbr_gr_float_units].getRef(str);
-	if(str->string()) {
-		strncpy(db->units,str->string(), sizeof(db->units));
-		db->units[sizeof(db->units)-1u] = '\0';	
-	}
-
-	db->precision=dd[gddAppTypeIndex_dbr_gr_float_precision];
-	db->lower_disp_limit=dd[gddAppTypeIndex_dbr_gr_float_graphicLow];
-	db->upper_disp_limit=dd[gddAppTypeIndex_dbr_gr_float_graphicHigh];
-	db->lower_alarm_limit=dd[gddAppTypeIndex_dbr_gr_float_alarmLow];
-	db->upper_alarm_limit=dd[gddAppTypeIndex_dbr_gr_float_alarmHigh];
-	db->lower_warning_limit=dd[gddAppTypeIndex_dbr_gr_float_alarmLowWarning];
-	db->upper_warning_limit=dd[gddAppTypeIndex_dbr_gr_float_alarmHighWarning];
-	db->RISC_pad0 = 0; // shut up purify
-
-	vdd.getStatSevr(db->status,db->severity);
-	return mapGddToFloat(&db->value,count,vdd, enumStringTable);
-}
-
-static int mapControlGddToFloat(void* v, aitIndex count, const gdd & dd, const gddEnumStringTable &enumStringTable)
-{
-	const aitString* str;
-	dbr_ctrl_float* db = (dbr_ctrl_float*)v;
-	const gdd& vdd = dd[gddAppTypeIndex_dbr_ctrl_float_value];
-
-	dd[gddAppTypeIndex_dbr_ctrl_float_units].getRef(str);
-	if(str->string()) {
-		strncpy(db->units,str->string(), sizeof(db->units));
-		db->units[sizeof(db->units)-1u] = '\0';	
-	}
-
-	db->precision=dd[gddAppTypeIndex_dbr_ctrl_float_precision];
-	db->lower_disp_limit=dd[gddAppTypeIndex_dbr_ctrl_float_graphicLow];
-	db->upper_disp_limit=dd[gddAppTypeIndex_dbr_ctrl_float_graphicHigh];
-	db->lower_ctrl_limit=dd[gddAppTypeIndex_dbr_ctrl_float_controlLow];
-	db->upper_ctrl_limit=dd[gddAppTypeIndex_dbr_ctrl_float_controlHigh];
-	db->lower_alarm_limit=dd[gddAppTypeIndex_dbr_ctrl_float_alarmLow];
-	db->upper_alarm_limit=dd[gddAppTypeIndex_dbr_ctrl_float_alarmHigh];
-	db->lower_warning_limit=dd[gddAppTypeIndex_dbr_ctrl_float_alarmLowWarning];
-	db->upper_warning_limit=dd[gddAppTypeIndex_dbr_ctrl_float_alarmHighWarning];
-	db->RISC_pad = 0; // shut up purify
-
-	vdd.getStatSevr(db->status,db->severity);
-	return mapGddToFloat(&db->value,count,vdd, enumStringTable);
-}
-
 // -------------map the enum structures----------------
 static smartGDDPointer mapGraphicEnumToGdd(void* v, aitIndex /*count*/)
 {
@@ -1206,56 +1227,6 @@ static smartGDDPointer mapControlCharToGdd(void* v, aitIndex count)
 	return dd;
 }
 
-static int mapGraphicGddToChar(void* v, aitIndex count, const gdd & dd, const gddEnumStringTable &enumStringTable)
-{
-	const aitString* str;
-	dbr_gr_char* db = (dbr_gr_char*)v;
-	const gdd& vdd = dd[gddAppTypeIndex_dbr_gr_char_value];
-
-	dd[gddAppTypeIndex_dbr_gr_char_units].getRef(str);
-	if(str->string()) {
-		strncpy(db->units,str->string(), sizeof(db->units));
-		db->units[sizeof(db->units)-1u] = '\0';	
-	}
-
-	db->lower_disp_limit=dd[gddAppTypeIndex_dbr_gr_char_graphicLow];
-	db->upper_disp_limit=dd[gddAppTypeIndex_dbr_gr_char_graphicHigh];
-	db->lower_alarm_limit=dd[gddAppTypeIndex_dbr_gr_char_alarmLow];
-	db->upper_alarm_limit=dd[gddAppTypeIndex_dbr_gr_char_alarmHigh];
-	db->lower_warning_limit=dd[gddAppTypeIndex_dbr_gr_char_alarmLowWarning];
-	db->upper_warning_limit=dd[gddAppTypeIndex_dbr_gr_char_alarmHighWarning];
-	db->RISC_pad = 0;
-
-	vdd.getStatSevr(db->status,db->severity);
-	return mapGddToChar(&db->value,count,vdd, enumStringTable);
-}
-
-static int mapControlGddToChar(void* v, aitIndex count, const gdd & dd, const gddEnumStringTable &enumStringTable)
-{
-	const aitString* str;
-	dbr_ctrl_char* db = (dbr_ctrl_char*)v;
-	const gdd& vdd = dd[gddAppTypeIndex_dbr_ctrl_char_value];
-
-	dd[gddAppTypeIndex_dbr_ctrl_char_units].getRef(str);
-	if(str->string()) {
-		strncpy(db->units,str->string(), sizeof(db->units));
-		db->units[sizeof(db->units)-1u] = '\0';	
-	}
-
-	db->lower_disp_limit=dd[gddAppTypeIndex_dbr_ctrl_char_graphicLow];
-	db->upper_disp_limit=dd[gddAppTypeIndex_dbr_ctrl_char_graphicHigh];
-	db->lower_ctrl_limit=dd[gddAppTypeIndex_dbr_ctrl_char_controlLow];
-	db->upper_ctrl_limit=dd[gddAppTypeIndex_dbr_ctrl_char_controlHigh];
-	db->lower_alarm_limit=dd[gddAppTypeIndex_dbr_ctrl_char_alarmLow];
-	db->upper_alarm_limit=dd[gddAppTypeIndex_dbr_ctrl_char_alarmHigh];
-	db->lower_warning_limit=dd[gddAppTypeIndex_dbr_ctrl_char_alarmLowWarning];
-	db->upper_warning_limit=dd[gddAppTypeIndex_dbr_ctrl_char_alarmHighWarning];
-	db->RISC_pad = '\0'; // shut up purify
-
-	vdd.getStatSevr(db->status,db->severity);
-	return mapGddToChar(&db->value,count,vdd, enumStringTable);
-}
-
 // -------------map the long structures----------------
 static smartGDDPointer mapGraphicLongToGdd(void* v, aitIndex count)
 {
@@ -1329,54 +1300,6 @@ static smartGDDPointer mapControlLongToGdd(void* v, aitIndex count)
 	return dd;
 }
 
-static int mapGraphicGddToLong(void* v, aitIndex count, const gdd & dd, const gddEnumStringTable &enumStringTable)
-{
-	const aitString* str;
-	dbr_gr_long* db = (dbr_gr_long*)v;
-	const gdd& vdd = dd[gddAppTypeIndex_dbr_gr_long_value];
-
-	dd[gddAppTypeIndex_dbr_gr_long_units].getRef(str);
-	if(str->string()) {
-		strncpy(db->units,str->string(), sizeof(db->units));
-		db->units[sizeof(db->units)-1u] = '\0';	
-	}
-
-	db->lower_disp_limit=dd[gddAppTypeIndex_dbr_gr_long_graphicLow];
-	db->upper_disp_limit=dd[gddAppTypeIndex_dbr_gr_long_graphicHigh];
-	db->lower_alarm_limit=dd[gddAppTypeIndex_dbr_gr_long_alarmLow];
-	db->upper_alarm_limit=dd[gddAppTypeIndex_dbr_gr_long_alarmHigh];
-	db->lower_warning_limit=dd[gddAppTypeIndex_dbr_gr_long_alarmLowWarning];
-	db->upper_warning_limit=dd[gddAppTypeIndex_dbr_gr_long_alarmHighWarning];
-
-	vdd.getStatSevr(db->status,db->severity);
-	return mapGddToLong(&db->value,count,vdd, enumStringTable);
-}
-
-static int mapControlGddToLong(void* v, aitIndex count, const gdd & dd, const gddEnumStringTable &enumStringTable)
-{
-	const aitString* str;
-	dbr_ctrl_long* db = (dbr_ctrl_long*)v;
-	const gdd& vdd = dd[gddAppTypeIndex_dbr_ctrl_long_value];
-
-	dd[gddAppTypeIndex_dbr_ctrl_long_units].getRef(str);
-	if(str->string()) {
-		strncpy(db->units,str->string(), sizeof(db->units));
-		db->units[sizeof(db->units)-1u] = '\0';	
-	}
-
-	db->lower_disp_limit=dd[gddAppTypeIndex_dbr_ctrl_long_graphicLow];
-	db->upper_disp_limit=dd[gddAppTypeIndex_dbr_ctrl_long_graphicHigh];
-	db->lower_ctrl_limit=dd[gddAppTypeIndex_dbr_ctrl_long_controlLow];
-	db->upper_ctrl_limit=dd[gddAppTypeIndex_dbr_ctrl_long_controlHigh];
-	db->lower_alarm_limit=dd[gddAppTypeIndex_dbr_ctrl_long_alarmLow];
-	db->upper_alarm_limit=dd[gddAppTypeIndex_dbr_ctrl_long_alarmHigh];
-	db->lower_warning_limit=dd[gddAppTypeIndex_dbr_ctrl_long_alarmLowWarning];
-	db->upper_warning_limit=dd[gddAppTypeIndex_dbr_ctrl_long_alarmHighWarning];
-
-	vdd.getStatSevr(db->status,db->severity);
-	return mapGddToLong(&db->value,count,vdd, enumStringTable);
-}
-
 // -------------map the double structures----------------
 static smartGDDPointer mapGraphicDoubleToGdd(void* v, aitIndex count)
 {
@@ -1452,58 +1375,6 @@ static smartGDDPointer mapControlDoubleToGdd(void* v, aitIndex count)
 	return dd;
 }
 
-static int mapGraphicGddToDouble(void* v, aitIndex count, const gdd & dd, const gddEnumStringTable &enumStringTable)
-{
-	const aitString* str;
-	dbr_gr_double* db = (dbr_gr_double*)v;
-	const gdd& vdd = dd[gddAppTypeIndex_dbr_gr_double_value];
-
-	dd[gddAppTypeIndex_dbr_gr_double_units].getRef(str);
-	if(str->string()) {
-		strncpy(db->units,str->string(), sizeof(db->units));
-		db->units[sizeof(db->units)-1u] = '\0';	
-	}
-
-	db->precision=dd[gddAppTypeIndex_dbr_gr_double_precision];
-	db->lower_disp_limit=dd[gddAppTypeIndex_dbr_gr_double_graphicLow];
-	db->upper_disp_limit=dd[gddAppTypeIndex_dbr_gr_double_graphicHigh];
-	db->lower_alarm_limit=dd[gddAppTypeIndex_dbr_gr_double_alarmLow];
-	db->upper_alarm_limit=dd[gddAppTypeIndex_dbr_gr_double_alarmHigh];
-	db->lower_warning_limit=dd[gddAppTypeIndex_dbr_gr_double_alarmLowWarning];
-	db->upper_warning_limit=dd[gddAppTypeIndex_dbr_gr_double_alarmHighWarning];
-	db->RISC_pad0 = 0; // shut up purify
-
-	vdd.getStatSevr(db->status,db->severity);
-	return mapGddToDouble(&db->value,count,vdd, enumStringTable);
-}
-
-static int mapControlGddToDouble(void* v, aitIndex count, const gdd & dd, const gddEnumStringTable &enumStringTable)
-{
-	const aitString* str;
-	dbr_ctrl_double* db = (dbr_ctrl_double*)v;
-	const gdd& vdd = dd[gddAppTypeIndex_dbr_ctrl_double_value];
-
-	dd[gddAppTypeIndex_dbr_ctrl_double_units].getRef(str);
-	if(str->string()) {
-		strncpy(db->units,str->string(), sizeof(db->units));
-		db->units[sizeof(db->units)-1u] = '\0';	
-	}
-
-	db->precision=dd[gddAppTypeIndex_dbr_ctrl_double_precision];
-	db->lower_disp_limit=dd[gddAppTypeIndex_dbr_ctrl_double_graphicLow];
-	db->upper_disp_limit=dd[gddAppTypeIndex_dbr_ctrl_double_graphicHigh];
-	db->lower_ctrl_limit=dd[gddAppTypeIndex_dbr_ctrl_double_controlLow];
-	db->upper_ctrl_limit=dd[gddAppTypeIndex_dbr_ctrl_double_controlHigh];
-	db->lower_alarm_limit=dd[gddAppTypeIndex_dbr_ctrl_double_alarmLow];
-	db->upper_alarm_limit=dd[gddAppTypeIndex_dbr_ctrl_double_alarmHigh];
-	db->lower_warning_limit=dd[gddAppTypeIndex_dbr_ctrl_double_alarmLowWarning];
-	db->upper_warning_limit=dd[gddAppTypeIndex_dbr_ctrl_double_alarmHighWarning];
-	db->RISC_pad0 = '\0'; // shut up purify
-
-	vdd.getStatSevr(db->status,db->severity);
-	return mapGddToDouble(&db->value,count,vdd, enumStringTable);
-}
-
 static smartGDDPointer mapStsAckStringToGdd(void* v, aitIndex count)
 {
     // must be a container
@@ -1759,34 +1630,34 @@ extern epicsShareDef const gddDbrMapFuncTable gddMapDbr[DBM_N_DBR_TYPES] = {
     { mapCharToGdd,         mapGddToChar },             // DBR_CHAR
     { mapLongToGdd,         mapGddToLong },             // DBR_LONG
     { mapDoubleToGdd,       mapGddToDouble },           // DBR_DOUBLE
-    { mapStsStringToGdd,    mapStsGddToString },        // DBR_STS_STRING
-    { mapStsShortToGdd,     mapStsGddToShort },         // DBR_STS_SHORT
-    { mapStsFloatToGdd,     mapStsGddToFloat },         // DBR_STS_FLOAT
-    { mapStsEnumToGdd,      mapStsGddToEnum },          // DBR_STS_ENUM
-    { mapStsCharToGdd,      mapStsGddToChar },          // DBR_STS_CHAR
-    { mapStsLongToGdd,      mapStsGddToLong },          // DBR_STS_LONG
-    { mapStsDoubleToGdd,    mapStsGddToDouble },        // DBR_STS_DOUBLE
-    { mapTimeStringToGdd,   mapTimeGddToString },       // DBR_TIME_STRING
-    { mapTimeShortToGdd,    mapTimeGddToShort },        // DBR_TIME_SHORT
-    { mapTimeFloatToGdd,    mapTimeGddToFloat },        // DBR_TIME_FLOAT
-    { mapTimeEnumToGdd,     mapTimeGddToEnum },         // DBR_TIME_ENUM
-    { mapTimeCharToGdd,     mapTimeGddToChar },         // DBR_TIME_CHAR
-    { mapTimeLongToGdd,     mapTimeGddToLong },         // DBR_TIME_LONG
-    { mapTimeDoubleToGdd,   mapTimeGddToDouble },       // DBR_TIME_DOUBLE
-    { mapStsStringToGdd,    mapStsGddToString },        // DBR_GR_STRING
-    { mapGraphicShortToGdd, mapGraphicGddToShort },     // DBR_GR_SHORT
-    { mapGraphicFloatToGdd, mapGraphicGddToFloat },     // DBR_GR_FLOAT
+    { mapStsStringToGdd,    mapStsGddToDbr<dbr_sts_string> }, // DBR_STS_STRING
+    { mapStsShortToGdd,     mapStsGddToDbr<dbr_sts_short> }, // DBR_STS_SHORT
+    { mapStsFloatToGdd,     mapStsGddToDbr<dbr_sts_float> }, // DBR_STS_FLOAT
+    { mapStsEnumToGdd,      mapStsGddToDbr<dbr_sts_enum> }, // DBR_STS_ENUM
+    { mapStsCharToGdd,      mapStsGddToDbr<dbr_sts_char> }, // DBR_STS_CHAR
+    { mapStsLongToGdd,      mapStsGddToDbr<dbr_sts_long> }, // DBR_STS_LONG
+    { mapStsDoubleToGdd,    mapStsGddToDbr<dbr_sts_double> }, // DBR_STS_DOUBLE
+    { mapTimeStringToGdd,   mapTimeGddToDbr<dbr_time_string> }, // DBR_TIME_STRING
+    { mapTimeShortToGdd,    mapTimeGddToDbr<dbr_time_short> }, // DBR_TIME_SHORT
+    { mapTimeFloatToGdd,    mapTimeGddToDbr<dbr_time_float> }, // DBR_TIME_FLOAT
+    { mapTimeEnumToGdd,     mapTimeGddToDbr<dbr_time_enum> }, // DBR_TIME_ENUM
+    { mapTimeCharToGdd,     mapTimeGddToDbr<dbr_time_char> }, // DBR_TIME_CHAR
+    { mapTimeLongToGdd,     mapTimeGddToDbr<dbr_time_long> }, // DBR_TIME_LONG
+    { mapTimeDoubleToGdd,   mapTimeGddToDbr<dbr_time_double> }, // DBR_TIME_DOUBLE
+    { mapStsStringToGdd,    mapStsGddToDbr<dbr_sts_string> }, // DBR_GR_STRING
+    { mapGraphicShortToGdd, mapGraphicGddToDbr<dbr_gr_short> }, // DBR_GR_SHORT
+    { mapGraphicFloatToGdd, mapGraphicGddToDbr<dbr_gr_float> }, // DBR_GR_FLOAT
     { mapGraphicEnumToGdd,  mapGraphicGddToEnum },      // DBR_GR_ENUM
-    { mapGraphicCharToGdd,  mapGraphicGddToChar },      // DBR_GR_CHAR
-    { mapGraphicLongToGdd,  mapGraphicGddToLong },      // DBR_GR_LONG
-    { mapGraphicDoubleToGdd,mapGraphicGddToDouble },    // DBR_GR_DOUBLE
-    { mapStsStringToGdd,    mapStsGddToString },        // DBR_CTRL_STRING
-    { mapControlShortToGdd, mapControlGddToShort },     // DBR_CTRL_SHORT
-    { mapControlFloatToGdd, mapControlGddToFloat },     // DBR_CTRL_FLOAT
+    { mapGraphicCharToGdd,  mapGraphicGddToDbr<dbr_gr_char> }, // DBR_GR_CHAR
+    { mapGraphicLongToGdd,  mapGraphicGddToDbr<dbr_gr_long> }, // DBR_GR_LONG
+    { mapGraphicDoubleToGdd,mapGraphicGddToDbr<dbr_gr_double> }, // DBR_GR_DOUBLE
+    { mapStsStringToGdd,    mapStsGddToDbr<dbr_sts_string> }, // DBR_CTRL_STRING
+    { mapControlShortToGdd, mapControlGddToDbr<dbr_ctrl_short> }, // DBR_CTRL_SHORT
+    { mapControlFloatToGdd, mapControlGddToDbr<dbr_ctrl_float> }, // DBR_CTRL_FLOAT
     { mapControlEnumToGdd,  mapControlGddToEnum },      // DBR_CTRL_ENUM
-    { mapControlCharToGdd,  mapControlGddToChar },      // DBR_CTRL_CHAR
-    { mapControlLongToGdd,  mapControlGddToLong },      // DBR_CTRL_LONG
-    { mapControlDoubleToGdd,mapControlGddToDouble },     // DBR_CTRL_DOUBLE
+    { mapControlCharToGdd,  mapControlGddToDbr<dbr_ctrl_char> }, // DBR_CTRL_CHAR
+    { mapControlLongToGdd,  mapControlGddToDbr<dbr_ctrl_long> }, // DBR_CTRL_LONG
+    { mapControlDoubleToGdd,mapControlGddToDbr<dbr_ctrl_double> }, // DBR_CTRL_DOUBLE
     { mapAcktToGdd,         mapGddToAckt },             // DBR_PUT_ACKT
     { mapAcksToGdd,         mapGddToAcks },             // DBR_PUT_ACKS
     { mapStsAckStringToGdd, mapStsAckGddToString },     // DBR_STSACK_STRING
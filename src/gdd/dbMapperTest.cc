@@ -0,0 +1,90 @@
+/*************************************************************************\
+* Copyright (c) 2002 The University of Chicago, as Operator of Argonne
+*     National Laboratory.
+* Copyright (c) 2002 The Regents of the University of California, as
+*     Operator of Los Alamos National Laboratory.
+* EPICS BASE is distributed subject to a Software License Agreement found
+* in file LICENSE that is included with this distribution.
+\*************************************************************************/
+//
+// dbMapperTest.cc
+//
+// regression tests of the DBR structure mappers
+//
+
+#include <string.h>
+
+#include "epicsUnitTest.h"
+#include "gddAppTable.h"
+#include "dbMapper.h"
+
+//
+// a gdd made from a DBR_STRING array must own a copy of the
+// strings, and must not free the caller's buffer
+//
+static void testStringArrayToGdd ()
+{
+    static const unsigned count = 3u;
+    aitFixedString * pStrings = new aitFixedString [ count ];
+    memset ( pStrings, '\0', count * sizeof ( aitFixedString ) );
+    strcpy ( pStrings[0].fixed_string, "zero" );
+    strcpy ( pStrings[1].fixed_string, "one" );
+    strcpy ( pStrings[2].fixed_string, "two" );
+
+    smartGDDPointer pDD = gddMapDbr[DBR_STRING].conv_gdd ( pStrings, count );
+    testOk ( pDD.valid (), "DBR_STRING array converted to a gdd" );
+    if ( ! pDD.valid () ) {
+        delete [] pStrings;
+        return;
+    }
+    testOk ( pDD->getDataSizeElements () == count,
+        "the gdd has %u elements", count );
+
+    const aitFixedString * pData =
+        static_cast < const aitFixedString * > ( pDD->dataPointer () );
+    bool copied = pData != pStrings;
+    testOk ( copied, "the gdd refers to a copy of the strings" );
+    testOk ( strcmp ( pData[1].fixed_string, "one" ) == 0,
+        "the copy holds the strings" );
+
+    // the gdd frees its copy, and the caller still owns its buffer
+    pDD = 0;
+    if ( copied ) {
+        strcpy ( pStrings[1].fixed_string, "still mine" );
+        delete [] pStrings;
+    }
+}
+
+//
+// an 8 bit value of either sign is copied bit for bit to DBR_CHAR
+//
+static void testCharFromGdd ( aitEnum primType, const char * pName )
+{
+    static const unsigned count = 4u;
+    static const aitUint8 bytes[count] = { 0u, 1u, 127u, 200u };
+    aitUint8 value[count];
+    memcpy ( value, bytes, count );
+    aitUint16 app = gddApplicationTypeTable::AppTable ().
+        getApplicationType ( "value" );
+    smartGDDPointer pDD = new gddAtomic ( app, primType, 1, count );
+    pDD->unreference ();
+    pDD->putRef ( value, primType );
+
+    dbr_char_t dbr[count];
+    memset ( dbr, '\0', sizeof ( dbr ) );
+    gddEnumStringTable enumTable;
+    int status = gddMapDbr[DBR_CHAR].conv_dbr ( dbr, count, *pDD, enumTable );
+    testOk ( status == static_cast < int > ( count ) &&
+        memcmp ( dbr, bytes, count ) == 0,
+        "%s array copied to DBR_CHAR", pName );
+}
+
+MAIN ( dbMapperTest )
+{
+    testPlan ( 6 );
+    gddMakeMapDBR ( gddApplicationTypeTable::AppTable () );
+    testStringArrayToGdd ();
+    testCharFromGdd ( aitEnumInt8, "aitInt8" );
+    testCharFromGdd ( aitEnumUint8, "aitUint8" );
+    return testDone ();
+}
@@ -339,23 +339,9 @@ gddStatus gdd::genCopy(aitEnum t, const void* d, aitDataFormat f)
             }
             else {
 			    size_t sz=describedDataSizeBytes();
-	            aitUint8 * buf = new aitUint8[sz];
-			    if ( buf == NULL ) {
-				    gddAutoPrint("gdd::genCopy()",gddErrorNewFailed);
-				    rc=gddErrorNewFailed;
-			    }
-			    else
-			    {
-				    destruct=new gddAitUint8Destructor;
-				    if (destruct==NULL) {
-					    gddAutoPrint("gdd::genCopy()",gddErrorNewFailed);
-					    rc=gddErrorNewFailed;
-					    delete [] buf;
-				    }
-				    else {
-					    setData(buf);
-					    destruct->reference();
-				    }
+			    rc=newArrayData(sz);
+			    if(rc) {
+				    gddAutoPrint("gdd::genCopy()",rc);
 			    }
             }
 		}
@@ -381,6 +367,36 @@ gddStatus gdd::genCopy(aitEnum t, const void* d, aitDataFormat f)
 }
 
 
+// Allocate the data of an atomic DD along with a destructor for
+// them.  Short arrays get a gddSmallArray, which holds both.
+gddStatus gdd::newArrayData(size_t sz)
+{
+	void* buf;
+
+	if(sz<=GDD_SMALL_ARRAY_SIZE)
+	{
+		gddSmallArray* sa=new gddSmallArray;
+		if(sa==NULL) return gddErrorNewFailed;
+		destruct=sa;
+		buf=sa->buffer();
+	}
+	else
+	{
+		aitUint8* arr=new aitUint8[sz];
+		if(arr==NULL) return gddErrorNewFailed;
+		destruct=new gddAitUint8Destructor;
+		if(destruct==NULL)
+		{
+			delete [] arr;
+			return gddErrorNewFailed;
+		}
+		buf=arr;
+	}
+	destruct->reference();
+	setData(buf);
+	return 0;
+}
+
 gddStatus gdd::changeType(int app,aitEnum prim)
 {
 	gddStatus rc=0;
@@ -512,24 +528,12 @@ gddStatus gdd::copyStuff(const gdd* dd,int ctype)
             }
             else {
 			    size_t a_size = dd->getDataSizeBytes();
-			    aitUint8* array = new aitUint8[a_size];
-			    if ( array ) {
-				    destruct=new gddAitUint8Destructor;
-				    if (destruct!=NULL) {
-					    destruct->reference();
-					    memcpy(array,dd->dataPointer(),a_size);
-					    setData(array);
-				    }
-				    else {
-					    delete [] array;
-					    gddAutoPrint("gdd::copyStuff()",gddErrorNewFailed);
-					    rc=gddErrorNewFailed;
-				    }
+			    rc=newArrayData(a_size);
+			    if(rc==0) {
+				    memcpy(dataPointer(),dd->dataPointer(),a_size);
 			    }
-			    else
-			    {
-				    gddAutoPrint("gdd::copyStuff()",gddErrorNewFailed);
-				    rc=gddErrorNewFailed;
+			    else {
+				    gddAutoPrint("gdd::copyStuff()",rc);
 			    }
             }
 			break;
@@ -1388,19 +1392,10 @@ gddStatus gdd::put ( const gdd * dd )
                 size_t sz = srcCopySize * aitSize[primitiveType()];
                 
                 // allocate a data buffer for the user
-                aitUint8 * arr = new aitUint8[sz];
-                if( ! arr ) {
-                    return gddErrorNewFailed;
-                }
-                destruct=new gddAitUint8Destructor;
-                if (destruct!=NULL) {
-                    destruct->reference();
-                    setData(arr);
-                }
-                else {
-                    delete [] arr;
-                    gddAutoPrint("gdd::copyData(const gdd*)",gddErrorNewFailed);
-                    return gddErrorNewFailed;
+                gddStatus rc = newArrayData ( sz );
+                if ( rc ) {
+                    gddAutoPrint("gdd::copyData(const gdd*)",rc);
+                    return rc;
                 }
             }
 
@@ -482,6 +482,7 @@ protected:
 	aitUint32 align8(unsigned long count) const;
 
 	void setData(void* d);
+	gddStatus newArrayData(size_t sz);
 
 	aitType data;				// array pointer or scaler data
 	gddBounds* bounds;			// array of bounds information length dim
@@ -10,6 +10,8 @@
 // Author: Jim Kowalkowski
 // Date: 2/96
 
+#include "epicsAtomic.h"
+
 #define epicsExportSharedSymbols
 #include "gddAppTable.h"
 
@@ -26,6 +28,50 @@ void gddApplicationTypeDestructor::run(void* v)
 gddApplicationTypeElement::gddApplicationTypeElement(void) { }
 gddApplicationTypeElement::~gddApplicationTypeElement(void) { }
 
+// --------------------------copy plan stuff-----------------------------
+
+// A copy plan is the flattened result of walking a prototype src container
+// with copyDD_src() - the index of each atomic member of src paired with
+// the index it maps to in dest.  The app type of each src member is kept
+// because a flat container with the same app type and the same number of
+// members may hold them in another order.  A src member which has no place
+// in dest gets a step which only checks its app type, as another container
+// may have a member there that dest does hold.
+//
+// Plans are never changed or removed once they are linked into a hash
+// chain, so they are found without taking the table's mutex.
+
+// dest_index of a step which copies nothing
+#define GDD_COPY_STEP_CHECK_ONLY ((aitIndex)~0u)
+
+struct gddCopyStep
+{
+	aitIndex src_index;
+	aitIndex dest_index;
+	aitUint32 src_app;
+};
+
+class gddCopyPlan
+{
+public:
+	gddCopyPlan(aitUint32 s_app, aitUint32 d_app, aitIndex max);
+	~gddCopyPlan(void);
+
+	gddCopyPlan* next;
+	aitUint32 src_app;
+	aitUint32 dest_app;
+	aitIndex src_elements; // checked before each use of the plan
+	aitIndex dest_elements;
+	aitIndex total_steps;
+	gddCopyStep* steps;
+};
+
+gddCopyPlan::gddCopyPlan(aitUint32 s_app, aitUint32 d_app, aitIndex max):
+	next(NULL),src_app(s_app),dest_app(d_app),src_elements(0),
+	dest_elements(0),total_steps(0),steps(new gddCopyStep[max]) { }
+
+gddCopyPlan::~gddCopyPlan(void) { delete [] steps; }
+
 // --------------------------app table stuff-----------------------------
 
 gddApplicationTypeTable gddApplicationTypeTable::app_table;
@@ -55,6 +101,14 @@ gddApplicationTypeTable::gddApplicationTypeTable(aitUint32 tot)
 	attr_table=new gddApplicationTypeElement*[max_groups];
 
 	for(i=0;i<max_groups;i++) attr_table[i]=NULL;
+
+	// one hash bucket per possible app type keeps the chains short
+	name_index=new aitUint32[total];
+	name_index_mask=total-1;
+	for(i=0;i<total;i++) name_index[i]=0;
+
+	for(i=0;i<APPLTABLE_PLAN_BUCKETS;i++) plan_index[i]=NULL;
+
 	GenerateTypes();
 }
 
@@ -116,6 +170,17 @@ gddApplicationTypeTable::~gddApplicationTypeTable(void)
 		}
 	}
 	delete [] attr_table;
+	delete [] name_index;
+
+	for(i=0u;i<APPLTABLE_PLAN_BUCKETS;i++)
+	{
+		gddCopyPlan* plan;
+		while( (plan=(gddCopyPlan*)plan_index[i]) )
+		{
+			plan_index[i]=plan->next;
+			delete plan;
+		}
+	}
 }
 
 int gddApplicationTypeTable::describeDD(gddContainer* dd, FILE* fd,
@@ -232,6 +297,7 @@ gddStatus gddApplicationTypeTable::registerApplicationType(
 		{
 			attr_table[group][i].type=gddApplicationTypeUndefined;
 			attr_table[group][i].map=NULL;
+			attr_table[group][i].next_name=0;
 		}
 	}
 
@@ -239,6 +305,7 @@ gddStatus gddApplicationTypeTable::registerApplicationType(
 	attr_table[group][app].type=gddApplicationTypeNormal;
 	attr_table[group][app].proto=NULL;
 	attr_table[group][app].free_list=NULL;
+	installName(rapp);
 
 	new_app=rapp;
 	// fprintf(stderr,"registered <%s> %d\n",name,(int)new_app);
@@ -307,19 +374,42 @@ gddStatus gddApplicationTypeTable::registerApplicationTypeWithProto(
 
 aitUint32 gddApplicationTypeTable::getApplicationType(const char* const name) const
 {
-	unsigned i,j,rc;
+	aitUint32 rapp;
+	gddApplicationTypeElement* el;
 
-	for(i=0,rc=0;i<max_groups && attr_table[i] && rc==0;i++)
+	// installName() links names into the index in other threads
+	epicsGuard < epicsMutex > guard ( sem );
+	for(rapp=name_index[hashName(name)&name_index_mask];rapp;rapp=el->next_name)
 	{
-		for(j=0; j<APPLTABLE_GROUP_SIZE && rc==0; j++)
-		{
-			if(attr_table[i][j].type!=gddApplicationTypeUndefined &&
-			   strcmp(name,attr_table[i][j].app_name)==0)
-				rc=APPLTABLE_GROUP_SIZE*i+j;
-		}
+		el=&attr_table[group(rapp)][index(rapp)];
+		if(strcmp(name,el->app_name)==0) return rapp;
 	}
+	return 0;
+}
 
-	return rc;
+// FNV-1a string hash
+aitUint32 gddApplicationTypeTable::hashName(const char* name)
+{
+	aitUint32 h=2166136261u;
+	const unsigned char* cp;
+
+	for(cp=(const unsigned char*)name;*cp;cp++)
+	{
+		h^=*cp;
+		h*=16777619u;
+	}
+	return h;
+}
+
+// link a newly registered app into the name hash index
+void gddApplicationTypeTable::installName(aitUint32 rapp)
+{
+	gddApplicationTypeElement* el=&attr_table[group(rapp)][index(rapp)];
+	aitUint32 b=hashName(el->app_name)&name_index_mask;
+
+	epicsGuard < epicsMutex > guard ( sem );
+	el->next_name=name_index[b];
+	name_index[b]=rapp;
 }
 
 char* gddApplicationTypeTable::getName(aitUint32 rapp) const
@@ -396,7 +486,7 @@ gdd* gddApplicationTypeTable::getDD(aitUint32 rapp)
 	return dd;
 }
 
-gddStatus gddApplicationTypeTable::freeDD(gdd* dd)
+gddStatus gddApplicationTypeTable::resetDD(gdd* dd)
 {
 	aitUint32 group,app,i;
 	gddStatus rc;
@@ -416,6 +506,28 @@ gddStatus gddApplicationTypeTable::freeDD(gdd* dd)
 			dd[i].setPrimType(attr_table[group][app].proto[i].primitiveType());
 			dd[i].setApplType(attr_table[group][app].proto[i].applicationType());
 		}
+	}
+	else if (attr_table[group][app].type==gddApplicationTypeNormal)
+	{
+		// getDD() returns a new gdd without data for a normal type
+		dd->destroyData();
+	}
+	else
+		rc=gddErrorNotDefined;
+
+	return rc;
+}
+
+gddStatus gddApplicationTypeTable::freeDD(gdd* dd)
+{
+	aitUint32 group,app;
+	gddStatus rc;
+
+	if((rc=splitApplicationType(dd->applicationType(),group,app))<0) return rc;
+
+	if(attr_table[group][app].type==gddApplicationTypeProto)
+	{
+		resetDD(dd);
 
 		// fprintf(stderr,"Adding DD to free_list %d\n",app);
 		attr_table[group][app].sem.lock ();
@@ -520,6 +632,141 @@ gddStatus gddApplicationTypeTable::copyDD_dest(gdd& dest, const gdd& src)
 	return rc;
 }
 
+// Copy one flat container into a managed container using the plan for
+// their app types, falls back to walking src if there is no plan.
+gddStatus gddApplicationTypeTable::copyDD_plan(gdd& dest, const gdd& src)
+{
+	const gddCopyPlan* plan;
+	const gddCopyStep* step;
+	aitIndex i;
+
+	if((plan=getCopyPlan(dest,src))==NULL)
+		return copyDD_src(dest,src);
+
+	// both containers are arrays of gdds in memory if flat, so the
+	// members are found without gdd::indexDD()
+	for(i=0,step=plan->steps;i<plan->total_steps;i++,step++)
+	{
+		const gdd* s=&src+step->src_index;
+
+		// src isnt laid out as the prototype was, the members already
+		// copied are copied again with the same values
+		if(s->applicationType()!=step->src_app)
+			return copyDD_src(dest,src);
+		if(step->dest_index==GDD_COPY_STEP_CHECK_ONLY)
+			continue;
+
+		gdd* d=dest.isFlat()?&dest+step->dest_index:&dest[step->dest_index];
+		d->put(s);
+	}
+
+	// same as copyDD_src(), which ignores member put() failures
+	return 0;
+}
+
+const gddCopyPlan* gddApplicationTypeTable::getCopyPlan(const gdd& dest,
+	const gdd& src)
+{
+	aitUint32 s_app=src.applicationType();
+	aitUint32 d_app=dest.applicationType();
+	aitUint32 b=(s_app*31u+d_app)&(APPLTABLE_PLAN_BUCKETS-1);
+	gddCopyPlan* plan;
+	gddCopyPlan* new_plan;
+
+	for(plan=(gddCopyPlan*)epicsAtomicGetPtrT(&plan_index[b]);plan;
+			plan=plan->next)
+		if(plan->src_app==s_app && plan->dest_app==d_app) break;
+
+	if(plan==NULL)
+	{
+		if((new_plan=buildCopyPlan(dest,src))==NULL) return NULL;
+
+		// another thread may have installed the same plan meanwhile,
+		// and the mutex keeps plans from being installed twice
+		epicsGuard < epicsMutex > guard ( sem );
+		for(plan=(gddCopyPlan*)plan_index[b];plan;plan=plan->next)
+			if(plan->src_app==s_app && plan->dest_app==d_app) break;
+		if(plan)
+			delete new_plan;
+		else
+		{
+			// the plan is complete before it can be seen by the
+			// unlocked search
+			plan=new_plan;
+			plan->next=(gddCopyPlan*)plan_index[b];
+			epicsAtomicCmpAndSwapPtrT(&plan_index[b],plan->next,plan);
+		}
+	}
+
+	// a container that was not created from its app type prototype
+	if(plan->src_elements!=src.getDataSizeElements() ||
+	   plan->dest_elements!=dest.getDataSizeElements())
+		return NULL;
+
+	return plan;
+}
+
+// only containers with a registered prototype have a known layout
+gddCopyPlan* gddApplicationTypeTable::buildCopyPlan(const gdd& dest,
+	const gdd& src)
+{
+	aitUint32 group,app;
+	aitIndex total_dds;
+	gddCopyPlan* plan;
+
+	if(splitApplicationType(src.applicationType(),group,app)<0) return NULL;
+	if(attr_table[group]==NULL ||
+	   attr_table[group][app].type!=gddApplicationTypeProto)
+		return NULL;
+
+	total_dds=attr_table[group][app].total_dds;
+	plan=new gddCopyPlan(src.applicationType(),dest.applicationType(),
+		total_dds);
+	plan->src_elements=src.getDataSizeElements();
+	plan->dest_elements=dest.getDataSizeElements();
+
+	if(addCopySteps(plan,dest,src,src,total_dds)<0)
+	{
+		delete plan;
+		return NULL;
+	}
+	return plan;
+}
+
+// walk src in the same order as copyDD_src()
+int gddApplicationTypeTable::addCopySteps(gddCopyPlan* plan,
+	const gdd& dest, const gdd& src, const gdd& member, aitIndex total_dds)
+{
+	gddCursor cur;
+	gdd* dd;
+	aitIndex index;
+	long pos;
+
+	if(member.isContainer())
+	{
+		gddContainer& cdd = (gddContainer&) member;
+		cur=cdd.getCursor();
+		for(dd=cur.first();dd;dd=dd->next())
+			if(addCopySteps(plan,dest,src,*dd,total_dds)<0) return -1;
+	}
+	else
+	{
+		// src is flat so src[pos] is this member
+		pos=&member-&src;
+		if(pos<=0 || pos>=(long)total_dds) return -1;
+
+		if(mapAppToIndex(dest.applicationType(),member.applicationType(),
+			index)!=0)
+			index=GDD_COPY_STEP_CHECK_ONLY;
+
+		plan->steps[plan->total_steps].src_index=(aitIndex)pos;
+		plan->steps[plan->total_steps].dest_index=index;
+		plan->steps[plan->total_steps].src_app=member.applicationType();
+		plan->total_steps++;
+	}
+	return 0;
+}
+
 gddStatus gddApplicationTypeTable::smartCopy(gdd* dest, const gdd* src)
 {
 	gddStatus rc = gddErrorNotAllowed;
@@ -528,7 +775,12 @@ gddStatus gddApplicationTypeTable::smartCopy(gdd* dest, const gdd* src)
 	// feature is used.
 
 	if(dest->isContainer() && dest->isManaged())
-		rc=copyDD_src(*dest,*src);
+	{
+		if(src->isContainer() && src->isFlat())
+			rc=copyDD_plan(*dest,*src);
+		else
+			rc=copyDD_src(*dest,*src);
+	}
 	else if(src->isContainer() && src->isManaged())
 		rc=copyDD_dest(*dest,*src);
     else if(!src->isContainer() && !dest->isContainer()) {
@@ -23,6 +23,9 @@
 #define APPLTABLE_GROUP_SIZE 64
 #define APPLTABLE_GROUP_SIZE_POW 6
 
+// must be power of 2 for copy plan hash buckets
+#define APPLTABLE_PLAN_BUCKETS 64
+
 // default set of application type names
 #define GDD_UNITS_SIZE 8
 #define GDD_NAME_UNITS              "units"
@@ -57,6 +60,7 @@ typedef enum
 } gddApplicationTypeType;
 
 class gddApplicationTypeTable;
+class gddCopyPlan;
 
 class gddApplicationTypeDestructor : public gddDestructor
 {
@@ -81,6 +85,7 @@ public:
 	aitUint32 user_value;
 	aitUint16* map;
 	aitUint16 map_size;
+	aitUint32 next_name; // next app in same name hash bucket, 0 ends chain
 };
 
 // The app table allows registering a prototype DD for app.  This class
@@ -105,14 +110,16 @@ public:
 	aitUint32 registerApplicationTypeWithProto(const char* const name,
 		gdd* protoDD);
 
-	// hashing still not used for string names to app types
+	// string names are found through a hash index on the name
 	aitUint32 getApplicationType(const char* const name) const;
 	char* getName(aitUint32 app) const;
 	gddStatus mapAppToIndex(aitUint32 container_app,
 		aitUint32 app_to_map, aitUint32& index);
 
 	// copy as best as possible from src to dest, one of the gdd must be
-	// managed for this to succeed
+	// managed for this to succeed.  When both are containers laid out
+	// by their prototypes the copy runs from a plan cached for the pair
+	// of app types.
 	gddStatus smartCopy(gdd* dest, const gdd* src);
 	gddStatus smartRef(gdd* dest, const gdd* src);
 
@@ -131,6 +138,11 @@ public:
 	// this function indirectly by unreferencing the DD.
 	gddStatus freeDD(gdd*);
 
+	// Restore a DD obtained from getDD() to the state that getDD()
+	// returns it in, but leave it with the caller so that it can be
+	// reused without returning it to the free list.
+	gddStatus resetDD(gdd*);
+
 	aitUint32 maxAttributes(void) const	  { return max_allowed; }
 	aitUint32 totalregistered(void) const { return total_registered; }
 	void describe(FILE*);
@@ -145,6 +157,7 @@ protected:
 
 	gddStatus copyDD_src(gdd& dest, const gdd& src);
 	gddStatus copyDD_dest(gdd& dest, const gdd& src);
+	gddStatus copyDD_plan(gdd& dest, const gdd& src);
 	gddStatus refDD_src(gdd& dest, const gdd& src);
 	gddStatus refDD_dest(gdd& dest, const gdd& src);
 
@@ -153,13 +166,23 @@ private:
 	aitUint32 group(aitUint32 rapp) const;
 	aitUint32 index(aitUint32 rapp) const;
 	int describeDD(gddContainer* dd, FILE* fd, int level, char* tn);
+	static aitUint32 hashName(const char* name);
+	void installName(aitUint32 rapp);
+	const gddCopyPlan* getCopyPlan(const gdd& dest, const gdd& src);
+	gddCopyPlan* buildCopyPlan(const gdd& dest, const gdd& src);
+	int addCopySteps(gddCopyPlan* plan, const gdd& dest, const gdd& src,
+		const gdd& member, aitIndex total_dds);
 
 	aitUint32 total_registered;
 	aitUint32 max_allowed;
 	aitUint32 max_groups;
 
 	gddApplicationTypeElement** attr_table;
-	epicsMutex sem;
+	aitUint32* name_index; // hash bucket heads, app 0 is never registered
+	aitUint32 name_index_mask;
+	// gddCopyPlan chains, published with epicsAtomicCmpAndSwapPtrT()
+	void* plan_index[APPLTABLE_PLAN_BUCKETS];
+	mutable epicsMutex sem;
 };
 
 inline aitUint32 gddApplicationTypeTable::group(aitUint32 rapp) const
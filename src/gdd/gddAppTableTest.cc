@@ -0,0 +1,118 @@
+/*************************************************************************\
+* Copyright (c) 2002 The University of Chicago, as Operator of Argonne
+*     National Laboratory.
+* Copyright (c) 2002 The Regents of the University of California, as
+*     Operator of Los Alamos National Laboratory.
+* EPICS BASE is distributed subject to a Software License Agreement found
+* in file LICENSE that is included with this distribution.
+\*************************************************************************/
+//
+// gddAppTableTest.cc
+//
+// regression tests of gddApplicationTypeTable::smartCopy()
+//
+
+#include "epicsUnitTest.h"
+#include "gddAppTable.h"
+#include "gddApps.h"
+
+static gdd * flatten ( gddContainer * pCont )
+{
+    size_t size = pCont->getTotalSizeBytes ();
+    char * pBuf = new char [ size ];
+    pCont->flattenWithAddress ( pBuf, size );
+    pCont->unreference ();
+    return reinterpret_cast < gdd * > ( pBuf );
+}
+
+//
+// a flat DBR_CTRL_DOUBLE container with only the value and the
+// precision, in the order given
+//
+static gdd * flatCtrlDouble ( bool valueFirst, aitFloat64 value,
+    aitInt16 precision )
+{
+    gddContainer * pCont = new gddContainer ( gddAppType_dbr_ctrl_double );
+    gdd * pValue = new gddScalar ( gddAppType_value, aitEnumFloat64 );
+    * pValue = value;
+    gdd * pPrecision = new gddScalar ( gddAppType_precision, aitEnumInt16 );
+    * pPrecision = precision;
+    if ( valueFirst ) {
+        pCont->insert ( pValue );
+        pCont->insert ( pPrecision );
+    }
+    else {
+        pCont->insert ( pPrecision );
+        pCont->insert ( pValue );
+    }
+    return flatten ( pCont );
+}
+
+static void testCopy ( bool valueFirst, aitFloat64 value,
+    aitInt16 precision )
+{
+    gddApplicationTypeTable & table =
+        gddApplicationTypeTable::AppTable ();
+    gdd * pSrc = flatCtrlDouble ( valueFirst, value, precision );
+    gdd * pDest = table.getDD ( gddAppType_dbr_ctrl_double );
+    gddStatus status = table.smartCopy ( pDest, pSrc );
+    testOk ( status == 0, "smartCopy with the value %s",
+        valueFirst ? "first" : "last" );
+
+    aitFloat64 destValue = 0.0;
+    aitInt16 destPrecision = 0;
+    ( *pDest ) [ gddAppTypeIndex_dbr_ctrl_double_value ].getConvert (
+        destValue );
+    ( *pDest ) [ gddAppTypeIndex_dbr_ctrl_double_precision ].getConvert (
+        destPrecision );
+    testOk ( destValue == value, "value %g copied as %g",
+        value, destValue );
+    testOk ( destPrecision == precision, "precision %d copied as %d",
+        precision, destPrecision );
+
+    pDest->unreference ();
+    delete [] reinterpret_cast < char * > ( pSrc );
+}
+
+//
+// The plan is built from a container holding a member which DBR_CTRL_DOUBLE
+// has no place for. A container of the same app type and size may hold a
+// member which it does have a place for in the same position, and that
+// member must be copied.
+//
+static void testUnmappedMember ()
+{
+    gddApplicationTypeTable & table =
+        gddApplicationTypeTable::AppTable ();
+
+    gddContainer * pCont = new gddContainer ( gddAppType_dbr_ctrl_double );
+    gdd * pValue = new gddScalar ( gddAppType_value, aitEnumFloat64 );
+    * pValue = 1.0;
+    pCont->insert ( pValue );
+    gdd * pAckt = new gddScalar ( gddAppType_ackt, aitEnumUint16 );
+    * pAckt = 1;
+    pCont->insert ( pAckt );
+    gdd * pSrc = flatten ( pCont );
+    gdd * pDest = table.getDD ( gddAppType_dbr_ctrl_double );
+    gddStatus status = table.smartCopy ( pDest, pSrc );
+    testOk ( status == 0, "smartCopy with a member that has no place in dest" );
+    pDest->unreference ();
+    delete [] reinterpret_cast < char * > ( pSrc );
+
+    testCopy ( true, 4.5, 5 );
+}
+
+MAIN ( gddAppTableTest )
+{
+    testPlan ( 13 );
+
+    // must build the plan for the pair of app types
+    testUnmappedMember ();
+
+    // the plan must not be trusted when the member order differs
+    testCopy ( true, 2.5, 7 );
+    testCopy ( false, 2.5, 7 );
+    testCopy ( true, -1.0, 3 );
+
+    return testDone ();
+}
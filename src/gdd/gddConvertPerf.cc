@@ -0,0 +1,620 @@
+/*************************************************************************\
+* Copyright (c) 2002 The University of Chicago, as Operator of Argonne
+*     National Laboratory.
+* Copyright (c) 2002 The Regents of the University of California, as
+*     Operator of Los Alamos National Laboratory.
+* EPICS BASE is distributed subject to a Software License Agreement found
+* in file LICENSE that is included with this distribution.
+\*************************************************************************/
+//
+// gddConvertPerf.cc
+//
+// timing of every populated cell of the aitConvert tables and of
+// every gddMapDbr conversion pair over a range of element counts
+//
+// One record is written for each conversion and element count, as
+// CSV by default or as JSON with -j. Numeric cells are compared with
+// an independent cast of the same input and the run fails if they
+// differ. The remaining conversions are given a digest of their
+// output, so that runs before and after a change may be diffed.
+//
+// usage: gddConvertPerf [-j] [-n <max elements>] [-t <min seconds>]
+//
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "epicsTime.h"
+#include "gddAppTable.h"
+#include "dbMapper.h"
+
+static const unsigned nTrials = 3u;
+static const unsigned nEnumStates = 16u;
+
+static double minTime = 0.01;
+static bool jsonOutput = false;
+static unsigned nRecords = 0u;
+static unsigned nMismatch = 0u;
+
+//
+// one conversion which is timed by convPerfTime()
+//
+class convPerfOp {
+public:
+    virtual int run () = 0;
+protected:
+    virtual ~convPerfOp () {}
+};
+
+//
+// Returns the best time of several trials for one run of the
+// conversion. The number of runs in a trial is doubled until
+// a trial takes at least minTime.
+//
+static double convPerfTime ( convPerfOp & op, bool & failed )
+{
+    unsigned nRuns = 1u;
+    while ( true ) {
+        int status = 0;
+        epicsTime begin = epicsTime::getCurrent ();
+        for ( unsigned j = 0u; j < nRuns; j++ ) {
+            status |= op.run ();
+        }
+        double delay = epicsTime::getCurrent () - begin;
+        failed = status < 0;
+        if ( delay >= minTime || nRuns >= 0x40000000u ) {
+            break;
+        }
+        nRuns *= 2u;
+    }
+
+    double best = 0.0;
+    for ( unsigned trial = 0u; trial < nTrials; trial++ ) {
+        int status = 0;
+        epicsTime begin = epicsTime::getCurrent ();
+        for ( unsigned j = 0u; j < nRuns; j++ ) {
+            status |= op.run ();
+        }
+        double delay = epicsTime::getCurrent () - begin;
+        if ( trial == 0u || delay < best ) {
+            best = delay;
+        }
+        failed = failed || status < 0;
+    }
+    return best / nRuns;
+}
+
+static aitUint32 convPerfDigest ( aitUint32 digest, const void * pData,
+    size_t size )
+{
+    const unsigned char * p = static_cast < const unsigned char * > ( pData );
+    for ( size_t i = 0u; i < size; i++ ) {
+        digest = ( digest ^ p[i] ) * 16777619u;
+    }
+    return digest;
+}
+
+static void convPerfReport ( const char * pTable, const char * pDest,
+    const char * pSrc, aitIndex nElem, double delay, size_t bytesPerRun,
+    const char * pCheck, aitUint32 digest )
+{
+    double nsPerElem = delay * 1e9 / ( nElem ? nElem : 1u );
+    double gbPerSec = delay > 0.0 ? bytesPerRun / delay / 1e9 : 0.0;
+    if ( jsonOutput ) {
+        printf ( "%s  { \"table\": \"%s\", \"dest\": \"%s\", \"source\": \"%s\", "
+            "\"elements\": %u, \"ns_per_element\": %.3f, \"gb_per_sec\": %.4f, "
+            "\"check\": \"%s\", \"digest\": \"%08x\" }",
+            nRecords ? ",\n" : "", pTable, pDest, pSrc,
+            static_cast < unsigned > ( nElem ), nsPerElem, gbPerSec,
+            pCheck, digest );
+    }
+    else {
+        if ( nRecords == 0u ) {
+            printf ( "table,dest,source,elements,ns_per_element,"
+                "gb_per_sec,check,digest\n" );
+        }
+        printf ( "%s,%s,%s,%u,%.3f,%.4f,%s,%08x\n", pTable, pDest, pSrc,
+            static_cast < unsigned > ( nElem ), nsPerElem, gbPerSec,
+            pCheck, digest );
+    }
+    nRecords++;
+}
+
+//
+// The reference conversion is the plain C++ cast which aitGen
+// writes into each numeric cell, instantiated here independently
+// of the tables.
+//
+template < class D, class S >
+static void convPerfCast ( void * pDest, const void * pSrc, aitIndex nElem )
+{
+    D * pD = static_cast < D * > ( pDest );
+    const S * pS = static_cast < const S * > ( pSrc );
+    for ( aitIndex i = 0u; i < nElem; i++ ) {
+        pD[i] = static_cast < D > ( pS[i] );
+    }
+}
+
+template < class D >
+static void convPerfCastTo ( void * pDest, aitEnum srcType,
+    const void * pSrc, aitIndex nElem )
+{
+    switch ( srcType ) {
+    case aitEnumInt8:
+        convPerfCast < D, aitInt8 > ( pDest, pSrc, nElem );
+        break;
+    case aitEnumUint8:
+        convPerfCast < D, aitUint8 > ( pDest, pSrc, nElem );
+        break;
+    case aitEnumInt16:
+        convPerfCast < D, aitInt16 > ( pDest, pSrc, nElem );
+        break;
+    case aitEnumUint16:
+    case aitEnumEnum16:
+        convPerfCast < D, aitUint16 > ( pDest, pSrc, nElem );
+        break;
+    case aitEnumInt32:
+        convPerfCast < D, aitInt32 > ( pDest, pSrc, nElem );
+        break;
+    case aitEnumUint32:
+        convPerfCast < D, aitUint32 > ( pDest, pSrc, nElem );
+        break;
+    case aitEnumFloat32:
+        convPerfCast < D, aitFloat32 > ( pDest, pSrc, nElem );
+        break;
+    case aitEnumFloat64:
+        convPerfCast < D, aitFloat64 > ( pDest, pSrc, nElem );
+        break;
+    default:
+        break;
+    }
+}
+
+static void convPerfReference ( aitEnum destType, void * pDest,
+    aitEnum srcType, const void * pSrc, aitIndex nElem )
+{
+    switch ( destType ) {
+    case aitEnumInt8:
+        convPerfCastTo < aitInt8 > ( pDest, srcType, pSrc, nElem );
+        break;
+    case aitEnumUint8:
+        convPerfCastTo < aitUint8 > ( pDest, srcType, pSrc, nElem );
+        break;
+    case aitEnumInt16:
+        convPerfCastTo < aitInt16 > ( pDest, srcType, pSrc, nElem );
+        break;
+    case aitEnumUint16:
+    case aitEnumEnum16:
+        convPerfCastTo < aitUint16 > ( pDest, srcType, pSrc, nElem );
+        break;
+    case aitEnumInt32:
+        convPerfCastTo < aitInt32 > ( pDest, srcType, pSrc, nElem );
+        break;
+    case aitEnumUint32:
+        convPerfCastTo < aitUint32 > ( pDest, srcType, pSrc, nElem );
+        break;
+    case aitEnumFloat32:
+        convPerfCastTo < aitFloat32 > ( pDest, srcType, pSrc, nElem );
+        break;
+    case aitEnumFloat64:
+        convPerfCastTo < aitFloat64 > ( pDest, srcType, pSrc, nElem );
+        break;
+    default:
+        break;
+    }
+}
+
+static bool convPerfNumeric ( aitEnum type )
+{
+    return type >= aitConvertAutoFirst && type <= aitConvertAutoLast;
+}
+
+#ifdef AIT_NEED_BYTE_SWAP
+static void convPerfSwap ( aitEnum type, void * pData, aitIndex nElem )
+{
+    size_t size = aitSize[type];
+    unsigned char * p = static_cast < unsigned char * > ( pData );
+    for ( aitIndex i = 0u; i < nElem; i++, p += size ) {
+        for ( size_t k = 0u; k < size / 2u; k++ ) {
+            unsigned char tmp = p[k];
+            p[k] = p[size - 1u - k];
+            p[size - 1u - k] = tmp;
+        }
+    }
+}
+#endif
+
+//
+// The input repeats every 16 elements, so that the integer values
+// are valid in every type and are also indexes into the enum table.
+// The floating point values have a fraction which is exact in binary.
+//
+static void convPerfFill ( aitEnum type, void * pData, aitIndex nElem )
+{
+    for ( aitIndex i = 0u; i < nElem; i++ ) {
+        aitFloat64 value = ( i % nEnumStates ) +
+            ( type == aitEnumFloat32 || type == aitEnumFloat64 ? 0.25 : 0.0 );
+        if ( convPerfNumeric ( type ) ) {
+            char * p = static_cast < char * > ( pData ) + i * aitSize[type];
+            convPerfReference ( type, p, aitEnumFloat64, & value, 1u );
+        }
+        else if ( type == aitEnumFixedString ) {
+            aitFixedString * p = static_cast < aitFixedString * > ( pData );
+            sprintf ( p[i].fixed_string, "%g", value );
+        }
+        else if ( type == aitEnumString ) {
+            char buf[32];
+            sprintf ( buf, "%g", value );
+            static_cast < aitString * > ( pData )[i].copy ( buf );
+        }
+    }
+}
+
+//
+// storage for the elements of one of the types in the tables
+//
+class convPerfBuffer {
+public:
+    convPerfBuffer ( aitEnum type, aitIndex nElem );
+    ~convPerfBuffer ();
+    void * pointer () const;
+    void clear ();
+    aitUint32 digest () const;
+    bool operator == ( const convPerfBuffer & ) const;
+private:
+    aitEnum type;
+    aitIndex nElem;
+    aitString * pStrings;
+    aitFloat64 * pStorage;
+    convPerfBuffer ( const convPerfBuffer & );
+    convPerfBuffer & operator = ( const convPerfBuffer & );
+};
+
+convPerfBuffer::convPerfBuffer ( aitEnum typeIn, aitIndex nElemIn ) :
+    type ( typeIn ), nElem ( nElemIn ), pStrings ( 0 ), pStorage ( 0 )
+{
+    if ( this->type == aitEnumString ) {
+        this->pStrings = new aitString [ this->nElem ];
+    }
+    else {
+        size_t size = aitSize[this->type] * this->nElem;
+        this->pStorage = new aitFloat64
+            [ ( size + sizeof ( aitFloat64 ) - 1u ) / sizeof ( aitFloat64 ) ];
+    }
+    this->clear ();
+}
+
+convPerfBuffer::~convPerfBuffer ()
+{
+    delete [] this->pStrings;
+    delete [] this->pStorage;
+}
+
+inline void * convPerfBuffer::pointer () const
+{
+    if ( this->pStrings ) {
+        return this->pStrings;
+    }
+    return this->pStorage;
+}
+
+void convPerfBuffer::clear ()
+{
+    if ( this->pStrings ) {
+        for ( aitIndex i = 0u; i < this->nElem; i++ ) {
+            this->pStrings[i].clear ();
+        }
+    }
+    else {
+        memset ( this->pStorage, '\0', aitSize[this->type] * this->nElem );
+    }
+}
+
+aitUint32 convPerfBuffer::digest () const
+{
+    aitUint32 digest = 2166136261u;
+    if ( this->pStrings ) {
+        for ( aitIndex i = 0u; i < this->nElem; i++ ) {
+            const char * pStr = this->pStrings[i].string ();
+            if ( ! pStr ) {
+                pStr = "";
+            }
+            digest = convPerfDigest ( digest, pStr, strlen ( pStr ) + 1u );
+        }
+    }
+    else {
+        digest = convPerfDigest ( digest, this->pStorage,
+            aitSize[this->type] * this->nElem );
+    }
+    return digest;
+}
+
+bool convPerfBuffer::operator == ( const convPerfBuffer & rhs ) const
+{
+    return this->type == rhs.type && this->nElem == rhs.nElem &&
+        this->pStorage && rhs.pStorage &&
+        memcmp ( this->pStorage, rhs.pStorage,
+            aitSize[this->type] * this->nElem ) == 0;
+}
+
+class aitConvertOp : public convPerfOp {
+public:
+    aitConvertOp ( aitFunc funcIn, convPerfBuffer & destIn,
+            const convPerfBuffer & srcIn, aitIndex nElemIn,
+            const gddEnumStringTable & tableIn ) :
+        func ( funcIn ), dest ( destIn ), src ( srcIn ),
+        nElem ( nElemIn ), table ( tableIn ) {}
+    int run ()
+    {
+        return ( *this->func ) ( this->dest.pointer (), this->src.pointer (),
+            this->nElem, & this->table );
+    }
+private:
+    aitFunc func;
+    convPerfBuffer & dest;
+    const convPerfBuffer & src;
+    aitIndex nElem;
+    const gddEnumStringTable & table;
+    aitConvertOp ( const aitConvertOp & );
+    aitConvertOp & operator = ( const aitConvertOp & );
+};
+
+enum convPerfTable { convPerfLocal, convPerfToNet, convPerfFromNet };
+
+static void aitConvertPerf ( convPerfTable which, const aitIndex * pNElem,
+    unsigned nSizes, const gddEnumStringTable & enumTable )
+{
+    const char * pTableName = "aitConvertTable";
+    if ( which == convPerfToNet ) {
+        pTableName = "aitConvertToNetTable";
+    }
+    else if ( which == convPerfFromNet ) {
+        pTableName = "aitConvertFromNetTable";
+    }
+
+    for ( int d = aitConvertFirst; d <= aitConvertLast; d++ ) {
+        aitEnum destType = static_cast < aitEnum > ( d );
+        for ( int s = aitConvertFirst; s <= aitConvertLast; s++ ) {
+            aitEnum srcType = static_cast < aitEnum > ( s );
+            aitFunc func;
+            if ( which == convPerfToNet ) {
+                func = aitConvertToNetTable[destType][srcType];
+            }
+            else if ( which == convPerfFromNet ) {
+                func = aitConvertFromNetTable[destType][srcType];
+            }
+            else {
+                func = aitConvertTable[destType][srcType];
+            }
+            if ( ! func ) {
+                continue;
+            }
+
+            for ( unsigned i = 0u; i < nSizes; i++ ) {
+                aitIndex nElem = pNElem[i];
+                convPerfBuffer src ( srcType, nElem );
+                convPerfBuffer dest ( destType, nElem );
+                convPerfFill ( srcType, src.pointer (), nElem );
+
+                const char * pCheck = "-";
+                bool numeric = convPerfNumeric ( destType ) &&
+                    convPerfNumeric ( srcType );
+                if ( numeric ) {
+                    convPerfBuffer ref ( destType, nElem );
+                    convPerfReference ( destType, ref.pointer (),
+                        srcType, src.pointer (), nElem );
+#                   ifdef AIT_NEED_BYTE_SWAP
+                        if ( which == convPerfToNet ) {
+                            convPerfSwap ( destType, ref.pointer (), nElem );
+                        }
+                        else if ( which == convPerfFromNet ) {
+                            convPerfSwap ( srcType, src.pointer (), nElem );
+                        }
+#                   endif
+                    int status = ( *func ) ( dest.pointer (), src.pointer (),
+                        nElem, & enumTable );
+                    if ( status < 0 ) {
+                        pCheck = "failed";
+                    }
+                    else if ( dest == ref ) {
+                        pCheck = "match";
+                    }
+                    else {
+                        pCheck = "differs";
+                        nMismatch++;
+                    }
+                }
+                else {
+#                   ifdef AIT_NEED_BYTE_SWAP
+                        if ( which == convPerfFromNet &&
+                                convPerfNumeric ( srcType ) ) {
+                            convPerfSwap ( srcType, src.pointer (), nElem );
+                        }
+#                   endif
+                    int status = ( *func ) ( dest.pointer (), src.pointer (),
+                        nElem, & enumTable );
+                    if ( status < 0 ) {
+                        pCheck = "failed";
+                    }
+                }
+                aitUint32 digest = dest.digest ();
+
+                aitConvertOp op ( func, dest, src, nElem, enumTable );
+                bool failed;
+                double delay = convPerfTime ( op, failed );
+                if ( failed && numeric ) {
+                    pCheck = "failed";
+                }
+                convPerfReport ( pTableName, aitName[destType],
+                    aitName[srcType], nElem, delay,
+                    ( aitSize[destType] + aitSize[srcType] ) * nElem,
+                    pCheck, digest );
+            }
+        }
+    }
+}
+
+class convGddOp : public convPerfOp {
+public:
+    convGddOp ( to_gdd funcIn, void * pDbrIn, aitIndex nElemIn ) :
+        func ( funcIn ), pDbr ( pDbrIn ), nElem ( nElemIn ) {}
+    int run ()
+    {
+        smartGDDPointer pDD = ( *this->func ) ( this->pDbr, this->nElem );
+        return pDD.valid () ? 0 : -1;
+    }
+private:
+    to_gdd func;
+    void * pDbr;
+    aitIndex nElem;
+    convGddOp ( const convGddOp & );
+    convGddOp & operator = ( const convGddOp & );
+};
+
+class convDbrOp : public convPerfOp {
+public:
+    convDbrOp ( to_dbr funcIn, void * pDbrIn, aitIndex nElemIn,
+            const gdd & ddIn, const gddEnumStringTable & tableIn ) :
+        func ( funcIn ), pDbr ( pDbrIn ), nElem ( nElemIn ),
+        dd ( ddIn ), table ( tableIn ) {}
+    int run ()
+    {
+        return ( *this->func ) ( this->pDbr, this->nElem, this->dd,
+            this->table ) < 0 ? -1 : 0;
+    }
+private:
+    to_dbr func;
+    void * pDbr;
+    aitIndex nElem;
+    const gdd & dd;
+    const gddEnumStringTable & table;
+    convDbrOp ( const convDbrOp & );
+    convDbrOp & operator = ( const convDbrOp & );
+};
+
+//
+// conv_gdd() and then conv_dbr() of each DBR type. The DBR structure
+// written by conv_dbr() is compared with the one which was read by
+// conv_gdd(). An empty enum table is used so that the state strings
+// of DBR_GR_ENUM and DBR_CTRL_ENUM round trip, but their conv_gdd()
+// reads only the first element of the value, and so for them the
+// structures are not compared.
+//
+static void dbMapperPerf ( const aitIndex * pNElem, unsigned nSizes )
+{
+    gddEnumStringTable enumTable;
+
+    for ( unsigned type = 0u; type <= DBR_CTRL_DOUBLE; type++ ) {
+        to_gdd toGdd = gddMapDbr[type].conv_gdd;
+        to_dbr toDbr = gddMapDbr[type].conv_dbr;
+        if ( ! toGdd || ! toDbr ) {
+            continue;
+        }
+        for ( unsigned i = 0u; i < nSizes; i++ ) {
+            aitIndex nElem = pNElem[i];
+            size_t size = dbr_size_n ( type, nElem );
+            size_t nWords = ( size + sizeof ( aitFloat64 ) - 1u ) /
+                sizeof ( aitFloat64 );
+            aitFloat64 * pIn = new aitFloat64 [ nWords ];
+            aitFloat64 * pOut = new aitFloat64 [ nWords ];
+            memset ( pIn, '\0', nWords * sizeof ( aitFloat64 ) );
+            memset ( pOut, '\0', nWords * sizeof ( aitFloat64 ) );
+            convPerfFill ( gddDbrToAit[type].type,
+                reinterpret_cast < char * > ( pIn ) + dbr_value_offset[type],
+                nElem );
+
+            bool failed;
+            convGddOp gddOp ( toGdd, pIn, nElem );
+            double delay = convPerfTime ( gddOp, failed );
+            smartGDDPointer pDD = ( *toGdd ) ( pIn, nElem );
+            convPerfReport ( "dbMapper.conv_gdd", "gdd", dbr_text[type],
+                nElem, delay, size, failed ? "failed" : "-", 0u );
+
+            if ( ! pDD.valid () ) {
+                convPerfReport ( "dbMapper.conv_dbr", dbr_text[type], "gdd",
+                    nElem, 0.0, size, "failed", 0u );
+            }
+            else {
+                const char * pCheck = "match";
+                if ( ( *toDbr ) ( pOut, nElem, *pDD, enumTable ) < 0 ) {
+                    pCheck = "failed";
+                }
+                else if ( type == DBR_GR_ENUM || type == DBR_CTRL_ENUM ) {
+                    pCheck = "-";
+                }
+                else if ( memcmp ( pIn, pOut, size ) != 0 ) {
+                    pCheck = "differs";
+                }
+                aitUint32 digest = convPerfDigest ( 2166136261u, pOut, size );
+                convDbrOp dbrOp ( toDbr, pOut, nElem, *pDD, enumTable );
+                delay = convPerfTime ( dbrOp, failed );
+                convPerfReport ( "dbMapper.conv_dbr", dbr_text[type], "gdd",
+                    nElem, delay, size, failed ? "failed" : pCheck, digest );
+            }
+            delete [] pIn;
+            delete [] pOut;
+        }
+    }
+}
+
+int main ( int argc, char ** argv )
+{
+    aitIndex maxElem = 4096u;
+    for ( int i = 1; i < argc; i++ ) {
+        if ( strcmp ( argv[i], "-j" ) == 0 ) {
+            jsonOutput = true;
+        }
+        else if ( strcmp ( argv[i], "-n" ) == 0 && i + 1 < argc ) {
+            maxElem = static_cast < aitIndex > ( atoi ( argv[++i] ) );
+        }
+        else if ( strcmp ( argv[i], "-t" ) == 0 && i + 1 < argc ) {
+            minTime = atof ( argv[++i] );
+        }
+        else {
+            fprintf ( stderr,
+                "usage: %s [-j] [-n <max elements>] [-t <min seconds>]\n",
+                argv[0] );
+            return 1;
+        }
+    }
+    if ( maxElem < 1u ) {
+        maxElem = 1u;
+    }
+
+    aitIndex nElem[16];
+    unsigned nSizes = 0u;
+    for ( aitIndex n = 1u; n <= maxElem && nSizes < 16u; n *= 16u ) {
+        nElem[nSizes++] = n;
+    }
+
+    gddApplicationTypeTable & table = gddApplicationTypeTable::AppTable ();
+    gddMakeMapDBR ( table );
+
+    gddEnumStringTable enumTable;
+    for ( unsigned k = 0u; k < nEnumStates; k++ ) {
+        char state[32];
+        sprintf ( state, "state %u", k );
+        enumTable.setString ( k, state );
+    }
+
+    if ( jsonOutput ) {
+        printf ( "[\n" );
+    }
+    aitConvertPerf ( convPerfLocal, nElem, nSizes, enumTable );
+#   ifdef AIT_NEED_BYTE_SWAP
+        aitConvertPerf ( convPerfToNet, nElem, nSizes, enumTable );
+        aitConvertPerf ( convPerfFromNet, nElem, nSizes, enumTable );
+#   endif
+    dbMapperPerf ( nElem, nSizes );
+    if ( jsonOutput ) {
+        printf ( "\n]\n" );
+    }
+
+    if ( nMismatch ) {
+        fprintf ( stderr, "%u numeric conversions differ from a cast\n",
+            nMismatch );
+        return 1;
+    }
+    return 0;
+}
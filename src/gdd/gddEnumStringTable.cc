@@ -19,12 +19,16 @@
 #define epicsExportSharedSymbols
 #include "gddEnumStringTable.h"
 
+// below this many strings a linear search is faster than the hash index
+static const unsigned gddEnumStringTableHashMinStrings = 8u;
+
 gddEnumStringTable::~gddEnumStringTable ()
 {
     for ( unsigned i = 0u; i < this->nStringSlots; i++ ) {
         delete [] this->pStringTable[i].pString;
     }
     delete [] this->pStringTable;
+    delete [] this->pHashIndex;
 }
 
 bool gddEnumStringTable::expand ( unsigned nStringsRequired )
@@ -64,6 +68,10 @@ void gddEnumStringTable::clear ()
     this->pStringTable = 0;
     this->nStringSlots = 0;
     this->nStrings = 0;
+    delete [] this->pHashIndex;
+    this->pHashIndex = 0;
+    this->hashIndexBits = 0;
+    this->hashIndexValid = false;
 }
 
 bool gddEnumStringTable::setString ( unsigned index, const char *pString )
@@ -88,6 +96,7 @@ bool gddEnumStringTable::setString ( unsigned index, const char *pString )
     if ( ! pNewString ) {
         return false;
     }
+    bool replaced = this->pStringTable[index].pString != 0;
     delete [] this->pStringTable[index].pString;
     this->pStringTable[index].pString = pNewString;
     strcpy ( this->pStringTable[index].pString, pString );
@@ -95,6 +104,7 @@ bool gddEnumStringTable::setString ( unsigned index, const char *pString )
     if ( this->nStrings <= index ) {
         this->nStrings = index + 1;
     }
+    this->updateHashIndex ( index, replaced );
     return true;
 }
 
@@ -141,8 +151,21 @@ unsigned gddEnumStringTable::getStringLength ( unsigned index ) const
 
 bool gddEnumStringTable::getIndex ( const char * pString, unsigned & indexOut ) const
 {
+    if ( this->hashIndexValid ) {
+        unsigned mask = ( 1u << this->hashIndexBits ) - 1u;
+        unsigned slot = gddEnumStringTable::hash ( pString ) & mask;
+        while ( unsigned entry = this->pHashIndex[slot] ) {
+            if ( ! strcmp ( pString, this->pStringTable[entry - 1u].pString ) ) {
+                indexOut = entry - 1u;
+                return true;
+            }
+            slot = ( slot + 1u ) & mask;
+        }
+        return false;
+    }
     for ( unsigned index = 0u; index < this->nStrings; index++ ) {
-        if ( ! strcmp ( pString, this->pStringTable[index].pString ) ) {
+        if ( this->pStringTable[index].pString &&
+                ! strcmp ( pString, this->pStringTable[index].pString ) ) {
             indexOut = index;
             return true;
         }
@@ -150,3 +173,81 @@ bool gddEnumStringTable::getIndex ( const char * pString, unsigned & indexOut )
     return false;
 }
 
+// FNV-1a
+unsigned gddEnumStringTable::hash ( const char * pString )
+{
+    unsigned h = 2166136261u;
+    while ( *pString ) {
+        h ^= static_cast < unsigned char > ( *pString++ );
+        h *= 16777619u;
+    }
+    return h;
+}
+
+//
+// A string appended at the end of the table is inserted into the
+// index, and otherwise the index is rebuilt. Tables are normally
+// filled in ascending index order, and so the index is rebuilt only
+// when it grows.
+//
+void gddEnumStringTable::updateHashIndex ( unsigned index, bool replaced )
+{
+    if ( this->nStrings < gddEnumStringTableHashMinStrings ) {
+        return;
+    }
+    if ( this->hashIndexValid && ! replaced && index + 1u == this->nStrings &&
+            ( 1u << this->hashIndexBits ) >= 2u * this->nStrings ) {
+        unsigned mask = ( 1u << this->hashIndexBits ) - 1u;
+        unsigned slot = gddEnumStringTable::hash ( 
+            this->pStringTable[index].pString ) & mask;
+        while ( this->pHashIndex[slot] ) {
+            slot = ( slot + 1u ) & mask;
+        }
+        this->pHashIndex[slot] = index + 1u;
+    }
+    else {
+        this->hashIndexValid = this->buildHashIndex ();
+    }
+}
+
+//
+// Strings are inserted in ascending index order with linear
+// probing so that, as with a linear search, the lowest index
+// is found when the same string appears more than once. 
+// Returns false, and getIndex() falls back to a linear search,
+// if there isnt memory for the index.
+//
+bool gddEnumStringTable::buildHashIndex ()
+{
+    // keep the load factor at or below one half
+    unsigned bits = 4u;
+    while ( ( 1u << bits ) < 2u * this->nStrings ) {
+        bits++;
+    }
+    if ( bits != this->hashIndexBits ) {
+        unsigned * pNewIndex = new ( std::nothrow ) unsigned [ 1u << bits ];
+        if ( ! pNewIndex ) {
+            delete [] this->pHashIndex;
+            this->pHashIndex = 0;
+            this->hashIndexBits = 0;
+            return false;
+        }
+        delete [] this->pHashIndex;
+        this->pHashIndex = pNewIndex;
+        this->hashIndexBits = bits;
+    }
+    unsigned mask = ( 1u << bits ) - 1u;
+    memset ( this->pHashIndex, '\0', ( mask + 1u ) * sizeof ( *this->pHashIndex ) );
+    for ( unsigned index = 0u; index < this->nStrings; index++ ) {
+        if ( ! this->pStringTable[index].pString ) {
+            continue;
+        }
+        unsigned slot = gddEnumStringTable::hash ( 
+            this->pStringTable[index].pString ) & mask;
+        while ( this->pHashIndex[slot] ) {
+            slot = ( slot + 1u ) & mask;
+        }
+        this->pHashIndex[slot] = index + 1u;
+    }
+    return true;
+}
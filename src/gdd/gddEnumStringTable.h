@@ -36,11 +36,24 @@ private:
         char * pString;
         unsigned length;
     } * pStringTable;
+    //
+    // getIndex() uses an open addressed hash index when the table
+    // is large. The index is kept up to date by setString(), so
+    // const readers never modify the table, and (like the rest of
+    // this class) the owner must serialize modifications with reads.
+    //
+    unsigned * pHashIndex; // string index + 1, zero if empty
+    unsigned hashIndexBits;
+    bool hashIndexValid;
     bool expand ( unsigned nStringsRequired );
+    void updateHashIndex ( unsigned index, bool replaced );
+    bool buildHashIndex ();
+    static unsigned hash ( const char * pString );
 };
 
 inline gddEnumStringTable::gddEnumStringTable () :
-    nStrings ( 0 ), nStringSlots ( 0 ), pStringTable ( 0 ) {}
+    nStrings ( 0 ), nStringSlots ( 0 ), pStringTable ( 0 ),
+    pHashIndex ( 0 ), hashIndexBits ( 0 ), hashIndexValid ( false ) {}
 
 inline unsigned gddEnumStringTable::numberOfStrings () const
 {
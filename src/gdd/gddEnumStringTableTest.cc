@@ -0,0 +1,132 @@
+/*************************************************************************\
+* Copyright (c) 2002 The University of Chicago, as Operator of Argonne
+*     National Laboratory.
+* Copyright (c) 2002 The Regents of the University of California, as
+*     Operator of Los Alamos National Laboratory.
+* EPICS BASE is distributed subject to a Software License Agreement found
+* in file LICENSE that is included with this distribution.
+\*************************************************************************/
+//
+// gddEnumStringTableTest.cc
+//
+// regression tests of gddEnumStringTable::getIndex()
+//
+
+#include "epicsStdio.h"
+
+#include "epicsUnitTest.h"
+#include "gddEnumStringTable.h"
+
+static const unsigned nStates = 300u;
+
+static void stateName ( unsigned index, char * pBuf, unsigned size )
+{
+    epicsSnprintf ( pBuf, size, "state%u", index );
+}
+
+//
+// every string is found at its index, with or without the hash index
+//
+static bool findAll ( const gddEnumStringTable & table, unsigned count,
+    unsigned skip )
+{
+    for ( unsigned i = 0u; i < count; i++ ) {
+        char buf[32];
+        stateName ( i, buf, sizeof ( buf ) );
+        unsigned index = ~0u;
+        bool found = table.getIndex ( buf, index );
+        if ( i == skip ) {
+            if ( found ) {
+                return false;
+            }
+        }
+        else if ( ! found || index != i ) {
+            return false;
+        }
+    }
+    return true;
+}
+
+static void testSmallTable ()
+{
+    gddEnumStringTable table;
+    table.setString ( 0u, "off" );
+    table.setString ( 1u, "on" );
+    unsigned index = ~0u;
+    testOk ( table.getIndex ( "on", index ) && index == 1u,
+        "string found in a table without the hash index" );
+    testOk ( ! table.getIndex ( "standby", index ),
+        "missing string not found in a small table" );
+}
+
+static void testLargeTable ()
+{
+    gddEnumStringTable table;
+    char buf[32];
+    for ( unsigned i = 0u; i < nStates; i++ ) {
+        stateName ( i, buf, sizeof ( buf ) );
+        table.setString ( i, buf );
+    }
+    testOk ( findAll ( table, nStates, nStates ),
+        "%u strings appended in order found", nStates );
+
+    unsigned index = ~0u;
+    testOk ( ! table.getIndex ( "nope", index ),
+        "missing string not found in a large table" );
+
+    // a duplicate must resolve to the lowest index, as
+    // the linear search did
+    table.setString ( 250u, "state7" );
+    testOk ( table.getIndex ( "state7", index ) && index == 7u,
+        "duplicate string found at the lowest index" );
+    testOk ( findAll ( table, nStates, 250u ),
+        "replaced string no longer found" );
+
+    table.setString ( 299u, "changed" );
+    testOk ( table.getIndex ( "changed", index ) && index == 299u,
+        "replacement found at its index" );
+
+    // leaves empty slots which the index must skip
+    table.setString ( 400u, "gap" );
+    testOk ( table.getIndex ( "gap", index ) && index == 400u,
+        "string set past the end found" );
+    testOk ( table.numberOfStrings () == 401u,
+        "number of strings includes the gap" );
+    testOk ( findAll ( table, 299u, 250u ),
+        "strings before the gap still found" );
+
+    table.clear ();
+    testOk ( ! table.getIndex ( "gap", index ),
+        "nothing found after clear()" );
+    for ( unsigned i = 0u; i < 20u; i++ ) {
+        stateName ( i, buf, sizeof ( buf ) );
+        table.setString ( i, buf );
+    }
+    testOk ( findAll ( table, 20u, 20u ),
+        "strings found after the table is refilled" );
+}
+
+//
+// the table is filled from the highest index down, so that
+// each string is inserted with the index rebuilt
+//
+static void testFilledBackwards ()
+{
+    gddEnumStringTable table;
+    char buf[32];
+    for ( unsigned i = nStates; i-- > 0u; ) {
+        stateName ( i, buf, sizeof ( buf ) );
+        table.setString ( i, buf );
+    }
+    testOk ( findAll ( table, nStates, nStates ),
+        "%u strings set in descending order found", nStates );
+}
+
+MAIN ( gddEnumStringTableTest )
+{
+    testPlan ( 13 );
+    testSmallTable ();
+    testLargeTable ();
+    testFilledBackwards ();
+    return testDone ();
+}
@@ -0,0 +1,349 @@
+/*************************************************************************\
+* Copyright (c) 2002 The University of Chicago, as Operator of Argonne
+*     National Laboratory.
+* Copyright (c) 2002 The Regents of the University of California, as
+*     Operator of Los Alamos National Laboratory.
+* EPICS BASE is distributed subject to a Software License Agreement found
+* in file LICENSE that is included with this distribution.
+\*************************************************************************/
+//
+// gddPerf.cc
+//
+// timing of the gdd library paths used when the server
+// converts between gdd and the DBR types
+//
+
+#include <stdio.h>
+#include <string.h>
+
+#include "epicsTime.h"
+#include "gddAppTable.h"
+#include "dbMapper.h"
+
+static const unsigned nCtrlTypes = DBR_CTRL_DOUBLE - DBR_CTRL_STRING + 1;
+static const unsigned nIterations = 100000u;
+static const unsigned nTrials = 5u;
+
+union dbrCtrlBuf {
+    dbr_sts_string sts_string;
+    dbr_ctrl_short ctrl_short;
+    dbr_ctrl_float ctrl_float;
+    dbr_ctrl_enum ctrl_enum;
+    dbr_ctrl_char ctrl_char;
+    dbr_ctrl_long ctrl_long;
+    dbr_ctrl_double ctrl_double;
+};
+
+template < class T >
+static void fillCtrl ( T & dbr )
+{
+    strcpy ( dbr.units, "mm" );
+    dbr.upper_disp_limit = 100;
+    dbr.lower_disp_limit = 1;
+    dbr.upper_alarm_limit = 90;
+    dbr.upper_warning_limit = 80;
+    dbr.lower_warning_limit = 20;
+    dbr.lower_alarm_limit = 10;
+    dbr.upper_ctrl_limit = 95;
+    dbr.lower_ctrl_limit = 5;
+    dbr.value = 42;
+}
+
+static void fillDbr ( unsigned type, dbrCtrlBuf & buf )
+{
+    memset ( & buf, '\0', sizeof ( buf ) );
+    switch ( type ) {
+    case DBR_CTRL_STRING:
+        strcpy ( buf.sts_string.value, "forty two" );
+        break;
+    case DBR_CTRL_SHORT:
+        fillCtrl ( buf.ctrl_short );
+        break;
+    case DBR_CTRL_FLOAT:
+        fillCtrl ( buf.ctrl_float );
+        buf.ctrl_float.precision = 3;
+        break;
+    case DBR_CTRL_ENUM:
+        buf.ctrl_enum.no_str = 2;
+        strcpy ( buf.ctrl_enum.strs[0], "off" );
+        strcpy ( buf.ctrl_enum.strs[1], "on" );
+        buf.ctrl_enum.value = 1;
+        break;
+    case DBR_CTRL_CHAR:
+        fillCtrl ( buf.ctrl_char );
+        break;
+    case DBR_CTRL_LONG:
+        fillCtrl ( buf.ctrl_long );
+        break;
+    case DBR_CTRL_DOUBLE:
+        fillCtrl ( buf.ctrl_double );
+        buf.ctrl_double.precision = 4;
+        break;
+    }
+    // the same bits appear in every field of the DBR_CTRL structures
+    buf.ctrl_double.status = 3;
+    buf.ctrl_double.severity = 1;
+}
+
+//
+// smartCopy() of one DBR_CTRL container into another, which is what
+// the server does when a client subscribes with a DBR_CTRL type
+//
+static void smartCopyPerf ( gddApplicationTypeTable & table )
+{
+    printf ( "smartCopy() of DBR_CTRL containers\n" );
+    for ( unsigned i = 0u; i < nCtrlTypes; i++ ) {
+        unsigned type = DBR_CTRL_STRING + i;
+        gddEnumStringTable enumStringTable;
+        dbrCtrlBuf in, out;
+
+        fillDbr ( type, in );
+        // the server supplies the enum state strings from the PV
+        if ( type == DBR_CTRL_ENUM ) {
+            for ( int k = 0; k < in.ctrl_enum.no_str; k++ ) {
+                enumStringTable.setString ( k, in.ctrl_enum.strs[k] );
+            }
+        }
+        smartGDDPointer pSrc = gddMapDbr[type].conv_gdd ( & in, 1 );
+        gdd * pDest = table.getDD ( gddDbrToAit[type].app );
+        if ( ! pSrc.valid () || ! pDest ) {
+            printf ( "\t%-12s no prototype\n", dbr_text[type] );
+            continue;
+        }
+
+        // best of several trials to discount other load on the host
+        gddStatus status = 0;
+        double delay = 0.0;
+        for ( unsigned trial = 0u; trial < nTrials; trial++ ) {
+            epicsTime begin = epicsTime::getCurrent ();
+            for ( unsigned j = 0u; j < nIterations; j++ ) {
+                status |= table.smartCopy ( pDest, pSrc.get () );
+            }
+            double trialDelay = epicsTime::getCurrent () - begin;
+            if ( trial == 0u || trialDelay < delay ) {
+                delay = trialDelay;
+            }
+        }
+
+        memset ( & out, '\0', sizeof ( out ) );
+        gddMapDbr[type].conv_dbr ( & out, 1, *pDest, enumStringTable );
+        bool match = memcmp ( & in, & out, dbr_size[type] ) == 0;
+
+        printf ( "\t%-16s %8.1f nS per copy%s\n", dbr_text[type],
+            delay * 1e9 / nIterations,
+            ( status || ! match ) ? " (copy mismatch)" : "" );
+        pDest->unreference ();
+    }
+}
+
+//
+// put() of a short array into a DD without storage of its own,
+// which allocates the data as the server does when it encodes
+// an array subscription update
+//
+static void shortArrayPutPerf ()
+{
+    static const unsigned nElem[] = { 2u, 8u, 16u, 64u };
+
+    printf ( "put() of aitFloat64 arrays into a new DD\n" );
+    for ( unsigned i = 0u; i < sizeof ( nElem ) / sizeof ( nElem[0] ); i++ ) {
+        aitFloat64 src[64];
+        for ( unsigned k = 0u; k < nElem[i]; k++ ) {
+            src[k] = k;
+        }
+        gdd * pSrc = new gddAtomic ( 0, aitEnumFloat64, 1, nElem[i] );
+        pSrc->putRef ( src );
+
+        gddStatus status = 0;
+        double delay = 0.0;
+        for ( unsigned trial = 0u; trial < nTrials; trial++ ) {
+            epicsTime begin = epicsTime::getCurrent ();
+            for ( unsigned j = 0u; j < nIterations; j++ ) {
+                gdd * pDest = new gddAtomic ( 0, aitEnumFloat64, 1, nElem[i] );
+                status |= pDest->put ( pSrc );
+                pDest->unreference ();
+            }
+            double trialDelay = epicsTime::getCurrent () - begin;
+            if ( trial == 0u || trialDelay < delay ) {
+                delay = trialDelay;
+            }
+        }
+
+        printf ( "\t%3u elements     %8.1f nS per put%s\n", nElem[i],
+            delay * 1e9 / nIterations, status ? " (put failed)" : "" );
+        pSrc->unreference ();
+    }
+}
+
+//
+// conv_dbr() of a DD into the DBR_TIME and DBR_CTRL structures, which
+// is what the server does for each subscription update. The members of
+// the containers are posted as aitFloat64, as many server tools do.
+//
+static void encodePerf ( gddApplicationTypeTable & table )
+{
+    static const unsigned types[] = {
+        DBR_TIME_SHORT, DBR_TIME_FLOAT, DBR_TIME_DOUBLE,
+        DBR_CTRL_SHORT, DBR_CTRL_FLOAT, DBR_CTRL_CHAR,
+        DBR_CTRL_LONG, DBR_CTRL_DOUBLE
+    };
+
+    printf ( "conv_dbr() of aitFloat64 DDs\n" );
+    for ( unsigned i = 0u; i < sizeof ( types ) / sizeof ( types[0] ); i++ ) {
+        unsigned type = types[i];
+        gddEnumStringTable enumStringTable;
+        dbrCtrlBuf out;
+
+        gdd * pSrc = table.getDD ( gddDbrToAit[type].app );
+        if ( ! pSrc ) {
+            pSrc = new gddScalar ( gddDbrToAit[type].app, aitEnumFloat64 );
+        }
+        if ( pSrc->isContainer () ) {
+            aitString units ( "mm" );
+            gdd & unitsDD = ( *pSrc ) [ 1u ];
+            unitsDD.put ( units );
+            for ( unsigned k = 2u; k <= pSrc->getDataSizeElements (); k++ ) {
+                gdd & member = ( *pSrc ) [ k ];
+                member.put ( static_cast < aitFloat64 > ( k ) );
+                member.setStatSevr ( 3, 1 );
+            }
+        }
+        else {
+            pSrc->put ( static_cast < aitFloat64 > ( 42 ) );
+            pSrc->setStatSevr ( 3, 1 );
+        }
+
+        int status = 0;
+        double delay = 0.0;
+        for ( unsigned trial = 0u; trial < nTrials; trial++ ) {
+            epicsTime begin = epicsTime::getCurrent ();
+            for ( unsigned j = 0u; j < nIterations; j++ ) {
+                status |= gddMapDbr[type].conv_dbr ( & out, 1, *pSrc, enumStringTable );
+            }
+            double trialDelay = epicsTime::getCurrent () - begin;
+            if ( trial == 0u || trialDelay < delay ) {
+                delay = trialDelay;
+            }
+        }
+
+        printf ( "\t%-16s %8.1f nS per conversion%s\n", dbr_text[type],
+            delay * 1e9 / nIterations, status < 0 ? " (conversion failed)" : "" );
+        pSrc->unreference ();
+    }
+}
+
+//
+// aitConvert() between aitFloat64 and aitFixedString, which is what the
+// server does when a client subscribes to a numeric PV as DBR_STRING
+//
+static void stringConvertPerf ()
+{
+    static const unsigned nElem = 1000u;
+    static const unsigned nConvert = nIterations / nElem;
+    static aitFloat64 values[nElem];
+    static aitFixedString strings[nElem];
+    static aitFloat64 parsed[nElem];
+
+    // mostly outside of the range with four decimal places
+    for ( unsigned i = 0u; i < nElem; i++ ) {
+        switch ( i % 4u ) {
+        case 0u: values[i] = 12345.678 * i; break;
+        case 1u: values[i] = -1.5e-6 * i; break;
+        case 2u: values[i] = 1000.0 * i; break;
+        default: values[i] = 3.25 + i; break;
+        }
+    }
+
+    printf ( "aitConvert() between aitFloat64 and aitFixedString\n" );
+    for ( unsigned direction = 0u; direction < 2u; direction++ ) {
+        int status = 0;
+        double delay = 0.0;
+        for ( unsigned trial = 0u; trial < nTrials; trial++ ) {
+            epicsTime begin = epicsTime::getCurrent ();
+            for ( unsigned j = 0u; j < nConvert; j++ ) {
+                if ( direction == 0u ) {
+                    status |= aitConvert ( aitEnumFixedString, strings,
+                        aitEnumFloat64, values, nElem );
+                }
+                else {
+                    status |= aitConvert ( aitEnumFloat64, parsed,
+                        aitEnumFixedString, strings, nElem );
+                }
+            }
+            double trialDelay = epicsTime::getCurrent () - begin;
+            if ( trial == 0u || trialDelay < delay ) {
+                delay = trialDelay;
+            }
+        }
+        printf ( "\t%-16s %8.1f nS per element%s\n",
+            direction == 0u ? "to string" : "from string",
+            delay * 1e9 / ( nConvert * nElem ),
+            status < 0 ? " (conversion failed)" : "" );
+    }
+}
+
+//
+// getApplicationType() of each registered name, which the server tools
+// and dbMapper do when they look up the app types by name
+//
+static void appNamePerf ( gddApplicationTypeTable & table )
+{
+    static const unsigned nLookups = nIterations / 10u;
+    unsigned nNames = 0u;
+    for ( aitUint32 app = 1u; app < table.totalregistered (); app++ ) {
+        if ( table.getName ( app ) ) {
+            nNames++;
+        }
+    }
+
+    printf ( "getApplicationType() of %u registered names\n", nNames );
+    unsigned nMismatch = 0u;
+    double delay = 0.0;
+    for ( unsigned trial = 0u; trial < nTrials; trial++ ) {
+        epicsTime begin = epicsTime::getCurrent ();
+        for ( unsigned j = 0u; j < nLookups; j++ ) {
+            aitUint32 app = 1u + j % ( table.totalregistered () - 1u );
+            const char * pName = table.getName ( app );
+            if ( pName && table.getApplicationType ( pName ) != app ) {
+                nMismatch++;
+            }
+        }
+        double trialDelay = epicsTime::getCurrent () - begin;
+        if ( trial == 0u || trialDelay < delay ) {
+            delay = trialDelay;
+        }
+    }
+    printf ( "\t%-16s %8.1f nS per lookup%s\n", "registered",
+        delay * 1e9 / nLookups, nMismatch ? " (lookup mismatch)" : "" );
+
+    delay = 0.0;
+    unsigned nFound = 0u;
+    for ( unsigned trial = 0u; trial < nTrials; trial++ ) {
+        epicsTime begin = epicsTime::getCurrent ();
+        for ( unsigned j = 0u; j < nLookups; j++ ) {
+            if ( table.getApplicationType ( "notRegistered" ) ) {
+                nFound++;
+            }
+        }
+        double trialDelay = epicsTime::getCurrent () - begin;
+        if ( trial == 0u || trialDelay < delay ) {
+            delay = trialDelay;
+        }
+    }
+    printf ( "\t%-16s %8.1f nS per lookup%s\n", "not registered",
+        delay * 1e9 / nLookups, nFound ? " (lookup mismatch)" : "" );
+}
+
+int main ()
+{
+    gddApplicationTypeTable & table = gddApplicationTypeTable::AppTable ();
+    gddMakeMapDBR ( table );
+
+    smartCopyPerf ( table );
+    shortArrayPutPerf ();
+    encodePerf ( table );
+    stringConvertPerf ();
+    appNamePerf ( table );
+
+    return 0;
+}
@@ -35,6 +35,10 @@ gdd_NEWDEL_NEW(gddDestructor)
 gdd_NEWDEL_DEL(gddDestructor)
 gdd_NEWDEL_STAT(gddDestructor)
 
+gdd_NEWDEL_NEW(gddSmallArray)
+gdd_NEWDEL_DEL(gddSmallArray)
+gdd_NEWDEL_STAT(gddSmallArray)
+
 // --------------------------The gddBounds functions-------------------
 
 // gddBounds::gddBounds(void) { first=0; count=0; }
@@ -57,3 +61,8 @@ void gddDestructor::run(void* thing)
 	delete [] pd;
 }
 
+// the data are freed along with the destructor
+void gddSmallArray::run(void*)
+{
+}
+
@@ -99,6 +99,32 @@ private:
 	gdd_NEWDEL_DATA
 };
 
+// ---------------------------------------------------------------------
+// Storage for the data of a short array together with the destructor
+// that frees it.  The gdd library uses these when it must allocate the
+// data of an atomic DD that is small enough, so that the data and the
+// destructor are a single allocation from a free list instead of two.
+
+#define GDD_SMALL_ARRAY_SIZE 128 // bytes - 16 aitFloat64 elements
+
+class epicsShareClass gddSmallArray : public gddDestructor
+{
+public:
+	gddSmallArray(void) { }
+	void* buffer(void);
+	virtual void run(void*);
+
+	gdd_NEWDEL_FUNC(arg) // for using generic new and remove
+protected:
+	virtual ~gddSmallArray () {}
+private:
+	union {
+		aitFloat64 align;
+		aitUint8 data[GDD_SMALL_ARRAY_SIZE];
+	} storage;
+	gdd_NEWDEL_DATA
+};
+
 #include "gddUtilsI.h"
 
 // ---------------------------------------------------------------------
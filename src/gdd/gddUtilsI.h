@@ -30,4 +30,6 @@ inline gddDestructor::gddDestructor(void* usr_arg) { ref_cnt=0; arg=usr_arg; }
 inline void gddDestructor::reference(void)      { ref_cnt++; }
 inline int gddDestructor::refCount(void) const  { return ref_cnt; }
 
+inline void* gddSmallArray::buffer(void)        { return storage.data; }
+
 #endif
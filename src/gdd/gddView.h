@@ -0,0 +1,168 @@
+/*************************************************************************\
+* Copyright (c) 2002 The University of Chicago, as Operator of Argonne
+*     National Laboratory.
+* Copyright (c) 2002 The Regents of the University of California, as
+*     Operator of Los Alamos National Laboratory.
+* EPICS BASE is distributed subject to a Software License Agreement found
+* in file LICENSE that is included with this distribution.
+\*************************************************************************/
+
+//
+// Typed views of the data in a gdd
+//
+// The primitive type of the DD is checked once when the view is
+// constructed. If it matches the view's type then the data are accessed
+// directly, with no conversion and no aitConvert() dispatch.
+// Otherwise valid() returns false, and the caller falls back to the
+// converting get() and put() interfaces.
+//
+//  gddArrayView < const aitFloat64 > view ( dd );
+//  if ( view.valid () ) {
+//      for ( aitIndex i = 0u; i < view.size (); i++ ) {
+//          sum += view[i];
+//      }
+//  }
+//
+// A view is only valid while the DD keeps the same data and bounds.
+// The view does not reference the DD.
+//
+
+#ifndef gddView_h
+#define gddView_h
+
+#include "gdd.h"
+
+//
+// the ait primitive types that a view may be instantiated with
+//
+template < class T > struct gddPrimitiveTraits;
+
+template <> struct gddPrimitiveTraits < aitInt8 > {
+    static bool match ( aitEnum t ) { return t == aitEnumInt8; }
+};
+template <> struct gddPrimitiveTraits < aitUint8 > {
+    static bool match ( aitEnum t ) { return t == aitEnumUint8; }
+};
+template <> struct gddPrimitiveTraits < aitInt16 > {
+    static bool match ( aitEnum t ) { return t == aitEnumInt16; }
+};
+// aitEnum16 is the same C++ type as aitUint16
+template <> struct gddPrimitiveTraits < aitUint16 > {
+    static bool match ( aitEnum t )
+        { return t == aitEnumUint16 || t == aitEnumEnum16; }
+};
+template <> struct gddPrimitiveTraits < aitInt32 > {
+    static bool match ( aitEnum t ) { return t == aitEnumInt32; }
+};
+template <> struct gddPrimitiveTraits < aitUint32 > {
+    static bool match ( aitEnum t ) { return t == aitEnumUint32; }
+};
+template <> struct gddPrimitiveTraits < aitFloat32 > {
+    static bool match ( aitEnum t ) { return t == aitEnumFloat32; }
+};
+template <> struct gddPrimitiveTraits < aitFloat64 > {
+    static bool match ( aitEnum t ) { return t == aitEnumFloat64; }
+};
+
+//
+// a view of const data is constructed from a const DD
+//
+template < class T > struct gddViewTraits {
+    typedef gdd gddType;
+    typedef T primitiveType;
+};
+template < class T > struct gddViewTraits < const T > {
+    typedef const gdd gddType;
+    typedef T primitiveType;
+};
+
+template < class T >
+class gddScalarView {
+public:
+    gddScalarView ( typename gddViewTraits < T > :: gddType & dd );
+    bool valid () const;
+    T & operator * () const;
+private:
+    T * pValue;
+};
+
+//
+// a scalar DD is viewed as an array with one element
+//
+template < class T >
+class gddArrayView {
+public:
+    gddArrayView ( typename gddViewTraits < T > :: gddType & dd );
+    bool valid () const;
+    aitIndex size () const;
+    T * pointer () const;
+    T & operator [] ( aitIndex index ) const;
+private:
+    T * pData;
+    aitIndex nElem;
+};
+
+template < class T >
+inline gddScalarView < T > :: gddScalarView (
+        typename gddViewTraits < T > :: gddType & dd ) :
+    pValue ( 0 )
+{
+    typedef typename gddViewTraits < T > :: primitiveType P;
+    if ( dd.isScalar () &&
+            gddPrimitiveTraits < P > :: match ( dd.primitiveType () ) ) {
+        this->pValue = static_cast < T * > ( dd.dataVoid () );
+    }
+}
+
+template < class T >
+inline bool gddScalarView < T > :: valid () const
+{
+    return this->pValue != 0;
+}
+
+template < class T >
+inline T & gddScalarView < T > :: operator * () const
+{
+    return *this->pValue;
+}
+
+template < class T >
+inline gddArrayView < T > :: gddArrayView (
+        typename gddViewTraits < T > :: gddType & dd ) :
+    pData ( 0 ), nElem ( 0u )
+{
+    typedef typename gddViewTraits < T > :: primitiveType P;
+    if ( ! dd.isContainer () &&
+            gddPrimitiveTraits < P > :: match ( dd.primitiveType () ) ) {
+        this->pData = static_cast < T * > ( dd.dataVoid () );
+        if ( this->pData ) {
+            this->nElem = dd.getDataSizeElements ();
+        }
+    }
+}
+
+template < class T >
+inline bool gddArrayView < T > :: valid () const
+{
+    return this->pData != 0;
+}
+
+template < class T >
+inline aitIndex gddArrayView < T > :: size () const
+{
+    return this->nElem;
+}
+
+template < class T >
+inline T * gddArrayView < T > :: pointer () const
+{
+    return this->pData;
+}
+
+template < class T >
+inline T & gddArrayView < T > :: operator [] ( aitIndex index ) const
+{
+    return this->pData[index];
+}
+
+#endif // gddView_h
@@ -0,0 +1,365 @@
+/*************************************************************************\
+* Copyright (c) 2002 The University of Chicago, as Operator of Argonne
+*     National Laboratory.
+* Copyright (c) 2002 The Regents of the University of California, as
+*     Operator of Los Alamos National Laboratory.
+* EPICS BASE is distributed subject to a Software License Agreement found
+* in file LICENSE that is included with this distribution.
+\*************************************************************************/
+
+#include <string.h>
+
+#include "epicsTime.h"
+#include "caerr.h"
+#include "db_access.h"
+
+#include "benchClient.h"
+
+static const unsigned benchClientBufSize = 0x10000;
+static const unsigned benchMaxPayload = 128u;
+
+//
+// the extended header of messages with a payload of 0xffff bytes
+// or more, or with 0xffff elements or more, which CA V4.9 and later
+// clients and servers send
+//
+static const unsigned benchLargeHdrSize = sizeof ( caHdr ) +
+    2u * sizeof ( ca_uint32_t );
+
+static unsigned benchEncode ( char * pMsg, unsigned cmmd,
+    unsigned dataType, unsigned count, ca_uint32_t cid,
+    ca_uint32_t available, const void * pPayload, unsigned payloadSize )
+{
+    unsigned postSize = CA_MESSAGE_ALIGN ( payloadSize );
+    caHdr hdr;
+    hdr.m_cmmd = htons ( static_cast < ca_uint16_t > ( cmmd ) );
+    hdr.m_dataType = htons ( static_cast < ca_uint16_t > ( dataType ) );
+    hdr.m_cid = htonl ( cid );
+    hdr.m_available = htonl ( available );
+    unsigned hdrSize;
+    if ( postSize < 0xffff && count < 0xffff ) {
+        hdr.m_postsize = htons ( static_cast < ca_uint16_t > ( postSize ) );
+        hdr.m_count = htons ( static_cast < ca_uint16_t > ( count ) );
+        memcpy ( pMsg, & hdr, sizeof ( hdr ) );
+        hdrSize = sizeof ( hdr );
+    }
+    else {
+        hdr.m_postsize = htons ( 0xffff );
+        hdr.m_count = htons ( 0u );
+        ca_uint32_t LWA[2];
+        LWA[0] = htonl ( postSize );
+        LWA[1] = htonl ( count );
+        memcpy ( pMsg, & hdr, sizeof ( hdr ) );
+        memcpy ( pMsg + sizeof ( hdr ), LWA, sizeof ( LWA ) );
+        hdrSize = benchLargeHdrSize;
+    }
+    memset ( pMsg + hdrSize, '\0', postSize );
+    if ( payloadSize ) {
+        memcpy ( pMsg + hdrSize, pPayload, payloadSize );
+    }
+    return hdrSize + postSize;
+}
+
+//
+// returns -1 if the socket failed, 0 if nothing arrived
+// before the delay expired, and 1 otherwise
+//
+static int benchWait ( SOCKET sock, double delay )
+{
+    fd_set readable;
+    FD_ZERO ( & readable );
+    FD_SET ( sock, & readable );
+    struct timeval tv;
+    tv.tv_sec = static_cast < long > ( delay );
+    tv.tv_usec = static_cast < long > ( ( delay - tv.tv_sec ) * 1e6 );
+    int status = select ( static_cast < int > ( sock ) + 1,
+        & readable, 0, 0, & tv );
+    if ( status < 0 ) {
+        return -1;
+    }
+    return status > 0 ? 1 : 0;
+}
+
+benchClient::benchClient () :
+    sock ( INVALID_SOCKET ), pBuf ( new char [ benchClientBufSize ] ),
+    bufSize ( benchClientBufSize ), bufBegin ( 0u ), bufEnd ( 0u ),
+    nBytesIn ( 0u ), nextId ( 1u )
+{
+}
+
+benchClient::~benchClient ()
+{
+    if ( this->sock != INVALID_SOCKET ) {
+        epicsSocketDestroy ( this->sock );
+    }
+    delete [] this->pBuf;
+}
+
+bool benchClient::connect ( const osiSockAddr & server )
+{
+    this->sock = epicsSocketCreate ( AF_INET, SOCK_STREAM, IPPROTO_TCP );
+    if ( this->sock == INVALID_SOCKET ) {
+        return false;
+    }
+    int flag = 1;
+    setsockopt ( this->sock, IPPROTO_TCP, TCP_NODELAY,
+        reinterpret_cast < char * > ( & flag ), sizeof ( flag ) );
+    if ( ::connect ( this->sock, & server.sa, sizeof ( server.ia ) ) < 0 ) {
+        return false;
+    }
+
+    // the priority is in the data type field, and the
+    // minor version in the count field
+    static const char userName[] = "casBench";
+    static const char hostName[] = "localhost";
+    return this->send ( CA_PROTO_VERSION, CA_PROTO_PRIORITY_MIN,
+            CA_MINOR_PROTOCOL_REVISION, 0u, 0u, 0, 0u ) &&
+        this->send ( CA_PROTO_CLIENT_NAME, 0u, 0u, 0u, 0u,
+            userName, sizeof ( userName ) ) &&
+        this->send ( CA_PROTO_HOST_NAME, 0u, 0u, 0u, 0u,
+            hostName, sizeof ( hostName ) );
+}
+
+bool benchClient::send ( unsigned cmmd, unsigned dataType,
+        unsigned count, ca_uint32_t cid, ca_uint32_t available,
+        const void * pPayload, unsigned payloadSize )
+{
+    char msg [ benchLargeHdrSize + benchMaxPayload ];
+    if ( payloadSize > benchMaxPayload ) {
+        return false;
+    }
+    unsigned size = benchEncode ( msg, cmmd, dataType, count,
+        cid, available, pPayload, payloadSize );
+    unsigned sent = 0u;
+    while ( sent < size ) {
+        int status = ::send ( this->sock, msg + sent, size - sent, 0 );
+        if ( status <= 0 ) {
+            return false;
+        }
+        sent += static_cast < unsigned > ( status );
+    }
+    return true;
+}
+
+int benchClient::fill ( double delay )
+{
+    if ( this->bufBegin > 0u ) {
+        memmove ( this->pBuf, this->pBuf + this->bufBegin,
+            this->bufEnd - this->bufBegin );
+        this->bufEnd -= this->bufBegin;
+        this->bufBegin = 0u;
+    }
+    int status = benchWait ( this->sock, delay );
+    if ( status <= 0 ) {
+        return status;
+    }
+    int nBytes = recv ( this->sock, this->pBuf + this->bufEnd,
+        this->bufSize - this->bufEnd, 0 );
+    if ( nBytes <= 0 ) {
+        return -1;
+    }
+    this->bufEnd += static_cast < unsigned > ( nBytes );
+    this->nBytesIn += static_cast < unsigned > ( nBytes );
+    return 1;
+}
+
+//
+// Returns false if the buffer doesnt hold a complete message, after
+// enlarging it if the message wont fit. The payload is skipped.
+//
+bool benchClient::nextMessage ( caHdr & hdr )
+{
+    unsigned nBytes = this->bufEnd - this->bufBegin;
+    if ( nBytes < sizeof ( caHdr ) ) {
+        return false;
+    }
+    const char * pMsg = this->pBuf + this->bufBegin;
+    memcpy ( & hdr, pMsg, sizeof ( hdr ) );
+    hdr.m_cmmd = ntohs ( hdr.m_cmmd );
+    hdr.m_postsize = ntohs ( hdr.m_postsize );
+    hdr.m_dataType = ntohs ( hdr.m_dataType );
+    hdr.m_count = ntohs ( hdr.m_count );
+    hdr.m_cid = ntohl ( hdr.m_cid );
+    hdr.m_available = ntohl ( hdr.m_available );
+
+    unsigned hdrSize = sizeof ( caHdr );
+    unsigned payloadSize = hdr.m_postsize;
+    if ( hdr.m_postsize == 0xffff && hdr.m_count == 0u ) {
+        if ( nBytes < benchLargeHdrSize ) {
+            return false;
+        }
+        ca_uint32_t largeSize;
+        memcpy ( & largeSize, pMsg + sizeof ( caHdr ), sizeof ( largeSize ) );
+        hdrSize = benchLargeHdrSize;
+        payloadSize = ntohl ( largeSize );
+    }
+
+    unsigned msgSize = hdrSize + payloadSize;
+    if ( nBytes < msgSize ) {
+        if ( msgSize > this->bufSize ) {
+            char * pNewBuf = new char [ msgSize ];
+            memcpy ( pNewBuf, pMsg, nBytes );
+            delete [] this->pBuf;
+            this->pBuf = pNewBuf;
+            this->bufSize = msgSize;
+            this->bufBegin = 0u;
+            this->bufEnd = nBytes;
+        }
+        return false;
+    }
+    this->bufBegin += msgSize;
+    return true;
+}
+
+//
+// requests are issued one at a time, so the first
+// response of the expected type is the one
+//
+bool benchClient::waitFor ( unsigned cmmd, caHdr & hdr )
+{
+    while ( true ) {
+        while ( this->nextMessage ( hdr ) ) {
+            if ( hdr.m_cmmd == cmmd ) {
+                return true;
+            }
+            if ( hdr.m_cmmd == CA_PROTO_ERROR ||
+                    hdr.m_cmmd == CA_PROTO_CREATE_CH_FAIL ) {
+                return false;
+            }
+        }
+        if ( this->fill ( 5.0 ) <= 0 ) {
+            return false;
+        }
+    }
+}
+
+bool benchClient::createChannel ( const char * pName, ca_uint32_t & sid )
+{
+    ca_uint32_t cid = this->nextId++;
+    if ( ! this->send ( CA_PROTO_CREATE_CHAN, 0u, 0u, cid,
+            CA_MINOR_PROTOCOL_REVISION, pName, strlen ( pName ) + 1u ) ) {
+        return false;
+    }
+    caHdr hdr;
+    if ( ! this->waitFor ( CA_PROTO_CREATE_CHAN, hdr ) || hdr.m_cid != cid ) {
+        return false;
+    }
+    sid = hdr.m_available;
+    return true;
+}
+
+bool benchClient::readNotify ( ca_uint32_t sid,
+    unsigned dbrType, unsigned count )
+{
+    ca_uint32_t ioid = this->nextId++;
+    if ( ! this->send ( CA_PROTO_READ_NOTIFY, dbrType, count,
+            sid, ioid, 0, 0u ) ) {
+        return false;
+    }
+    caHdr hdr;
+    // the status is in the cid field
+    return this->waitFor ( CA_PROTO_READ_NOTIFY, hdr ) &&
+        hdr.m_available == ioid && hdr.m_cid == ECA_NORMAL;
+}
+
+bool benchClient::subscribe ( ca_uint32_t sid,
+    unsigned dbrType, unsigned count )
+{
+    mon_info info;
+    memset ( & info, '\0', sizeof ( info ) );
+    info.m_mask = htons ( DBE_VALUE | DBE_ALARM );
+    return this->send ( CA_PROTO_EVENT_ADD, dbrType, count,
+        sid, this->nextId++, & info, sizeof ( info ) );
+}
+
+int benchClient::receiveUpdates ( double delay )
+{
+    int nUpdates = 0;
+    caHdr hdr;
+    while ( true ) {
+        while ( this->nextMessage ( hdr ) ) {
+            if ( hdr.m_cmmd == CA_PROTO_EVENT_ADD ) {
+                nUpdates++;
+            }
+        }
+        if ( nUpdates > 0 ) {
+            return nUpdates;
+        }
+        int status = this->fill ( delay );
+        if ( status <= 0 ) {
+            return status;
+        }
+    }
+}
+
+benchSearchClient::benchSearchClient () :
+    sock ( INVALID_SOCKET ), pBuf ( new char [ MAX_UDP_RECV ] ),
+    nextId ( 1u )
+{
+}
+
+benchSearchClient::~benchSearchClient ()
+{
+    if ( this->sock != INVALID_SOCKET ) {
+        epicsSocketDestroy ( this->sock );
+    }
+    delete [] this->pBuf;
+}
+
+bool benchSearchClient::open ()
+{
+    this->sock = epicsSocketCreate ( AF_INET, SOCK_DGRAM, IPPROTO_UDP );
+    return this->sock != INVALID_SOCKET;
+}
+
+int benchSearchClient::search ( const osiSockAddr & server,
+    const char * const * pNames, unsigned nNames, double delay,
+    unsigned short & tcpPort )
+{
+    char msg [ MAX_UDP_SEND ];
+    unsigned size = benchEncode ( msg, CA_PROTO_VERSION, CA_PROTO_PRIORITY_MIN,
+        CA_MINOR_PROTOCOL_REVISION, 0u, 0u, 0, 0u );
+    ca_uint32_t firstId = this->nextId;
+    for ( unsigned i = 0u; i < nNames; i++ ) {
+        unsigned nameSize = strlen ( pNames[i] ) + 1u;
+        if ( size + sizeof ( caHdr ) + CA_MESSAGE_ALIGN ( nameSize ) > sizeof ( msg ) ) {
+            break;
+        }
+        ca_uint32_t id = this->nextId++;
+        size += benchEncode ( msg + size, CA_PROTO_SEARCH, DONTREPLY,
+            CA_MINOR_PROTOCOL_REVISION, id, id, pNames[i], nameSize );
+    }
+    ca_uint32_t nRequests = this->nextId - firstId;
+    int status = sendto ( this->sock, msg, size, 0,
+        & server.sa, sizeof ( server.ia ) );
+    if ( status < 0 ) {
+        return -1;
+    }
+
+    int nReplies = 0;
+    epicsTime begin = epicsTime::getCurrent ();
+    while ( static_cast < ca_uint32_t > ( nReplies ) < nRequests ) {
+        double remaining = delay - ( epicsTime::getCurrent () - begin );
+        if ( remaining <= 0.0 || benchWait ( this->sock, remaining ) <= 0 ) {
+            break;
+        }
+        int nBytes = recvfrom ( this->sock, this->pBuf, MAX_UDP_RECV, 0, 0, 0 );
+        if ( nBytes < 0 ) {
+            return -1;
+        }
+        unsigned pos = 0u;
+        while ( pos + sizeof ( caHdr ) <= static_cast < unsigned > ( nBytes ) ) {
+            caHdr hdr;
+            memcpy ( & hdr, this->pBuf + pos, sizeof ( hdr ) );
+            pos += sizeof ( hdr ) + ntohs ( hdr.m_postsize );
+            ca_uint32_t id = ntohl ( hdr.m_available );
+            // the server's TCP port is in the data type field
+            if ( ntohs ( hdr.m_cmmd ) == CA_PROTO_SEARCH &&
+                    id - firstId < nRequests ) {
+                tcpPort = ntohs ( hdr.m_dataType );
+                nReplies++;
+            }
+        }
+    }
+    return nReplies;
+}
@@ -0,0 +1,88 @@
+/*************************************************************************\
+* Copyright (c) 2002 The University of Chicago, as Operator of Argonne
+*     National Laboratory.
+* Copyright (c) 2002 The Regents of the University of California, as
+*     Operator of Los Alamos National Laboratory.
+* EPICS BASE is distributed subject to a Software License Agreement found
+* in file LICENSE that is included with this distribution.
+\*************************************************************************/
+
+//
+// benchClient.h
+//
+// the client side of the loopback benchmark
+//
+// A minimal CA client which speaks the same wire protocol as
+// casStrmClient and casDGClient, so that the time measured is
+// spent in the server and in the network stack rather than in
+// the CA client library. Each object is used by one thread.
+//
+
+#ifndef benchClienth
+#define benchClienth
+
+#include "osiSock.h"
+#include "caHdrLargeArray.h"
+
+class benchClient {
+public:
+    benchClient ();
+    ~benchClient ();
+    bool connect ( const osiSockAddr & server );
+    bool createChannel ( const char * pName, ca_uint32_t & sid );
+    bool readNotify ( ca_uint32_t sid, unsigned dbrType, unsigned count );
+    bool subscribe ( ca_uint32_t sid, unsigned dbrType, unsigned count );
+    //
+    // Returns the number of subscription updates received, or -1 if
+    // the connection was lost. Waits at most the delay specified if
+    // nothing has arrived.
+    //
+    int receiveUpdates ( double delay );
+    unsigned long bytesReceived () const;
+private:
+    SOCKET sock;
+    char * pBuf;
+    unsigned bufSize;
+    unsigned bufBegin;
+    unsigned bufEnd;
+    unsigned long nBytesIn;
+    ca_uint32_t nextId;
+    bool send ( unsigned cmmd, unsigned dataType, unsigned count,
+        ca_uint32_t cid, ca_uint32_t available,
+        const void * pPayload, unsigned payloadSize );
+    int fill ( double delay );
+    bool nextMessage ( caHdr & hdr );
+    bool waitFor ( unsigned cmmd, caHdr & hdr );
+    benchClient ( const benchClient & );
+    benchClient & operator = ( const benchClient & );
+};
+
+inline unsigned long benchClient::bytesReceived () const
+{
+    return this->nBytesIn;
+}
+
+//
+// UDP name resolution requests
+//
+class benchSearchClient {
+public:
+    benchSearchClient ();
+    ~benchSearchClient ();
+    bool open ();
+    //
+    // Sends one datagram with a request for each of the names, and
+    // returns the number of replies received before the delay
+    // expires. The TCP port of the server is returned in tcpPort.
+    //
+    int search ( const osiSockAddr & server, const char * const * pNames,
+        unsigned nNames, double delay, unsigned short & tcpPort );
+private:
+    SOCKET sock;
+    char * pBuf;
+    ca_uint32_t nextId;
+    benchSearchClient ( const benchSearchClient & );
+    benchSearchClient & operator = ( const benchSearchClient & );
+};
+
+#endif // benchClienth
@@ -0,0 +1,378 @@
+/*************************************************************************\
+* Copyright (c) 2002 The University of Chicago, as Operator of Argonne
+*     National Laboratory.
+* Copyright (c) 2002 The Regents of the University of California, as
+*     Operator of Los Alamos National Laboratory.
+* EPICS BASE is distributed subject to a Software License Agreement found
+* in file LICENSE that is included with this distribution.
+\*************************************************************************/
+
+//
+// benchMain.cc
+//
+// Loopback throughput benchmark of the portable CA server. The server
+// runs in one thread of this process, and each synthetic client in
+// another. Monitor update rate, read latency, and search rate are
+// reported for each combination of client count, element count, and
+// DBR type.
+//
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "epicsThread.h"
+#include "epicsEvent.h"
+#include "envDefs.h"
+#include "fdManager.h"
+#include "errlog.h"
+#include "db_access.h"
+
+#include "benchServer.h"
+#include "benchClient.h"
+
+static const char * const benchPrefix = "casBench:";
+static const unsigned benchMaxSizes = 8u;
+static const unsigned benchMaxClients = 256u;
+static const unsigned benchMaxLatencies = 100000u;
+static const unsigned benchSearchBatch = 32u;
+static const unsigned benchTypes[] = {
+    DBR_DOUBLE, DBR_TIME_DOUBLE, DBR_CTRL_DOUBLE, DBR_STRING
+};
+
+struct benchServerArgs {
+    const aitIndex * pNElem;
+    unsigned nSizes;
+    double scanPeriod;
+    epicsEvent ready;
+    epicsEvent done;
+    volatile bool exit;
+    bool ok;
+};
+
+//
+// the server's file descriptor manager is only used by this thread
+//
+extern "C" void benchServerThread ( void * pArg )
+{
+    benchServerArgs & args = * static_cast < benchServerArgs * > ( pArg );
+    benchServer * pCAS = 0;
+    try {
+        pCAS = new benchServer ( benchPrefix, args.pNElem,
+            args.nSizes, args.scanPeriod );
+    }
+    catch ( ... ) {
+        errlogPrintf ( "casBench: unable to create the server\n" );
+    }
+    args.ok = pCAS != 0;
+    args.ready.signal ();
+    if ( pCAS ) {
+        while ( ! args.exit ) {
+            fileDescriptorManager.process ( 0.01 );
+        }
+        delete pCAS;
+    }
+    args.done.signal ();
+}
+
+struct benchClientArgs {
+    osiSockAddr server;
+    char pvName[64];
+    unsigned dbrType;
+    unsigned count;
+    bool monitor;
+    volatile bool * pStop;
+    epicsEvent done;
+    bool ok;
+    double elapsed;
+    unsigned long nOps;
+    unsigned long nBytes;
+    double * pLatency;
+    unsigned nLatency;
+};
+
+extern "C" void benchClientThread ( void * pArg )
+{
+    benchClientArgs & args = * static_cast < benchClientArgs * > ( pArg );
+    benchClient client;
+    ca_uint32_t sid = 0u;
+    args.ok = client.connect ( args.server ) &&
+        client.createChannel ( args.pvName, sid );
+    if ( args.ok && args.monitor ) {
+        args.ok = client.subscribe ( sid, args.dbrType, args.count );
+    }
+
+    epicsTime begin = epicsTime::getCurrent ();
+    while ( args.ok && ! *args.pStop ) {
+        if ( args.monitor ) {
+            int nUpdates = client.receiveUpdates ( 0.1 );
+            if ( nUpdates < 0 ) {
+                args.ok = false;
+            }
+            else {
+                args.nOps += static_cast < unsigned > ( nUpdates );
+            }
+        }
+        else {
+            epicsTime issued = epicsTime::getCurrent ();
+            args.ok = client.readNotify ( sid, args.dbrType, args.count );
+            if ( args.nLatency < benchMaxLatencies ) {
+                args.pLatency[args.nLatency++] =
+                    epicsTime::getCurrent () - issued;
+            }
+            args.nOps++;
+        }
+    }
+    args.elapsed = epicsTime::getCurrent () - begin;
+    args.nBytes = client.bytesReceived ();
+    args.done.signal ();
+}
+
+extern "C" int benchCompareDouble ( const void * pA, const void * pB )
+{
+    double a = * static_cast < const double * > ( pA );
+    double b = * static_cast < const double * > ( pB );
+    return a < b ? -1 : ( a > b ? 1 : 0 );
+}
+
+static double benchPercentile ( const double * pSorted,
+    unsigned n, double fraction )
+{
+    if ( n == 0u ) {
+        return 0.0;
+    }
+    unsigned index = static_cast < unsigned > ( fraction * ( n - 1u ) + 0.5 );
+    return pSorted[index];
+}
+
+//
+// runs nClients clients for the duration and prints one line
+//
+static void benchRun ( const osiSockAddr & server, const char * pPVName,
+    unsigned nClients, unsigned nElem, unsigned dbrType, bool monitor,
+    double duration )
+{
+    benchClientArgs * pArgs = new benchClientArgs [ nClients ];
+    double * pLatency = 0;
+    if ( ! monitor ) {
+        pLatency = new double [ nClients * benchMaxLatencies ];
+    }
+    volatile bool stop = false;
+    for ( unsigned i = 0u; i < nClients; i++ ) {
+        benchClientArgs & args = pArgs[i];
+        args.server = server;
+        strncpy ( args.pvName, pPVName, sizeof ( args.pvName ) - 1u );
+        args.pvName[sizeof ( args.pvName ) - 1u] = '\0';
+        args.dbrType = dbrType;
+        args.count = nElem;
+        args.monitor = monitor;
+        args.pStop = & stop;
+        args.ok = false;
+        args.elapsed = 0.0;
+        args.nOps = 0u;
+        args.nBytes = 0u;
+        args.pLatency = pLatency ? pLatency + i * benchMaxLatencies : 0;
+        args.nLatency = 0u;
+        epicsThreadCreate ( "casBenchClient", epicsThreadPriorityMedium,
+            epicsThreadGetStackSize ( epicsThreadStackMedium ),
+            benchClientThread, & args );
+    }
+    epicsThreadSleep ( duration );
+    stop = true;
+
+    unsigned nFailed = 0u;
+    double opsPerSec = 0.0;
+    double bytesPerSec = 0.0;
+    unsigned nLatency = 0u;
+    for ( unsigned i = 0u; i < nClients; i++ ) {
+        benchClientArgs & args = pArgs[i];
+        args.done.wait ();
+        if ( ! args.ok ) {
+            nFailed++;
+        }
+        if ( args.elapsed > 0.0 ) {
+            opsPerSec += args.nOps / args.elapsed;
+            bytesPerSec += args.nBytes / args.elapsed;
+        }
+        // pack the latencies of all of the clients together
+        if ( pLatency ) {
+            memmove ( pLatency + nLatency, args.pLatency,
+                args.nLatency * sizeof ( double ) );
+            nLatency += args.nLatency;
+        }
+    }
+
+    printf ( "%-8s %7u %8u %-16s %12.1f %12.0f",
+        monitor ? "monitor" : "read", nClients, nElem, dbr_text[dbrType],
+        opsPerSec, bytesPerSec );
+    if ( pLatency ) {
+        qsort ( pLatency, nLatency, sizeof ( double ), benchCompareDouble );
+        printf ( " %8.1f %8.1f %8.1f %8.1f",
+            benchPercentile ( pLatency, nLatency, 0.5 ) * 1e6,
+            benchPercentile ( pLatency, nLatency, 0.9 ) * 1e6,
+            benchPercentile ( pLatency, nLatency, 0.99 ) * 1e6,
+            benchPercentile ( pLatency, nLatency, 1.0 ) * 1e6 );
+    }
+    if ( nFailed ) {
+        printf ( " (%u clients failed)", nFailed );
+    }
+    printf ( "\n" );
+
+    delete [] pLatency;
+    delete [] pArgs;
+}
+
+//
+// returns false if the server doesnt answer
+//
+static bool benchSearch ( const osiSockAddr & server,
+    const char * const * pNames, unsigned nNames, double duration,
+    unsigned short & tcpPort )
+{
+    benchSearchClient client;
+    if ( ! client.open () ) {
+        return false;
+    }
+
+    const char * batch[benchSearchBatch];
+    for ( unsigned i = 0u; i < benchSearchBatch; i++ ) {
+        batch[i] = pNames[i % nNames];
+    }
+
+    unsigned long nReplies = 0u;
+    epicsTime begin = epicsTime::getCurrent ();
+    double elapsed = 0.0;
+    while ( elapsed < duration ) {
+        int status = client.search ( server, batch,
+            benchSearchBatch, 1.0, tcpPort );
+        if ( status <= 0 ) {
+            return false;
+        }
+        nReplies += static_cast < unsigned > ( status );
+        elapsed = epicsTime::getCurrent () - begin;
+    }
+    printf ( "%-8s %7u %8s %-16s %12.1f\n", "search", 1u, "-", "-",
+        nReplies / elapsed );
+    return true;
+}
+
+extern int main ( int argc, const char ** argv )
+{
+    double duration = 1.0;
+    double scanRate = 0.0;
+    unsigned maxClients = 16u;
+    unsigned maxElem = 1000u;
+    unsigned port = 15064u;
+
+    for ( int i = 1; i < argc; i++ ) {
+        if ( sscanf ( argv[i], "-t %lf", & duration ) == 1 ) {
+            continue;
+        }
+        if ( sscanf ( argv[i], "-r %lf", & scanRate ) == 1 ) {
+            continue;
+        }
+        if ( sscanf ( argv[i], "-c %u", & maxClients ) == 1 ) {
+            continue;
+        }
+        if ( sscanf ( argv[i], "-e %u", & maxElem ) == 1 ) {
+            continue;
+        }
+        if ( sscanf ( argv[i], "-p %u", & port ) == 1 ) {
+            continue;
+        }
+        fprintf ( stderr,
+"usage: %s [-t<seconds per measurement> -r<update rate, 0 for unpaced> "
+"-c<max clients> -e<max elements> -p<UDP port>]\n", argv[0] );
+        return 1;
+    }
+    if ( maxClients > benchMaxClients ) {
+        maxClients = benchMaxClients;
+    }
+    if ( maxElem == 0u ) {
+        maxElem = 1u;
+    }
+
+    // element counts in powers of ten
+    aitIndex nElem[benchMaxSizes];
+    unsigned nSizes = 0u;
+    for ( aitIndex n = 1u; n <= maxElem && nSizes < benchMaxSizes; n *= 10u ) {
+        nElem[nSizes++] = n;
+    }
+
+    //
+    // The server only listens on the loopback interface, and uses a
+    // port of its own so that the clients dont find other servers.
+    // The largest response is an array of strings.
+    //
+    char buf[64];
+    sprintf ( buf, "%u", port );
+    epicsEnvSet ( "EPICS_CAS_SERVER_PORT", buf );
+    epicsEnvSet ( "EPICS_CAS_INTF_ADDR_LIST", "127.0.0.1" );
+    epicsEnvSet ( "EPICS_CAS_BEACON_ADDR_LIST", "127.0.0.1" );
+    epicsEnvSet ( "EPICS_CAS_AUTO_BEACON_ADDR_LIST", "NO" );
+    sprintf ( buf, "%u", dbr_size_n ( DBR_STRING, maxElem ) + 1024u );
+    epicsEnvSet ( "EPICS_CA_MAX_ARRAY_BYTES", buf );
+
+    benchServerArgs serverArgs;
+    serverArgs.pNElem = nElem;
+    serverArgs.nSizes = nSizes;
+    // when unpaced the scan timer expires each time that the server
+    // polls its sockets (a timer restarted with no delay would expire
+    // again before the server returned to its sockets)
+    serverArgs.scanPeriod = scanRate > 0.0 ? 1.0 / scanRate : 1e-6;
+    serverArgs.exit = false;
+    serverArgs.ok = false;
+    epicsThreadCreate ( "casBenchServer", epicsThreadPriorityMedium,
+        epicsThreadGetStackSize ( epicsThreadStackBig ),
+        benchServerThread, & serverArgs );
+    serverArgs.ready.wait ();
+    if ( ! serverArgs.ok ) {
+        return 1;
+    }
+
+    char names[benchMaxSizes][64];
+    const char * pNames[benchMaxSizes];
+    for ( unsigned i = 0u; i < nSizes; i++ ) {
+        sprintf ( names[i], "%s%u", benchPrefix,
+            static_cast < unsigned > ( nElem[i] ) );
+        pNames[i] = names[i];
+    }
+
+    osiSockAddr server;
+    memset ( & server, '\0', sizeof ( server ) );
+    server.ia.sin_family = AF_INET;
+    server.ia.sin_addr.s_addr = htonl ( INADDR_LOOPBACK );
+    server.ia.sin_port = htons ( static_cast < unsigned short > ( port ) );
+
+    printf ( "casBench: %.1f S per measurement, %s update rate\n",
+        duration, scanRate > 0.0 ? "paced" : "unpaced" );
+    printf ( "%-8s %7s %8s %-16s %12s %12s %8s %8s %8s %8s\n",
+        "test", "clients", "elements", "type", "per sec",
+        "bytes/sec", "p50 uS", "p90 uS", "p99 uS", "max uS" );
+
+    // the search replies also supply the server's TCP port
+    unsigned short tcpPort = 0u;
+    int status = 0;
+    if ( benchSearch ( server, pNames, nSizes, duration, tcpPort ) ) {
+        server.ia.sin_port = htons ( tcpPort );
+        for ( unsigned nClients = 1u; nClients <= maxClients; nClients *= 4u ) {
+            for ( unsigned i = 0u; i < nSizes; i++ ) {
+                for ( unsigned j = 0u; j < sizeof ( benchTypes ) / 
+                        sizeof ( benchTypes[0] ); j++ ) {
+                    benchRun ( server, pNames[i], nClients, nElem[i],
+                        benchTypes[j], true, duration );
+                    benchRun ( server, pNames[i], nClients, nElem[i],
+                        benchTypes[j], false, duration );
+                }
+            }
+        }
+    }
+    else {
+        fprintf ( stderr, "casBench: no reply to search requests\n" );
+        status = 1;
+    }
+
+    serverArgs.exit = true;
+    serverArgs.done.wait ();
+    return status;
+}
@@ -0,0 +1,177 @@
+/*************************************************************************\
+* Copyright (c) 2002 The University of Chicago, as Operator of Argonne
+*     National Laboratory.
+* Copyright (c) 2002 The Regents of the University of California, as
+*     Operator of Los Alamos National Laboratory.
+* EPICS BASE is distributed subject to a Software License Agreement found
+* in file LICENSE that is included with this distribution.
+\*************************************************************************/
+
+#include <stdio.h>
+#include <string.h>
+
+#include "fdManager.h"
+#include "gddApps.h"
+#include "gddAppTable.h"
+
+#include "benchServer.h"
+
+benchPV::benchPV ( benchServer & casIn, const char * pNameIn,
+        aitIndex nElemIn ) :
+    pNext ( 0 ), cas ( casIn ), pName ( new char [ strlen ( pNameIn ) + 1u ] ),
+    nElem ( nElemIn ), pBuf ( new aitFloat64 [ nElemIn ] ), pValue ( 0 ),
+    nUpdate ( 0u ), interest ( false )
+{
+    strcpy ( this->pName, pNameIn );
+    this->update ();
+}
+
+benchPV::~benchPV ()
+{
+    delete [] this->pName;
+    delete [] this->pBuf;
+}
+
+//
+// A new gdd is posted each time, so that the gdd referenced by
+// the event queue of a client is never modified.
+//
+void benchPV::update ()
+{
+    this->nUpdate++;
+    for ( aitIndex i = 0u; i < this->nElem; i++ ) {
+        this->pBuf[i] = this->nUpdate + i;
+    }
+
+    gdd * pDD;
+    if ( this->nElem == 1u ) {
+        pDD = new gddScalar ( gddAppType_value, aitEnumFloat64 );
+    }
+    else {
+        pDD = new gddAtomic ( gddAppType_value, aitEnumFloat64,
+            1u, this->nElem );
+    }
+    pDD->put ( this->pBuf );
+    aitTimeStamp ts = epicsTime::getCurrent ();
+    pDD->setTimeStamp ( & ts );
+    pDD->setStatSevr ( 0, 0 );
+    this->pValue = pDD;
+    pDD->unreference ();
+
+    if ( this->interest ) {
+        casEventMask select ( this->cas.valueEventMask () |
+            this->cas.logEventMask () );
+        this->postEvent ( select, *this->pValue );
+    }
+}
+
+const char * benchPV::getName () const
+{
+    return this->pName;
+}
+
+aitEnum benchPV::bestExternalType () const
+{
+    return aitEnumFloat64;
+}
+
+unsigned benchPV::maxDimension () const
+{
+    return this->nElem > 1u ? 1u : 0u;
+}
+
+aitIndex benchPV::maxBound ( unsigned dimension ) const
+{
+    return dimension == 0u ? this->nElem : 1u;
+}
+
+caStatus benchPV::interestRegister ()
+{
+    this->interest = true;
+    return S_casApp_success;
+}
+
+void benchPV::interestDelete ()
+{
+    this->interest = false;
+}
+
+caStatus benchPV::read ( const casCtx &, gdd & prototype )
+{
+    gddStatus status = gddApplicationTypeTable::app_table.smartCopy (
+        & prototype, this->pValue.get () );
+    return status ? S_cas_noConvert : S_casApp_success;
+}
+
+//
+// the PVs are deleted by the server
+//
+void benchPV::destroy ()
+{
+}
+
+benchServer::benchServer ( const char * pPrefix, const aitIndex * pNElem,
+        unsigned nSizes, double scanPeriodIn ) :
+    pPVList ( 0 ), timer ( fileDescriptorManager.createTimer () ),
+    scanPeriod ( scanPeriodIn )
+{
+    for ( unsigned i = 0u; i < nSizes; i++ ) {
+        char name[128];
+        sprintf ( name, "%.100s%u", pPrefix,
+            static_cast < unsigned > ( pNElem[i] ) );
+        benchPV * pPV = new benchPV ( *this, name, pNElem[i] );
+        pPV->pNext = this->pPVList;
+        this->pPVList = pPV;
+    }
+    this->timer.start ( *this, this->scanPeriod );
+}
+
+benchServer::~benchServer ()
+{
+    this->timer.destroy ();
+    while ( benchPV * pPV = this->pPVList ) {
+        this->pPVList = pPV->pNext;
+        delete pPV;
+    }
+}
+
+benchPV * benchServer::find ( const char * pPVName )
+{
+    for ( benchPV * pPV = this->pPVList; pPV; pPV = pPV->pNext ) {
+        if ( strcmp ( pPV->getName (), pPVName ) == 0 ) {
+            return pPV;
+        }
+    }
+    return 0;
+}
+
+pvExistReturn benchServer::pvExistTest ( const casCtx &,
+        const caNetAddr &, const char * pPVName )
+{
+    if ( this->find ( pPVName ) ) {
+        return pverExistsHere;
+    }
+    return pverDoesNotExistHere;
+}
+
+pvAttachReturn benchServer::pvAttach ( const casCtx &, const char * pPVName )
+{
+    benchPV * pPV = this->find ( pPVName );
+    if ( pPV ) {
+        return *pPV;
+    }
+    return S_casApp_pvNotFound;
+}
+
+//
+// posts to the PVs with subscribers in the server's thread
+//
+epicsTimerNotify::expireStatus benchServer::expire ( const epicsTime & )
+{
+    for ( benchPV * pPV = this->pPVList; pPV; pPV = pPV->pNext ) {
+        if ( pPV->interested () ) {
+            pPV->update ();
+        }
+    }
+    return expireStatus ( restart, this->scanPeriod );
+}
@@ -0,0 +1,79 @@
+/*************************************************************************\
+* Copyright (c) 2002 The University of Chicago, as Operator of Argonne
+*     National Laboratory.
+* Copyright (c) 2002 The Regents of the University of California, as
+*     Operator of Los Alamos National Laboratory.
+* EPICS BASE is distributed subject to a Software License Agreement found
+* in file LICENSE that is included with this distribution.
+\*************************************************************************/
+
+//
+// benchServer.h
+//
+// the server side of the loopback benchmark
+//
+// The server has one aitFloat64 PV for each array size in the sweep,
+// named "<prefix><element count>". While a PV has subscribers a new
+// value is posted to it each time that the scan timer expires.
+//
+
+#ifndef benchServerh
+#define benchServerh
+
+#include "casdef.h"
+#include "epicsTimer.h"
+#include "smartGDDPointer.h"
+
+class benchServer;
+
+class benchPV : public casPV {
+public:
+    benchPV ( benchServer &, const char * pName, aitIndex nElem );
+    ~benchPV ();
+    void update ();
+    bool interested () const;
+    const char * getName () const;
+    aitEnum bestExternalType () const;
+    unsigned maxDimension () const;
+    aitIndex maxBound ( unsigned dimension ) const;
+    caStatus interestRegister ();
+    void interestDelete ();
+    caStatus read ( const casCtx &, gdd & prototype );
+    void destroy ();
+    benchPV * pNext;
+private:
+    benchServer & cas;
+    char * pName;
+    aitIndex nElem;
+    aitFloat64 * pBuf;
+    smartGDDPointer pValue;
+    unsigned nUpdate;
+    bool interest;
+    benchPV ( const benchPV & );
+    benchPV & operator = ( const benchPV & );
+};
+
+class benchServer : public caServer, public epicsTimerNotify {
+public:
+    benchServer ( const char * pPrefix, const aitIndex * pNElem,
+        unsigned nSizes, double scanPeriod );
+    ~benchServer ();
+    pvExistReturn pvExistTest ( const casCtx &,
+        const caNetAddr &, const char * pPVName );
+    pvAttachReturn pvAttach ( const casCtx &, const char * pPVName );
+private:
+    benchPV * pPVList;
+    epicsTimer & timer;
+    double scanPeriod;
+    benchPV * find ( const char * pPVName );
+    expireStatus expire ( const epicsTime & currentTime );
+    benchServer ( const benchServer & );
+    benchServer & operator = ( const benchServer & );
+};
+
+inline bool benchPV::interested () const
+{
+    return this->interest;
+}
+
+#endif // benchServerh
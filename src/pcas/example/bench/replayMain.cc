@@ -0,0 +1,392 @@
+/*************************************************************************\
+* Copyright (c) 2002 The University of Chicago, as Operator of Argonne
+*     National Laboratory.
+* Copyright (c) 2002 The Regents of the University of California, as
+*     Operator of Los Alamos National Laboratory.
+* EPICS BASE is distributed subject to a Software License Agreement found
+* in file LICENSE that is included with this distribution.
+\*************************************************************************/
+
+//
+// replayMain.cc
+//
+// Sends the requests in a capture file written by caServer::startCapture()
+// to a server, at the original pace, a multiple of it, or as fast as
+// possible. Each captured TCP circuit is replayed on a circuit of its
+// own, and the replies are read and discarded. The server should have
+// the same PVs as the one captured, so that it assigns the same ids to
+// the channels that the recorded requests refer to.
+//
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "epicsTime.h"
+#include "osiSock.h"
+#include "errlog.h"
+
+#include "casTrafficCapture.h"
+
+static const unsigned replayMaxCircuits = 512u;
+static const unsigned replayDrainBufSize = 0x10000;
+
+struct replayCircuit {
+    unsigned id;
+    SOCKET sock;
+};
+
+class replay {
+public:
+    replay ( const osiSockAddr & tcpServer, const osiSockAddr & udpServer );
+    ~replay ();
+    bool open ();
+    void connect ( unsigned id );
+    void stream ( unsigned id, const char * pBuf, unsigned nBytes );
+    void disconnect ( unsigned id );
+    void datagram ( const char * pBuf, unsigned nBytes );
+    //
+    // Reads and discards the replies until the delay expires, or
+    // until the socket specified (if any) can be written.
+    //
+    bool drain ( double delay, SOCKET writer = INVALID_SOCKET );
+    void report ( double elapsed, double maxLate ) const;
+private:
+    replayCircuit circuit[replayMaxCircuits];
+    osiSockAddr tcpServer;
+    osiSockAddr udpServer;
+    SOCKET udpSock;
+    char * pDrainBuf;
+    unsigned nCircuits;
+    unsigned nFailed;
+    unsigned long nBytesOut;
+    unsigned long nBytesIn;
+    replayCircuit * find ( unsigned id );
+    void close ( replayCircuit & );
+    replay ( const replay & );
+    replay & operator = ( const replay & );
+};
+
+replay::replay ( const osiSockAddr & tcpServerIn,
+        const osiSockAddr & udpServerIn ) :
+    tcpServer ( tcpServerIn ), udpServer ( udpServerIn ),
+    udpSock ( INVALID_SOCKET ), pDrainBuf ( new char [ replayDrainBufSize ] ),
+    nCircuits ( 0u ), nFailed ( 0u ), nBytesOut ( 0u ), nBytesIn ( 0u )
+{
+    for ( unsigned i = 0u; i < replayMaxCircuits; i++ ) {
+        this->circuit[i].id = 0u;
+        this->circuit[i].sock = INVALID_SOCKET;
+    }
+}
+
+replay::~replay ()
+{
+    for ( unsigned i = 0u; i < replayMaxCircuits; i++ ) {
+        this->close ( this->circuit[i] );
+    }
+    if ( this->udpSock != INVALID_SOCKET ) {
+        epicsSocketDestroy ( this->udpSock );
+    }
+    delete [] this->pDrainBuf;
+}
+
+bool replay::open ()
+{
+    this->udpSock = epicsSocketCreate ( AF_INET, SOCK_DGRAM, IPPROTO_UDP );
+    return this->udpSock != INVALID_SOCKET;
+}
+
+replayCircuit * replay::find ( unsigned id )
+{
+    for ( unsigned i = 0u; i < replayMaxCircuits; i++ ) {
+        if ( this->circuit[i].id == id ) {
+            return & this->circuit[i];
+        }
+    }
+    return 0;
+}
+
+void replay::close ( replayCircuit & c )
+{
+    if ( c.sock != INVALID_SOCKET ) {
+        epicsSocketDestroy ( c.sock );
+    }
+    c.id = 0u;
+    c.sock = INVALID_SOCKET;
+}
+
+//
+// the circuits which were open when the capture started are
+// ignored, as are those beyond the limit
+//
+void replay::connect ( unsigned id )
+{
+    replayCircuit * pCircuit = this->find ( 0u );
+    if ( ! pCircuit ) {
+        this->nFailed++;
+        return;
+    }
+    SOCKET sock = epicsSocketCreate ( AF_INET, SOCK_STREAM, IPPROTO_TCP );
+    if ( sock == INVALID_SOCKET ) {
+        this->nFailed++;
+        return;
+    }
+    int flag = 1;
+    setsockopt ( sock, IPPROTO_TCP, TCP_NODELAY,
+        reinterpret_cast < char * > ( & flag ), sizeof ( flag ) );
+    if ( ::connect ( sock, & this->tcpServer.sa,
+            sizeof ( this->tcpServer.ia ) ) < 0 ) {
+        epicsSocketDestroy ( sock );
+        this->nFailed++;
+        return;
+    }
+    pCircuit->id = id;
+    pCircuit->sock = sock;
+    this->nCircuits++;
+}
+
+void replay::stream ( unsigned id, const char * pBuf, unsigned nBytes )
+{
+    replayCircuit * pCircuit = id ? this->find ( id ) : 0;
+    unsigned sent = 0u;
+    while ( pCircuit && sent < nBytes ) {
+        if ( ! this->drain ( 1.0, pCircuit->sock ) ) {
+            continue;
+        }
+        int status = ::send ( pCircuit->sock, pBuf + sent, nBytes - sent, 0 );
+        if ( status <= 0 ) {
+            this->close ( *pCircuit );
+            this->nFailed++;
+            return;
+        }
+        sent += static_cast < unsigned > ( status );
+    }
+    this->nBytesOut += sent;
+}
+
+void replay::disconnect ( unsigned id )
+{
+    replayCircuit * pCircuit = id ? this->find ( id ) : 0;
+    if ( pCircuit ) {
+        this->close ( *pCircuit );
+    }
+}
+
+void replay::datagram ( const char * pBuf, unsigned nBytes )
+{
+    int status = sendto ( this->udpSock, pBuf, nBytes, 0,
+        & this->udpServer.sa, sizeof ( this->udpServer.ia ) );
+    if ( status > 0 ) {
+        this->nBytesOut += nBytes;
+    }
+}
+
+bool replay::drain ( double delay, SOCKET writer )
+{
+    fd_set readable, writable;
+    FD_ZERO ( & readable );
+    FD_ZERO ( & writable );
+    SOCKET maxSock = this->udpSock;
+    FD_SET ( this->udpSock, & readable );
+    for ( unsigned i = 0u; i < replayMaxCircuits; i++ ) {
+        SOCKET sock = this->circuit[i].sock;
+        if ( sock != INVALID_SOCKET ) {
+            FD_SET ( sock, & readable );
+            if ( sock > maxSock ) {
+                maxSock = sock;
+            }
+        }
+    }
+    if ( writer != INVALID_SOCKET ) {
+        FD_SET ( writer, & writable );
+    }
+    struct timeval tv;
+    tv.tv_sec = static_cast < long > ( delay );
+    tv.tv_usec = static_cast < long > ( ( delay - tv.tv_sec ) * 1e6 );
+    int status = select ( static_cast < int > ( maxSock ) + 1,
+        & readable, & writable, 0, & tv );
+    if ( status <= 0 ) {
+        return false;
+    }
+    if ( FD_ISSET ( this->udpSock, & readable ) ) {
+        int nBytes = recv ( this->udpSock, this->pDrainBuf,
+            replayDrainBufSize, 0 );
+        if ( nBytes > 0 ) {
+            this->nBytesIn += static_cast < unsigned > ( nBytes );
+        }
+    }
+    for ( unsigned i = 0u; i < replayMaxCircuits; i++ ) {
+        replayCircuit & c = this->circuit[i];
+        if ( c.sock == INVALID_SOCKET ||
+                ! FD_ISSET ( c.sock, & readable ) ) {
+            continue;
+        }
+        int nBytes = recv ( c.sock, this->pDrainBuf,
+            replayDrainBufSize, 0 );
+        if ( nBytes > 0 ) {
+            this->nBytesIn += static_cast < unsigned > ( nBytes );
+        }
+        else if ( c.sock != writer ) {
+            // disconnected by the server
+            this->close ( c );
+            this->nFailed++;
+        }
+    }
+    return writer != INVALID_SOCKET && FD_ISSET ( writer, & writable );
+}
+
+void replay::report ( double elapsed, double maxLate ) const
+{
+    printf ( "casReplay: %u circuits, %lu bytes out, %lu bytes in, "
+        "%.3f S, at most %.3f S behind\n", this->nCircuits,
+        this->nBytesOut, this->nBytesIn, elapsed, maxLate );
+    if ( this->nFailed ) {
+        printf ( "casReplay: %u circuits failed\n", this->nFailed );
+    }
+}
+
+static bool replayAddr ( const char * pAddr, unsigned short port,
+    osiSockAddr & addr )
+{
+    memset ( & addr, '\0', sizeof ( addr ) );
+    return aToIPAddr ( pAddr, port, & addr.ia ) == 0;
+}
+
+extern int main ( int argc, const char ** argv )
+{
+    double speed = 1.0;
+    unsigned tcpPort = 5064u;
+    unsigned udpPort = 5064u;
+    char server[64] = "127.0.0.1";
+    const char * pFileName = 0;
+
+    for ( int i = 1; i < argc; i++ ) {
+        if ( sscanf ( argv[i], "-s %lf", & speed ) == 1 ) {
+            continue;
+        }
+        if ( sscanf ( argv[i], "-p %u", & tcpPort ) == 1 ) {
+            continue;
+        }
+        if ( sscanf ( argv[i], "-u %u", & udpPort ) == 1 ) {
+            continue;
+        }
+        if ( sscanf ( argv[i], "-a %63s", server ) == 1 ) {
+            continue;
+        }
+        if ( argv[i][0] != '-' && ! pFileName ) {
+            pFileName = argv[i];
+            continue;
+        }
+        pFileName = 0;
+        break;
+    }
+    if ( ! pFileName ) {
+        fprintf ( stderr,
+"usage: %s [-s<speed, 0 for unpaced> -a<server address> "
+"-p<server TCP port> -u<server UDP port>] <capture file>\n", argv[0] );
+        return 1;
+    }
+
+    FILE * pFile = fopen ( pFileName, "rb" );
+    if ( ! pFile ) {
+        fprintf ( stderr, "casReplay: unable to open \"%s\"\n", pFileName );
+        return 1;
+    }
+    char magic[8];
+    if ( fread ( magic, sizeof ( magic ), 1u, pFile ) != 1u ||
+            memcmp ( magic, casCaptureMagic, sizeof ( magic ) ) != 0 ) {
+        fprintf ( stderr, "casReplay: \"%s\" isnt a capture file\n",
+            pFileName );
+        fclose ( pFile );
+        return 1;
+    }
+
+    osiSockAttach ();
+    osiSockAddr tcpServer, udpServer;
+    if ( ! replayAddr ( server, static_cast < unsigned short > ( tcpPort ),
+                tcpServer ) ||
+            ! replayAddr ( server, static_cast < unsigned short > ( udpPort ),
+                udpServer ) ) {
+        fprintf ( stderr, "casReplay: bad server address \"%s\"\n", server );
+        fclose ( pFile );
+        return 1;
+    }
+
+    replay rp ( tcpServer, udpServer );
+    if ( ! rp.open () ) {
+        fprintf ( stderr, "casReplay: unable to create a UDP socket\n" );
+        fclose ( pFile );
+        return 1;
+    }
+
+    unsigned bufSize = 0x10000;
+    char * pBuf = new char [ bufSize ];
+    epicsTime begin = epicsTime::getCurrent ();
+    epicsTime firstRecord;
+    bool first = true;
+    double maxLate = 0.0;
+    int status = 0;
+    casCaptureHeader hdr;
+    while ( fread ( & hdr, sizeof ( hdr ), 1u, pFile ) == 1u ) {
+        unsigned nBytes = ntohl ( hdr.nBytes );
+        if ( nBytes > bufSize ) {
+            delete [] pBuf;
+            bufSize = nBytes;
+            pBuf = new char [ bufSize ];
+        }
+        if ( nBytes && fread ( pBuf, nBytes, 1u, pFile ) != 1u ) {
+            fprintf ( stderr, "casReplay: \"%s\" is truncated\n", pFileName );
+            status = 1;
+            break;
+        }
+
+        epicsTimeStamp ts;
+        ts.secPastEpoch = ntohl ( hdr.secPastEpoch );
+        ts.nsec = ntohl ( hdr.nSec );
+        epicsTime received = ts;
+        if ( first ) {
+            firstRecord = received;
+            first = false;
+        }
+        if ( speed > 0.0 ) {
+            double due = ( received - firstRecord ) / speed;
+            double late = ( epicsTime::getCurrent () - begin ) - due;
+            while ( late < 0.0 ) {
+                rp.drain ( -late );
+                late = ( epicsTime::getCurrent () - begin ) - due;
+            }
+            if ( late > maxLate ) {
+                maxLate = late;
+            }
+        }
+        else {
+            rp.drain ( 0.0 );
+        }
+
+        unsigned circuit = ntohl ( hdr.circuit );
+        switch ( hdr.type ) {
+        case casCaptureConnect:
+            rp.connect ( circuit );
+            break;
+        case casCaptureStream:
+            rp.stream ( circuit, pBuf, nBytes );
+            break;
+        case casCaptureDisconnect:
+            rp.disconnect ( circuit );
+            break;
+        case casCaptureDatagram:
+            rp.datagram ( pBuf, nBytes );
+            break;
+        default:
+            break;
+        }
+    }
+
+    // collect the replies to the last requests
+    rp.drain ( 0.1 );
+    rp.report ( epicsTime::getCurrent () - begin, maxLate );
+
+    delete [] pBuf;
+    fclose ( pFile );
+    return status;
+}
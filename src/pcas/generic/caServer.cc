@@ -174,6 +174,80 @@ unsigned caServer::subscriptionEventsPosted () const
     }
 }
 
+void caServer::subscriptionLatency ( casLatencyHistogram & encode,
+    casLatencyHistogram & wire ) const
+{
+    encode.clear ();
+    wire.clear ();
+    if ( pCAS ) {
+        this->pCAS->subscriptionLatency ( encode, wire );
+    }
+}
+
+void caServer::clientLatency ( casClientLatencyVisitor & visitor ) const
+{
+    if ( pCAS ) {
+        this->pCAS->clientLatency ( visitor );
+    }
+}
+
+#ifdef CAS_DISPATCH_STATS
+void caServer::dispatchStatistics ( casDispatchStats & stream,
+    casDispatchStats & datagram ) const
+{
+    if ( pCAS ) {
+        this->pCAS->dispatchStatistics ( stream, datagram );
+    }
+}
+#endif
+
+caStatus caServer::publishStatistics ( 
+    const char * pPrefix, double updatePeriod )
+{
+    if ( pCAS ) {
+        return this->pCAS->publishStatistics ( pPrefix, updatePeriod );
+    }
+    return S_cas_noInterface;
+}
+
+caStatus caServer::setClientBudget ( const casClientBudget & budget )
+{
+    if ( pCAS ) {
+        return this->pCAS->setClientBudget ( budget );
+    }
+    return S_cas_noInterface;
+}
+
+casClientBudget caServer::clientBudget () const
+{
+    if ( pCAS ) {
+        return this->pCAS->clientBudget ();
+    }
+    return casClientBudget ();
+}
+
+void caServer::clientResources ( casClientResourceVisitor & visitor ) const
+{
+    if ( pCAS ) {
+        this->pCAS->clientResources ( visitor );
+    }
+}
+
+caStatus caServer::startCapture ( const char * pFileName )
+{
+    if ( pCAS ) {
+        return this->pCAS->startCapture ( pFileName );
+    }
+    return S_cas_noInterface;
+}
+
+void caServer::stopCapture ()
+{
+    if ( pCAS ) {
+        this->pCAS->stopCapture ();
+    }
+}
+
 void caServer::generateBeaconAnomaly ()
 {
     if ( pCAS ) {
@@ -14,6 +14,7 @@
  */
 
 #include <stdarg.h>
+#include <string.h>
 #include <stdexcept>
 
 #include <epicsGuard.h>
@@ -27,6 +28,8 @@
 #include "caServerI.h"
 #include "beaconTimer.h"
 #include "beaconAnomalyGovernor.h"
+#include "casServerStatistics.h"
+#include "casBudgetTimer.h"
 #include "casStreamOS.h"
 #include "casIntfOS.h"
 #include "casVersion.h"
@@ -40,10 +43,17 @@ caServerI::caServerI ( caServer & tool ) :
     adapter (tool),
     beaconTmr ( * new beaconTimer ( *this ) ),
     beaconAnomalyGov ( * new beaconAnomalyGovernor ( *this ) ),
+    pStatistics ( 0 ),
+    pBudgetTimer ( 0 ),
+    pCapture ( 0 ),
+    nCaptureCircuits ( 0u ),
+    captureGeneration ( 0u ),
     debugLevel ( 0u ),
     nEventsProcessed ( 0u ),
     nEventsPosted ( 0u ),
-    ioInProgressCount ( 0u )
+    ioInProgressCount ( 0u ),
+    retiredBytesSent ( 0u ),
+    retiredSearchRequests ( 0u )
 {
     assert ( & adapter != NULL );
 
@@ -68,12 +78,18 @@ caServerI::~caServerI()
 {
     delete & this->beaconAnomalyGov;
     delete & this->beaconTmr;
+    delete this->pBudgetTimer;
 
     // delete all clients
     while ( casStrmClient * pClient = this->clientList.get() ) {
         delete pClient;
     }
 
+    // after the clients so that the PVs have no channels
+    delete this->pStatistics;
+
+    delete this->pCapture;
+
     casIntfOS *pIF;
     while ( ( pIF = this->intfList.get() ) ) {
         delete pIF;
@@ -85,13 +101,20 @@ void caServerI::destroyClient ( casStrmClient & client )
     {
         epicsGuard < epicsMutex > locker ( this->mutex );
         this->clientList.remove ( client );
+        this->retiredBytesSent += client.bytesSent ();
+        this->retiredSearchRequests += client.searchRequests ();
+#ifdef CAS_DISPATCH_STATS
+        this->retiredDispatchStats.add ( client.dispatchStatistics () );
+#endif
     }
     delete & client;
 }
 
-void caServerI::connectCB ( casIntfOS & intf )
+void caServerI::connectCB ( casIntfOS & intf, bool local )
 {
-    casStreamOS * pClient = intf.newStreamClient ( *this, this->clientBufMemMgr );
+    casStreamOS * pClient = local ?
+        intf.newLocalStreamClient ( *this, this->clientBufMemMgr ) :
+        intf.newStreamClient ( *this, this->clientBufMemMgr );
     if ( pClient ) {
         {
             epicsGuard < epicsMutex > locker ( this->mutex );
@@ -120,6 +143,24 @@ void serverToolDebugFunc (const char *pFile, unsigned line, const char *pComment
                 line, pFile, pComment);
 }
 
+//
+// true if an interface of this server has bound 
+// the local socket name (see casLocalSocket.h)
+//
+bool caServerI::holdsLocalSocketName ( const char * pName ) const
+{
+    epicsGuard < epicsMutex > locker ( this->mutex );
+    tsDLIterConst < casIntfOS > iter = this->intfList.firstIter ();
+    while ( iter.valid () ) {
+        const char * pHeld = iter->localSocketName ();
+        if ( pHeld && strcmp ( pHeld, pName ) == 0 ) {
+            return true;
+        }
+        iter++;
+    }
+    return false;
+}
+
 caStatus caServerI::attachInterface ( const caNetAddr & addrIn, 
         bool autoBeaconAddr, bool addConfigBeaconAddr)
 {    
@@ -187,6 +228,255 @@ void caServerI::generateBeaconAnomaly ()
     this->beaconAnomalyGov.start ();
 }
 
+void caServerI::subscriptionLatency ( casLatencyHistogram & encode,
+    casLatencyHistogram & wire ) const
+{
+    epicsGuard < epicsMutex > locker ( this->mutex );
+    tsDLIterConst < casStrmClient > iter = this->clientList.firstIter ();
+    while ( iter.valid () ) {
+        casLatencyHistogram clientEncode, clientWire;
+        iter->subscriptionLatency ( clientEncode, clientWire );
+        encode.add ( clientEncode );
+        wire.add ( clientWire );
+        ++iter;
+    }
+}
+
+//
+// the visitor is called with the server's lock held
+//
+void caServerI::clientLatency ( casClientLatencyVisitor & visitor ) const
+{
+    epicsGuard < epicsMutex > locker ( this->mutex );
+    tsDLIterConst < casStrmClient > iter = this->clientList.firstIter ();
+    while ( iter.valid () ) {
+        casLatencyHistogram encode, wire;
+        char hostName[128];
+        char userName[128];
+        iter->subscriptionLatency ( encode, wire );
+        iter->hostName ( hostName, sizeof ( hostName ) );
+        iter->userName ( userName, sizeof ( userName ) );
+        visitor.clientLatency ( hostName, userName, encode, wire );
+        ++iter;
+    }
+}
+
+caStatus caServerI::publishStatistics ( 
+    const char * pPrefix, double updatePeriod )
+{
+    if ( ! pPrefix || updatePeriod <= 0.0 ) {
+        return S_cas_badParameter;
+    }
+    epicsGuard < epicsMutex > locker ( this->mutex );
+    if ( this->pStatistics ) {
+        return S_cas_badParameter;
+    }
+    this->pStatistics = 
+        new casServerStatistics ( *this, pPrefix, updatePeriod );
+    return S_cas_success;
+}
+
+#ifdef CAS_DISPATCH_STATS
+//
+// The counters are written by the threads servicing the clients
+// without a lock. Those of the destroyed clients are included.
+//
+void caServerI::dispatchStatistics ( casDispatchStats & stream,
+    casDispatchStats & datagram ) const
+{
+    epicsGuard < epicsMutex > locker ( this->mutex );
+    stream.add ( this->retiredDispatchStats );
+    tsDLIterConst < casStrmClient > iterCl = this->clientList.firstIter ();
+    while ( iterCl.valid () ) {
+        stream.add ( iterCl->dispatchStatistics () );
+        ++iterCl;
+    }
+    tsDLIterConst < casIntfOS > iterIF = this->intfList.firstIter ();
+    while ( iterIF.valid () ) {
+        datagram.add ( iterIF->dispatchStatistics () );
+        ++iterIF;
+    }
+}
+#endif
+
+//
+// The event queue limit is applied to the existing clients here, 
+// and to new clients when they are created. The over budget delay
+// is checked a few times within the delay, but at least once per
+// second.
+//
+caStatus caServerI::setClientBudget ( const casClientBudget & budgetIn )
+{
+    if ( budgetIn.maxOverBudgetDelay < 0.0 ) {
+        return S_cas_badParameter;
+    }
+    // only clients over budget for the delay are disconnected
+    if ( budgetIn.maxBufferBytes && 
+            budgetIn.maxOverBudgetDelay <= 0.0 ) {
+        return S_cas_badParameter;
+    }
+    epicsGuard < epicsMutex > locker ( this->mutex );
+    if ( budgetIn.maxOverBudgetDelay != this->budget.maxOverBudgetDelay ) {
+        delete this->pBudgetTimer;
+        this->pBudgetTimer = 0;
+        if ( budgetIn.maxOverBudgetDelay > 0.0 ) {
+            double period = budgetIn.maxOverBudgetDelay / 4.0;
+            if ( period > 1.0 ) {
+                period = 1.0;
+            }
+            this->pBudgetTimer = new casBudgetTimer ( *this, period );
+        }
+    }
+    this->budget = budgetIn;
+    tsDLIter < casStrmClient > iter = this->clientList.firstIter ();
+    while ( iter.valid () ) {
+        iter->setEventQueueLimit ( this->budget.maxQueuedEvents );
+        ++iter;
+    }
+    return S_cas_success;
+}
+
+casClientBudget caServerI::clientBudget () const
+{
+    epicsGuard < epicsMutex > locker ( this->mutex );
+    return this->budget;
+}
+
+//
+// the visitor is called with the server's lock held
+//
+void caServerI::clientResources ( casClientResourceVisitor & visitor ) const
+{
+    epicsTime current = epicsTime::getCurrent ();
+    epicsGuard < epicsMutex > locker ( this->mutex );
+    tsDLIterConst < casStrmClient > iter = this->clientList.firstIter ();
+    while ( iter.valid () ) {
+        casClientResources resources;
+        char hostName[128];
+        char userName[128];
+        iter->resources ( resources, current );
+        iter->hostName ( hostName, sizeof ( hostName ) );
+        iter->userName ( userName, sizeof ( userName ) );
+        visitor.clientResources ( hostName, userName, resources );
+        ++iter;
+    }
+}
+
+//
+// The clients which have been over budget for too long are only 
+// shut down here. They are destroyed later, when the thread
+// servicing them finds that they are disconnected.
+//
+void caServerI::enforceClientBudget ( const epicsTime & current )
+{
+    epicsGuard < epicsMutex > locker ( this->mutex );
+    tsDLIter < casStrmClient > iter = this->clientList.firstIter ();
+    while ( iter.valid () ) {
+        iter->enforceBudget ( this->budget, current );
+        ++iter;
+    }
+}
+
+caStatus caServerI::startCapture ( const char * pFileName )
+{
+    if ( ! pFileName || this->pCapture ) {
+        return S_cas_badParameter;
+    }
+    FILE * pFile = fopen ( pFileName, "wb" );
+    if ( ! pFile ) {
+        errlogPrintf ( "CAS: unable to open capture file \"%s\"\n",
+            pFileName );
+        return S_cas_badParameter;
+    }
+    this->pCapture = new casTrafficCapture ( pFile, pFileName );
+    this->captureGeneration++;
+    return S_cas_success;
+}
+
+void caServerI::stopCapture ()
+{
+    delete this->pCapture;
+    this->pCapture = 0;
+}
+
+//
+// Returns the number identifying the circuit in the capture file,
+// or zero if there is no capture, and the capture's generation. 
+// Only the circuits accepted while capturing are recorded, since a
+// replay of the rest of a circuit wouldnt make sense, and so a 
+// circuit is recorded only while its generation is current. The
+// numbers arent reused by later captures.
+//
+unsigned caServerI::captureConnect ( const caNetAddr & addr, 
+    unsigned & generation )
+{
+    generation = this->captureGeneration;
+    if ( ! this->pCapture ) {
+        return 0u;
+    }
+    if ( ++this->nCaptureCircuits == 0u ) {
+        this->nCaptureCircuits = 1u;
+    }
+    this->pCapture->connect ( this->nCaptureCircuits, addr );
+    return this->nCaptureCircuits;
+}
+
+//
+// The counters are written by the threads servicing the clients 
+// without a lock, and are allowed to roll over. The counts of the 
+// destroyed clients are included so that the totals are monotonic.
+//
+void caServerI::sampleStatistics ( unsigned & nClients, 
+    unsigned & bytesSent, unsigned & searchRequests, 
+    unsigned & queueDepthMax )
+{
+    epicsGuard < epicsMutex > locker ( this->mutex );
+    nClients = this->clientList.count ();
+    bytesSent = this->retiredBytesSent;
+    searchRequests = this->retiredSearchRequests;
+    queueDepthMax = 0u;
+    tsDLIter < casStrmClient > iterCl = this->clientList.firstIter ();
+    while ( iterCl.valid () ) {
+        bytesSent += iterCl->bytesSent ();
+        searchRequests += iterCl->searchRequests ();
+        unsigned depth = iterCl->takeEventQueueDepthMax ();
+        if ( depth > queueDepthMax ) {
+            queueDepthMax = depth;
+        }
+        ++iterCl;
+    }
+    tsDLIter < casIntfOS > iterIF = this->intfList.firstIter ();
+    while ( iterIF.valid () ) {
+        bytesSent += iterIF->bytesSent ();
+        searchRequests += iterIF->searchRequests ();
+        ++iterIF;
+    }
+}
+
+//
+// the statistics PVs are found before the server tool is asked
+//
+pvExistReturn caServerI::pvExistTest ( const casCtx & ctx, 
+    const caNetAddr & clientAddress, const char * pPVAliasName )
+{
+    if ( this->pStatistics && this->pStatistics->find ( pPVAliasName ) ) {
+        return pverExistsHere;
+    }
+    return this->adapter.pvExistTest ( ctx, clientAddress, pPVAliasName );
+}
+
+pvAttachReturn caServerI::pvAttach ( 
+    const casCtx & ctx, const char * pPVAliasName )
+{
+    if ( this->pStatistics ) {
+        casPV * pPV = this->pStatistics->find ( pPVAliasName );
+        if ( pPV ) {
+            return *pPV;
+        }
+    }
+    return this->adapter.pvAttach ( ctx, pPVAliasName );
+}
+
 void caServerI::destroyMonitor ( casMonitor &  mon )
 {
     mon.~casMonitor ();
@@ -265,6 +555,22 @@ void caServerI::show (unsigned level) const
             ellCount(&this->freeEventQ),
             ellCount(&this->freePendingIO));
 #endif
+        casLatencyHistogram encode, wire;
+        this->subscriptionLatency ( encode, wire );
+        encode.show ( "Subscription encode", level );
+        wire.show ( "Subscription wire", level );
+#ifdef CAS_DISPATCH_STATS
+        casDispatchStats stream, datagram;
+        this->dispatchStatistics ( stream, datagram );
+        stream.show ( "TCP", level );
+        datagram.show ( "UDP", level );
+#endif
+        if ( this->pStatistics ) {
+            this->pStatistics->show ( level - 1u );
+        }
+        if ( this->pCapture ) {
+            this->pCapture->show ( level - 1u );
+        }
         printf( 
             "The server's integer resource id conversion table:\n");
     }
@@ -32,8 +32,11 @@
 #include "caServerIO.h"
 #include "ioBlocked.h"
 #include "caServerDefs.h"
+#include "casTrafficCapture.h"
 
 class casStrmClient;
+class casServerStatistics;
+class casBudgetTimer;
 class beaconTimer;
 class beaconAnomalyGovernor;
 class casIntfOS;
@@ -62,7 +65,8 @@ public:
     void destroyMonitor ( casMonitor & );
     caServer * getAdapter ();
     caServer * operator -> ();
-    void connectCB ( casIntfOS & );
+    void connectCB ( casIntfOS &, bool local );
+    bool holdsLocalSocketName ( const char * pName ) const;
     casEventMask valueEventMask () const; // DBE_VALUE registerEvent("value")
     casEventMask logEventMask () const;     // DBE_LOG registerEvent("log") 
     casEventMask alarmEventMask () const; // DBE_ALARM registerEvent("alarm") 
@@ -71,6 +75,33 @@ public:
     void incrEventsProcessedCounter ();
     unsigned subscriptionEventsPosted () const;
     void updateEventsPostedCounter ( unsigned nNewPosts );
+    void subscriptionLatency ( casLatencyHistogram & encode,
+        casLatencyHistogram & wire ) const;
+    void clientLatency ( casClientLatencyVisitor & ) const;
+    caStatus publishStatistics ( const char * pPrefix, double updatePeriod );
+    void sampleStatistics ( unsigned & nClients, unsigned & bytesSent,
+        unsigned & searchRequests, unsigned & queueDepthMax );
+#ifdef CAS_DISPATCH_STATS
+    void dispatchStatistics ( casDispatchStats & stream,
+        casDispatchStats & datagram ) const;
+#endif
+    caStatus setClientBudget ( const casClientBudget & );
+    casClientBudget clientBudget () const;
+    void clientResources ( casClientResourceVisitor & ) const;
+    void enforceClientBudget ( const epicsTime & current );
+    caStatus startCapture ( const char * pFileName );
+    void stopCapture ();
+    unsigned captureConnect ( const caNetAddr &, unsigned & generation );
+    void captureStream ( unsigned circuit, unsigned generation, 
+        const caNetAddr &,
+        const epicsTime & received, const char * pBuf, unsigned nBytes );
+    void captureDisconnect ( unsigned circuit, unsigned generation, 
+        const caNetAddr & );
+    void captureDatagram ( const caNetAddr &, 
+        const char * pBuf, unsigned nBytes );
+    pvExistReturn pvExistTest ( const casCtx &, 
+        const caNetAddr & clientAddress, const char * pPVAliasName );
+    pvAttachReturn pvAttach ( const casCtx &, const char * pPVAliasName );
     void generateBeaconAnomaly ();
     casMonitor & casMonitorFactory ( casChannelI &, 
         caResId clientId, const unsigned long count, 
@@ -95,10 +126,22 @@ private:
     caServer & adapter;
     beaconTimer & beaconTmr;
     beaconAnomalyGovernor & beaconAnomalyGov;
+    casServerStatistics * pStatistics;
+    casBudgetTimer * pBudgetTimer;
+    casClientBudget budget;
+    casTrafficCapture * pCapture;
+    unsigned nCaptureCircuits;
+    unsigned captureGeneration; // incremented by each startCapture()
     unsigned debugLevel;
     unsigned nEventsProcessed; 
     unsigned nEventsPosted; 
     unsigned ioInProgressCount;
+    // counters of the clients which have been destroyed
+    unsigned retiredBytesSent;
+    unsigned retiredSearchRequests;
+#ifdef CAS_DISPATCH_STATS
+    casDispatchStats retiredDispatchStats;
+#endif
 
     casEventMask valueEvent; // DBE_VALUE registerEvent("value")
     casEventMask logEvent;  // DBE_LOG registerEvent("log")
@@ -155,6 +198,38 @@ inline casEventMask caServerI::propertyEventMask() const
     return this->propertyEvent;
 }
 
+//
+// The capture is only started and stopped by the thread which 
+// services the clients, so it isnt locked here. A circuit of an
+// earlier capture isnt recorded in the current one.
+//
+inline void caServerI::captureStream ( unsigned circuit, 
+    unsigned generation, const caNetAddr & addr, 
+    const epicsTime & received, const char * pBuf, unsigned nBytes )
+{
+    if ( this->pCapture && circuit && 
+            generation == this->captureGeneration ) {
+        this->pCapture->stream ( circuit, addr, received, pBuf, nBytes );
+    }
+}
+
+inline void caServerI::captureDisconnect ( unsigned circuit, 
+    unsigned generation, const caNetAddr & addr )
+{
+    if ( this->pCapture && circuit && 
+            generation == this->captureGeneration ) {
+        this->pCapture->disconnect ( circuit, addr );
+    }
+}
+
+inline void caServerI::captureDatagram ( const caNetAddr & addr, 
+    const char * pBuf, unsigned nBytes )
+{
+    if ( this->pCapture ) {
+        this->pCapture->datagram ( addr, pBuf, nBytes );
+    }
+}
+
 inline bool caServerI :: ioIsPending () const
 {
     return ( ioInProgressCount > 0u );
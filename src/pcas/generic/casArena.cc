@@ -0,0 +1,228 @@
+/*************************************************************************\
+* Copyright (c) 2002 The University of Chicago, as Operator of Argonne
+*     National Laboratory.
+* Copyright (c) 2002 The Regents of the University of California, as
+*     Operator of Los Alamos National Laboratory.
+* EPICS BASE is distributed subject to a Software License Agreement found
+* in file LICENSE that is included with this distribution.
+\*************************************************************************/
+
+#include <new>
+#include <stdio.h>
+
+#include "epicsAtomic.h"
+#include "gdd.h"
+
+#define epicsExportSharedSymbols
+#include "casArena.h"
+
+// large enough for the requests of a typical array write
+static const size_t casArenaBlockSize = 4096u;
+// allocations are aligned for any of the ait primitive types
+static const size_t casArenaAlign = 2u * sizeof ( double );
+
+static inline size_t casArenaRound ( size_t size )
+{
+    return ( ( size + casArenaAlign - 1u ) / casArenaAlign ) * casArenaAlign;
+}
+
+//
+// Installed into a gdd whose data are in a promoted block. It is
+// constructed in the block, following the block's header, so that
+// promotion doesnt allocate. When gdd deletes it the block is
+// unreferenced, and freed if the arena has also released it.
+//
+class casArenaDestructor : public gddDestructor {
+public:
+    casArenaDestructor () {}
+    void run ( void * );
+    static void * operator new ( size_t, void * pPlace );
+    static void operator delete ( void *, void * );
+    static void operator delete ( void * );
+protected:
+    ~casArenaDestructor () {}
+};
+
+class casArenaBlock {
+public:
+    casArenaBlock * pNext;
+    size_t size;
+    size_t used;
+    // one for the arena plus one while the destructor is installed,
+    // decremented with atomic operations in whatever thread releases
+    // the server tool's gdd
+    int refCount;
+    // only read or written by the thread owning the arena
+    bool promoted;
+    char * storage ();
+    bool contains ( const void * pBuf );
+    void * destructorPlace ();
+    static casArenaBlock * fromDestructor ( void * pPlace );
+    static void unreference ( casArenaBlock * );
+};
+
+static const size_t casArenaDestructorOffset =
+    casArenaRound ( sizeof ( casArenaBlock ) );
+static const size_t casArenaHeaderSize =
+    casArenaDestructorOffset + casArenaRound ( sizeof ( casArenaDestructor ) );
+
+inline char * casArenaBlock::storage ()
+{
+    return reinterpret_cast < char * > ( this ) + casArenaHeaderSize;
+}
+
+inline bool casArenaBlock::contains ( const void * pBuf )
+{
+    const char * p = static_cast < const char * > ( pBuf );
+    return p >= this->storage () && p < this->storage () + this->used;
+}
+
+inline void * casArenaBlock::destructorPlace ()
+{
+    return reinterpret_cast < char * > ( this ) + casArenaDestructorOffset;
+}
+
+inline casArenaBlock * casArenaBlock::fromDestructor ( void * pPlace )
+{
+    return reinterpret_cast < casArenaBlock * > 
+        ( static_cast < char * > ( pPlace ) - casArenaDestructorOffset );
+}
+
+void casArenaBlock::unreference ( casArenaBlock * pBlock )
+{
+    if ( epicsAtomicDecrIntT ( & pBlock->refCount ) == 0 ) {
+        delete [] reinterpret_cast < char * > ( pBlock );
+    }
+}
+
+void * casArenaDestructor::operator new ( size_t, void * pPlace )
+{
+    return pPlace;
+}
+
+void casArenaDestructor::operator delete ( void *, void * )
+{
+}
+
+//
+// gddDestructor::destroy() deletes the destructor after running it, 
+// and the block, which holds it, is unreferenced here because it 
+// must outlive the destructor
+//
+void casArenaDestructor::operator delete ( void * pPlace )
+{
+    casArenaBlock::unreference ( casArenaBlock::fromDestructor ( pPlace ) );
+}
+
+//
+// the data are freed with the block
+//
+void casArenaDestructor::run ( void * )
+{
+}
+
+casArena::casArena () :
+    pBlockList ( 0 ), pSpare ( 0 )
+{
+}
+
+casArena::~casArena ()
+{
+    this->release ();
+    delete [] reinterpret_cast < char * > ( this->pSpare );
+}
+
+//
+// throws std::bad_alloc when memory is exhausted
+//
+void * casArena::allocate ( size_t size )
+{
+    size = casArenaRound ( size );
+    casArenaBlock * pBlock = this->pBlockList;
+    // a block is promoted at most once, and so allocations
+    // following a promotion are from a new block
+    if ( ! pBlock || pBlock->promoted || 
+            pBlock->size - pBlock->used < size ) {
+        pBlock = this->newBlock ( size );
+        pBlock->pNext = this->pBlockList;
+        this->pBlockList = pBlock;
+    }
+    void * pBuf = pBlock->storage () + pBlock->used;
+    pBlock->used += size;
+    return pBuf;
+}
+
+casArenaBlock * casArena::newBlock ( size_t minSize )
+{
+    casArenaBlock * pBlock;
+    if ( this->pSpare && minSize <= this->pSpare->size ) {
+        pBlock = this->pSpare;
+        this->pSpare = 0;
+    }
+    else {
+        size_t size = minSize > casArenaBlockSize ? minSize : casArenaBlockSize;
+        char * pStorage = new char [ casArenaHeaderSize + size ];
+        pBlock = new ( pStorage ) casArenaBlock;
+        pBlock->size = size;
+    }
+    pBlock->pNext = 0;
+    pBlock->used = 0u;
+    pBlock->refCount = 1;
+    pBlock->promoted = false;
+    return pBlock;
+}
+
+//
+// Returns a destructor which keeps the block holding pBuf allocated
+// until gdd deletes it, or nil if pBuf isnt the last allocation from
+// the arena, or was already promoted. The destructor is part of the
+// block, and so this doesnt allocate. The block isnt used for further
+// allocations.
+//
+gddDestructor * casArena::promote ( const void * pBuf )
+{
+    casArenaBlock * pBlock = this->pBlockList;
+    if ( ! pBlock || pBlock->promoted || ! pBlock->contains ( pBuf ) ) {
+        return 0;
+    }
+    pBlock->promoted = true;
+    // not yet visible to any other thread
+    pBlock->refCount = 2;
+    return new ( pBlock->destructorPlace () ) casArenaDestructor;
+}
+
+void casArena::release ()
+{
+    while ( casArenaBlock * pBlock = this->pBlockList ) {
+        this->pBlockList = pBlock->pNext;
+        // a promoted block is recycled if gdd has already run
+        // all of its destructors
+        if ( pBlock->promoted ) {
+            if ( epicsAtomicDecrIntT ( & pBlock->refCount ) != 0 ) {
+                continue;
+            }
+        }
+        if ( ! this->pSpare && pBlock->size == casArenaBlockSize ) {
+            this->pSpare = pBlock;
+        }
+        else {
+            delete [] reinterpret_cast < char * > ( pBlock );
+        }
+    }
+}
+
+void casArena::show ( unsigned level ) const
+{
+    if ( level > 0u ) {
+        unsigned nBlocks = 0u;
+        size_t nBytes = 0u;
+        for ( casArenaBlock * pBlock = this->pBlockList;
+                pBlock; pBlock = pBlock->pNext ) {
+            nBlocks++;
+            nBytes += pBlock->used;
+        }
+        printf ( "\trequest arena: %u bytes used in %u blocks, spare block %s\n",
+            static_cast < unsigned > ( nBytes ), nBlocks,
+            this->pSpare ? "present" : "absent" );
+    }
+}
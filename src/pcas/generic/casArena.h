@@ -0,0 +1,52 @@
+/*************************************************************************\
+* Copyright (c) 2002 The University of Chicago, as Operator of Argonne
+*     National Laboratory.
+* Copyright (c) 2002 The Regents of the University of California, as
+*     Operator of Los Alamos National Laboratory.
+* EPICS BASE is distributed subject to a Software License Agreement found
+* in file LICENSE that is included with this distribution.
+\*************************************************************************/
+
+#ifndef casArenah
+#define casArenah
+
+#include <stddef.h>
+
+class gddDestructor;
+class casArenaBlock;
+
+//
+// casArena
+//
+// Bump pointer allocator for the temporary buffers needed while one
+// request is processed. Allocations are never freed individually. The
+// client calls release() after it has finished with the message, and
+// this recycles all of the storage at once.
+//
+// If a gdd whose data were carved from the arena is passed to the
+// server tool then the destructor returned by promote() must be
+// installed in it, because the tool may keep the gdd, or a gdd
+// duplicated from it, after release(). Only the last allocation may be
+// promoted. The block holding the data then stays allocated until gdd
+// has deleted the destructor, and the arena has been released.
+//
+// Only the thread processing the client's messages may allocate, promote,
+// or release. The destructors returned by promote() may run in any thread.
+//
+class casArena {
+public:
+    casArena ();
+    ~casArena ();
+    void * allocate ( size_t size );
+    gddDestructor * promote ( const void * pBuf );
+    void release ();
+    void show ( unsigned level ) const;
+private:
+    casArenaBlock * pBlockList; // in use, allocation is from the first
+    casArenaBlock * pSpare; // one standard size block kept when idle
+    casArenaBlock * newBlock ( size_t minSize );
+    casArena ( const casArena & );
+    casArena & operator = ( const casArena & );
+};
+
+#endif // casArenah
@@ -17,29 +17,61 @@
 #define epicsExportSharedSymbols
 #include "casAsyncReadIOI.h"
 #include "casChannelI.h"
+#include "dbMapper.h"
 
 casAsyncReadIOI::casAsyncReadIOI ( 
     casAsyncReadIO & intf, const casCtx & ctx ) :
 	casAsyncIOI ( ctx ), msg ( *ctx.getMsg() ), 
     asyncReadIO ( intf ), chan ( *ctx.getChannel () ), 
-    pDD ( NULL ), completionStatus ( S_cas_internal )
+    pDD ( NULL ), completionStatus ( S_cas_internal ),
+    inFlight ( false )
 {
     this->chan.installIO ( *this );
+    this->chan.getPVI().installReadInFlight ( *this );
 }
 
 casAsyncReadIOI::~casAsyncReadIOI ()
 {
+    // reads waiting for this one are completed with an error
+    this->chan.getPVI().cancelReadInFlight ( *this );
     this->asyncReadIO.serverInitiatedDestroy ();
 }
 
 caStatus casAsyncReadIOI::postIOCompletion ( 
     caStatus completionStatusIn, const gdd & valueRead )
 {
+    this->chan.getPVI().completeReadInFlight ( 
+        *this, completionStatusIn, valueRead );
 	this->pDD = & valueRead;
 	this->completionStatus = completionStatusIn;
 	return this->insertEventQueue ();
 }
 
+//
+// the channel create request also reads the enum string
+// table asynchronously, and it isnt shared
+//
+bool casAsyncReadIOI::coalescable () const
+{
+    return this->msg.m_cmmd == CA_PROTO_READ ||
+        this->msg.m_cmmd == CA_PROTO_READ_NOTIFY ||
+        this->msg.m_cmmd == CA_PROTO_EVENT_ADD;
+}
+
+//
+// The prototype passed to the server tool's read is made from the
+// application type and the element count of the request, and not
+// from its primitive type, which is the server tool's choice. The
+// requests which share them share the read, and each converts the
+// value to its own DBR type when it responds.
+//
+bool casAsyncReadIOI::coalescesWith ( const caHdrLargeArray & other ) const
+{
+    return this->msg.m_count == other.m_count &&
+        gddDbrToAit[this->msg.m_dataType].app == 
+            gddDbrToAit[other.m_dataType].app;
+}
+
 bool casAsyncReadIOI::oneShotReadOP () const
 {
 	return true; // it is a read op
@@ -21,25 +21,35 @@
 #include "casdef.h"
 
 class gdd;
+class casCoalescedReadIOI;
 
-class casAsyncReadIOI : public casAsyncIOI {
+class casAsyncReadIOI : 
+    public casAsyncIOI, 
+    public tsDLNode < casAsyncReadIOI > { // PV's list of reads in flight
 public:
 	casAsyncReadIOI ( casAsyncReadIO &, const casCtx & ctx );
     ~casAsyncReadIOI ();
 	caStatus postIOCompletion ( 
         caStatus completionStatusIn, const gdd &valueRead );
 	caServer *getCAS () const;
+    bool coalescable () const;
+    bool coalescesWith ( const caHdrLargeArray & ) const;
 private:
 	caHdrLargeArray const msg;
     class casAsyncReadIO & asyncReadIO;
 	class casChannelI & chan; 
 	smartConstGDDPointer pDD;
 	caStatus completionStatus;
+    // reads by other clients completed by this one
+    // (protected by the PV's lock)
+    tsDLList < casCoalescedReadIOI > coalescedReads;
+    bool inFlight;
     epicsShareFunc bool oneShotReadOP () const;
 	epicsShareFunc caStatus cbFuncAsyncIO ( 
         epicsGuard < casClientMutex > & );
 	casAsyncReadIOI ( const casAsyncReadIOI & );
 	casAsyncReadIOI & operator = ( const casAsyncReadIOI & );
+    friend class casPVI;
 };
 
 #endif // casAsyncReadIOIh
@@ -0,0 +1,33 @@
+/*************************************************************************\
+* Copyright (c) 2002 The University of Chicago, as Operator of Argonne
+*     National Laboratory.
+* Copyright (c) 2002 The Regents of the University of California, as
+*     Operator of Los Alamos National Laboratory.
+* EPICS BASE is distributed subject to a Software License Agreement found
+* in file LICENSE that is included with this distribution.
+\*************************************************************************/
+
+#include "fdManager.h"
+
+#define epicsExportSharedSymbols
+#include "caServerI.h"
+#include "casBudgetTimer.h"
+
+casBudgetTimer::casBudgetTimer ( caServerI & casIn, double periodIn ) :
+    timer ( fileDescriptorManager.createTimer () ), cas ( casIn ),
+    period ( periodIn )
+{
+    this->timer.start ( *this, this->period );
+}
+
+casBudgetTimer::~casBudgetTimer ()
+{
+    this->timer.destroy ();
+}
+
+epicsTimerNotify::expireStatus casBudgetTimer::expire (
+    const epicsTime & currentTime )
+{
+    this->cas.enforceClientBudget ( currentTime );
+    return expireStatus ( restart, this->period );
+}
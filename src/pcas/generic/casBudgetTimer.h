@@ -0,0 +1,45 @@
+/*************************************************************************\
+* Copyright (c) 2002 The University of Chicago, as Operator of Argonne
+*     National Laboratory.
+* Copyright (c) 2002 The Regents of the University of California, as
+*     Operator of Los Alamos National Laboratory.
+* EPICS BASE Versions 3.13.7
+* and higher are distributed subject to a Software License Agreement found
+* in file LICENSE that is included with this distribution.
+\*************************************************************************/
+#ifndef casBudgetTimerh
+#define casBudgetTimerh
+
+#ifdef epicsExportSharedSymbols
+#   define epicsExportSharedSymbols_casBudgetTimerh
+#   undef epicsExportSharedSymbols
+#endif
+
+// external headers included here
+#include "epicsTimer.h"
+
+#ifdef epicsExportSharedSymbols_casBudgetTimerh
+#   define epicsExportSharedSymbols
+#   include "shareLib.h"
+#endif
+
+class caServerI;
+
+//
+// periodically disconnects the clients which have been over 
+// budget for too long (only running while a delay is set)
+//
+class casBudgetTimer : public epicsTimerNotify {
+public:
+    casBudgetTimer ( caServerI &, double period );
+    ~casBudgetTimer ();
+private:
+    epicsTimer & timer;
+    caServerI & cas;
+    double period;
+    expireStatus expire ( const epicsTime & currentTime );
+	casBudgetTimer ( const casBudgetTimer & );
+	casBudgetTimer & operator = ( const casBudgetTimer & );
+};
+
+#endif // casBudgetTimerh
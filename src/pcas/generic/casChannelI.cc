@@ -25,7 +25,9 @@ casChannelI::casChannelI ( casCoreClient & clientIn,
         chan ( chanIn ), 
         cid ( cidIn ), 
         serverDeletePending ( false ), 
-        accessRightsEvPending ( false )
+        accessRightsEvPending ( false ),
+        readAccessGranted ( false ),
+        writeAccessGranted ( false )
 {
 }
 
@@ -57,6 +59,8 @@ void casChannelI::show ( unsigned level ) const
     printf ( "casChannelI: client id %u PV %s\n", 
         this->cid, this->pv.getName() );
     if ( level > 0 ) {
+        printf ( "\tread access = %d, write access = %d\n",
+            this->readAccessGranted, this->writeAccessGranted );
         this->privateForPV.show ( level - 1 );
         this->chan.show ( level - 1 );
     }
@@ -69,6 +73,7 @@ caStatus casChannelI::cbFunc (
 {
     caStatus stat = S_cas_success;
     {
+        this->refreshAccessRights ();
         stat = this->privateForPV.client().accessRightsResponse ( 
                     clientGuard, this );
     }
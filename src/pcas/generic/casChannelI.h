@@ -20,12 +20,13 @@
 #include "casEvent.h"
 #include "chanIntfForPV.h"
 #include "casCoreClient.h"
+#include "slotIdTable.h"
 
 class casMonitor;
 class casAsyncIOI;
 
 class casChannelI : public tsDLNode < casChannelI >, 
-    public chronIntIdRes < casChannelI >, public casEvent, 
+    public slotIdRes, public casEvent, 
     private casChannelDestroyFromPV {
 public:
     casChannelI ( casCoreClient & clientIn, casChannel & chanIn, 
@@ -43,6 +44,7 @@ public:
     casPVI & getPVI () const;
     void clearOutstandingReads ();
     void postAccessRightsEvent ();
+    void refreshAccessRights ();
     const gddEnumStringTable & enumStringTable () const;
     ca_uint32_t getMaxElem () const;
     void setOwner ( const char * const pUserName, 
@@ -63,6 +65,9 @@ private:
     caResId cid; // client id 
     bool serverDeletePending;
     bool accessRightsEvPending;
+    // the server tool's access rights when they were last sent to the client
+    bool readAccessGranted;
+    bool writeAccessGranted;
     //epicsShareFunc virtual void destroy ();
     caStatus cbFunc ( 
         casCoreClient &, 
@@ -90,7 +95,7 @@ inline const caResId casChannelI::getCID ()
 
 inline const caResId casChannelI::getSID ()
 {
-    return this->chronIntIdRes < casChannelI >::getId ();
+    return this->slotIdRes::getId ();
 }
 
 inline void casChannelI::postAccessRightsEvent ()
@@ -119,14 +124,25 @@ inline void casChannelI::setOwner ( const char * const pUserName,
     this->chan.setOwner ( pUserName, pHostName );
 }
 
+//
+// Only called by the thread processing the client's requests. The
+// server tool's virtual functions are called again only after it
+// calls postAccessRightsEvent().
+//
+inline void casChannelI::refreshAccessRights ()
+{
+    this->readAccessGranted = this->chan.readAccess ();
+    this->writeAccessGranted = this->chan.writeAccess ();
+}
+
 inline bool casChannelI::readAccess () const
 {
-    return this->chan.readAccess ();
+    return this->readAccessGranted;
 }
 
 inline bool casChannelI::writeAccess () const
 {
-    return this->chan.writeAccess ();
+    return this->writeAccessGranted;
 }
 
 inline bool casChannelI::confirmationRequested () const
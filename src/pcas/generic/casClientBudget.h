@@ -0,0 +1,76 @@
+/*************************************************************************\
+* Copyright (c) 2002 The University of Chicago, as Operator of Argonne
+*     National Laboratory.
+* Copyright (c) 2002 The Regents of the University of California, as
+*     Operator of Los Alamos National Laboratory.
+* EPICS BASE Versions 3.13.7
+* and higher are distributed subject to a Software License Agreement found
+* in file LICENSE that is included with this distribution.
+\*************************************************************************/
+#ifndef casClientBudgeth
+#define casClientBudgeth
+
+#include "shareLib.h"
+
+//
+// casClientBudget
+//
+// Limits on the resources held by each TCP client which are set
+// with caServer::setClientBudget(). A limit of zero is no limit.
+//
+struct casClientBudget {
+    // Subscription updates queued for the client. When the queue
+    // is this deep only the latest update of each subscription is
+    // kept, and the intermediate updates are dropped.
+    unsigned maxQueuedEvents;
+    // Bytes of input and output buffer allocated to the client
+    // above which it is over budget. This isnt a cap on the buffers,
+    // which still grow to hold the largest message, but a threshold
+    // for disconnecting the client, and so it requires
+    // maxOverBudgetDelay.
+    unsigned maxBufferBytes;
+    // A client which stays over budget for longer than this (in
+    // seconds) is disconnected. It is over budget while its event
+    // queue is at maxQueuedEvents, or its buffers exceed
+    // maxBufferBytes.
+    double maxOverBudgetDelay;
+    casClientBudget ();
+};
+
+//
+// the resources held by one TCP client
+//
+struct casClientResources {
+    unsigned queuedEvents; // subscription updates waiting to be encoded
+    unsigned outputBytes; // encoded but not yet sent
+    unsigned inputBytes; // received but not yet processed
+    unsigned bufferBytes; // input and output buffer allocated
+    double flowControlDelay; // seconds with events turned off by the client
+    double overBudgetDelay; // seconds continuously over budget (or zero)
+    casClientResources ();
+};
+
+//
+// used with caServer::clientResources() to visit each client
+//
+class epicsShareClass casClientResourceVisitor {
+public:
+    virtual void clientResources ( const char * pHostName,
+        const char * pUserName, const casClientResources & ) = 0;
+protected:
+    virtual ~casClientResourceVisitor () {}
+};
+
+inline casClientBudget::casClientBudget () :
+    maxQueuedEvents ( 0u ), maxBufferBytes ( 0u ),
+    maxOverBudgetDelay ( 0.0 )
+{
+}
+
+inline casClientResources::casClientResources () :
+    queuedEvents ( 0u ), outputBytes ( 0u ), inputBytes ( 0u ),
+    bufferBytes ( 0u ), flowControlDelay ( 0.0 ), overBudgetDelay ( 0.0 )
+{
+}
+
+#endif // casClientBudgeth
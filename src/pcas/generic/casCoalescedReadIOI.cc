@@ -0,0 +1,87 @@
+/*************************************************************************\
+* Copyright (c) 2002 The University of Chicago, as Operator of Argonne
+*     National Laboratory.
+* Copyright (c) 2002 The Regents of the University of California, as
+*     Operator of Los Alamos National Laboratory.
+* EPICS BASE is distributed subject to a Software License Agreement found
+* in file LICENSE that is included with this distribution. 
+\*************************************************************************/
+#include "errlog.h"
+
+#define epicsExportSharedSymbols
+#include "casCoalescedReadIOI.h"
+#include "casChannelI.h"
+
+//
+// the prototype is kept so that there is a value to 
+// respond with if the read is canceled
+//
+casCoalescedReadIOI::casCoalescedReadIOI ( 
+    const casCtx & ctx, gdd & prototype ) :
+	casAsyncIOI ( ctx ), msg ( *ctx.getMsg() ), 
+    chan ( *ctx.getChannel () ), pDD ( & prototype ), 
+    completionStatus ( S_cas_internal ), pLeader ( 0 )
+{
+    this->chan.installIO ( *this );
+}
+
+casCoalescedReadIOI::~casCoalescedReadIOI ()
+{
+    this->chan.getPVI().removeCoalescedRead ( *this );
+}
+
+caStatus casCoalescedReadIOI::postIOCompletion ( 
+    caStatus completionStatusIn, const gdd & valueRead )
+{
+	this->pDD = & valueRead;
+	this->completionStatus = completionStatusIn;
+	return this->insertEventQueue ();
+}
+
+bool casCoalescedReadIOI::oneShotReadOP () const
+{
+	return true; // it is a read op
+}
+
+caStatus casCoalescedReadIOI::cbFuncAsyncIO (
+    epicsGuard < casClientMutex > & guard )
+{
+	caStatus status;
+
+    // uninstall the io early on to prevent a channel delete from
+    // destroying this object twice
+    this->chan.uninstallIO ( *this );
+
+	switch ( this->msg.m_cmmd ) {
+	case CA_PROTO_READ:
+		status = client.readResponse ( 
+            guard, & this->chan, this->msg,
+			* this->pDD, this->completionStatus );
+		break;
+
+	case CA_PROTO_READ_NOTIFY:
+		status = client.readNotifyResponse ( 
+            guard, & this->chan, this->msg, * this->pDD, 
+			this->completionStatus );
+        break;
+
+	case CA_PROTO_EVENT_ADD:
+		status = client.monitorResponse ( 
+            guard, this->chan, this->msg, * this->pDD,
+			this->completionStatus );
+		break;
+
+	default:
+        errPrintf ( S_cas_invalidAsynchIO, __FILE__, __LINE__,
+            " - client request type = %u", this->msg.m_cmmd );
+		status = S_cas_invalidAsynchIO;
+		break;
+	}
+
+    if ( status == S_cas_sendBlocked ) {
+        this->chan.installIO ( *this );
+    }
+
+	return status;
+}
+
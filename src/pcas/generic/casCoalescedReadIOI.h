@@ -0,0 +1,48 @@
+
+/*************************************************************************\
+* Copyright (c) 2002 The University of Chicago, as Operator of Argonne
+*     National Laboratory.
+* Copyright (c) 2002 The Regents of the University of California, as
+*     Operator of Los Alamos National Laboratory.
+* EPICS BASE Versions 3.13.7
+* and higher are distributed subject to a Software License Agreement found
+* in file LICENSE that is included with this distribution. 
+\*************************************************************************/
+#ifndef casCoalescedReadIOIh
+#define casCoalescedReadIOIh
+
+#include "casAsyncIOI.h"
+#include "casdef.h"
+
+class gdd;
+class casAsyncReadIOI;
+
+//
+// A read which waits for the completion of an asynchronous read
+// of the same PV by another client (see casPV::coalesceReads()).
+// There is no server tool object corresponding to this one.
+//
+class casCoalescedReadIOI : 
+    public casAsyncIOI, 
+    public tsDLNode < casCoalescedReadIOI > { // reads waiting for the leader
+public:
+	casCoalescedReadIOI ( const casCtx & ctx, gdd & prototype );
+    ~casCoalescedReadIOI ();
+	caStatus postIOCompletion ( 
+        caStatus completionStatusIn, const gdd &valueRead );
+private:
+	caHdrLargeArray const msg;
+	class casChannelI & chan; 
+	smartConstGDDPointer pDD;
+	caStatus completionStatus;
+    // the read this one waits for (protected by the PV's lock)
+    casAsyncReadIOI * pLeader;
+    epicsShareFunc bool oneShotReadOP () const;
+	epicsShareFunc caStatus cbFuncAsyncIO ( 
+        epicsGuard < casClientMutex > & );
+	casCoalescedReadIOI ( const casCoalescedReadIOI & );
+	casCoalescedReadIOI & operator = ( const casCoalescedReadIOI & );
+    friend class casPVI;
+};
+
+#endif // casCoalescedReadIOIh
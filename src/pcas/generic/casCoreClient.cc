@@ -22,7 +22,7 @@
 #include "casChannelI.h"
 
 casCoreClient::casCoreClient ( caServerI & serverInternal ) :
-    eventSys ( *this )
+    eventSys ( *this ), nSearchRequests ( 0u )
 {
 	assert ( & serverInternal );
 	ctx.setServer ( & serverInternal );
@@ -56,6 +56,10 @@ void casCoreClient::show ( unsigned level ) const
     epicsGuard < epicsMutex > guard ( this->mutex );
 	this->eventSys.show ( level );
 	this->ctx.show ( level );
+    this->encodeLatency.show ( "Subscription encode", level );
+#ifdef CAS_DISPATCH_STATS
+    this->dispatchStats.show ( "Dispatched", level );
+#endif
     this->mutex.show ( level );
 }
 
@@ -177,6 +181,14 @@ casMonitor & casCoreClient::monitorFactory (
     return mon;
 }
 
+void casCoreClient::subscriptionEncoded ( 
+    casPVI & pvi, epicsUInt64 posted )
+{
+    double delay = ( epicsMonotonicGet () - posted ) * 1e-9;
+    this->encodeLatency.record ( delay );
+    pvi.recordEncodeLatency ( delay );
+}
+
 void casCoreClient::destroyMonitor ( casMonitor & mon )
 {
     this->eventSys.removeMonitor ();
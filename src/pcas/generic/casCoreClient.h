@@ -22,14 +22,16 @@
 #include "casMonitor.h"
 #include "casEventSys.h"
 #include "casCtx.h"
+#include "casLatencyHistogram.h"
+#include "casDispatchStats.h"
 
 class casClientMutex : public epicsMutex {
 };
 
 //
 // casCoreClient
-// (this will eventually support direct communication
-// between the client lib and the server lib)
+// (the base of the TCP and UDP clients, and of
+// casDirectClient which is in the same process)
 //
 class casCoreClient : public ioBlocked,
     private casMonitorCallbackInterface {
@@ -113,8 +115,9 @@ public:
     caStatus casMonitorCallBack ( 
         epicsGuard < casClientMutex > &, 
         casMonitor &, const gdd & );
-    void postEvent ( tsDLList <casMonitor > &, 
-        const casEventMask &select, const gdd &event );
+    void postEvent ( casMonitorSet &, 
+        const casEventMask &select, const gdd &event,
+        epicsUInt64 posted );
 
     casMonitor & monitorFactory ( 
         casChannelI & ,
@@ -127,10 +130,32 @@ public:
     void casMonEventDestroy ( 
         casMonEvent &, epicsGuard < evSysMutex > & );
 
+    //
+    // called with the client lock held after a subscription 
+    // update posted at the time specified has been encoded
+    //
+    virtual void subscriptionEncoded ( 
+        class casPVI &, epicsUInt64 posted );
+
+    // diagnostic counters sampled by casServerStatistics
+    unsigned searchRequests () const;
+    unsigned takeEventQueueDepthMax ();
+#ifdef CAS_DISPATCH_STATS
+    const casDispatchStats & dispatchStatistics () const;
+#endif
+
 protected:
     casEventSys eventSys;
     mutable casClientMutex mutex;
 	casCtx ctx;
+    // post to encode latency (protected by the client lock)
+    casLatencyHistogram encodeLatency;
+    // written only by the thread servicing the client (rolls over)
+    unsigned nSearchRequests;
+#ifdef CAS_DISPATCH_STATS
+    // written by processMsg()
+    casDispatchStats dispatchStats;
+#endif
     bool userStartedAsyncIO;
 
 private:
@@ -145,11 +170,28 @@ private:
 	casCoreClient & operator = ( const casCoreClient & );
 };
 
+#ifdef CAS_DISPATCH_STATS
+inline const casDispatchStats & casCoreClient::dispatchStatistics () const
+{
+    return this->dispatchStats;
+}
+#endif
+
 inline caServerI & casCoreClient::getCAS() const
 {
 	return *this->ctx.getServer();
 }
 
+inline unsigned casCoreClient::searchRequests () const
+{
+    return this->nSearchRequests;
+}
+
+inline unsigned casCoreClient::takeEventQueueDepthMax ()
+{
+    return this->eventSys.takeQueueDepthMax ();
+}
+
 inline bool casCoreClient::okToStartAsynchIO ()
 {
     if ( ! this->userStartedAsyncIO ) {
@@ -160,11 +202,12 @@ inline bool casCoreClient::okToStartAsynchIO ()
 }
 
 inline void casCoreClient::postEvent ( 
-    tsDLList < casMonitor > & monitorList, 
-    const casEventMask & select, const gdd & event )
+    casMonitorSet & monitorSet, 
+    const casEventMask & select, const gdd & event,
+    epicsUInt64 posted )
 {
     bool signalNeeded = 
-        this->eventSys.postEvent ( monitorList, select, event );
+        this->eventSys.postEvent ( monitorSet, select, event, posted );
     if ( signalNeeded ) {
         this->eventSignal ();
     }
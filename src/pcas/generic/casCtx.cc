@@ -19,7 +19,7 @@
 
 casCtx::casCtx() :
 	pData ( NULL ), pCAS ( NULL ), pClient ( NULL ),
-	pChannel ( NULL ), pPV ( NULL ), nAsyncIO ( 0u )
+	pChannel ( NULL ), pPV ( NULL ), pArena ( NULL ), nAsyncIO ( 0u )
 {
 	memset(&this->msg, 0, sizeof(this->msg));
 }
@@ -41,6 +41,8 @@ void casCtx::show ( unsigned level ) const
             static_cast <void *> ( pChannel ) );
 		printf ("\tpPV = %p\n", 
             static_cast <void *> ( pPV ) );
+		printf ("\tpArena = %p\n", 
+            static_cast <void *> ( pArena ) );
 	}
 }
 
@@ -29,11 +29,13 @@ public:
 	class casCoreClient * getClient () const;
 	class casPVI * getPV () const;
 	class casChannelI * getChannel () const;
+	class casArena * getArena () const;
 	void setMsg ( const caHdrLargeArray &, void * pBody );
 	void setServer ( class caServerI * p );
 	void setClient ( class casCoreClient * p );
 	void setPV ( class casPVI * p );
 	void setChannel ( class casChannelI * p );
+	void setArena ( class casArena * p );
 	void show ( unsigned level ) const;
 private:
 	caHdrLargeArray msg;	// ca message header
@@ -42,6 +44,7 @@ private:
 	casCoreClient * pClient;
 	casChannelI * pChannel;
 	casPVI * pPV;
+	casArena * pArena; // storage released after the message is processed
 	unsigned nAsyncIO; // checks for improper use of async io
     friend class casStrmClient;
 };
@@ -76,6 +79,11 @@ inline casChannelI * casCtx::getChannel() const
 	return this->pChannel;
 }
 
+inline casArena * casCtx::getArena() const 
+{	
+	return this->pArena;
+}
+
 inline void casCtx::setMsg ( const caHdrLargeArray & msgIn, void * pBody )
 {
 	this->msg = msgIn;
@@ -102,4 +110,9 @@ inline void casCtx::setChannel(casChannelI *p)
 	this->pChannel = p;
 }
 
+inline void casCtx::setArena(casArena *p) 
+{
+	this->pArena = p;
+}
+
 #endif // casCtxh
@@ -131,6 +131,8 @@ caStatus casDGClient::searchAction()
     const char              *pChanName = static_cast <char * > ( this->ctx.getData() );
     caStatus                status;
 
+    this->nSearchRequests++;
+
     if (!CA_VSUPPORTED(mp->m_count)) {
         if ( this->getCAS().getDebugLevel() > 3u ) {
             char pHostName[64u];
@@ -196,7 +198,7 @@ caStatus casDGClient::searchAction()
     //
     this->userStartedAsyncIO = false;
     pvExistReturn pver =
-        this->getCAS()->pvExistTest ( this->ctx, this->lastRecvAddr, pChanName );
+        this->getCAS().pvExistTest ( this->ctx, this->lastRecvAddr, pChanName );
 
     //
     // prevent problems when they initiate
@@ -479,6 +481,8 @@ inBufClient::fillCondition casDGClient::xRecv (char *pBufIn, bufSizeT nBytesToRe
         stat = this->osdRecv ( reinterpret_cast < char * > ( pHdr + 1 ),
             MAX_UDP_RECV, parm, nDGBytesRecv, pHdr->cadg_addr);
         if (stat==casFillProgress) {
+            this->getCAS().captureDatagram ( pHdr->cadg_addr,
+                reinterpret_cast < char * > ( pHdr + 1 ), nDGBytesRecv );
             pHdr->cadg_nBytes = nDGBytesRecv + sizeof(*pHdr);
             pCurBuf += pHdr->cadg_nBytes;
             //
@@ -850,7 +854,14 @@ caStatus casDGClient::processMsg ()
             else {
                 pHandler = & casDGClient::uknownMessageAction;
             }
+#ifdef CAS_DISPATCH_STATS
+            epicsTime dispatchBegin = epicsTime::getCurrent ();
+#endif
             status = ( this->*pHandler ) ();
+#ifdef CAS_DISPATCH_STATS
+            this->dispatchStats.record ( msgTmp.m_cmmd, 
+                epicsTime::getCurrent () - dispatchBegin );
+#endif
             if ( status ) {
                 this->in.removeMsg ( this->in.bytesPresent() );
                 break;
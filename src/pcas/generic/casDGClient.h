@@ -47,6 +47,7 @@ public:
         ca_uint32_t cid, const int reportedStatus, 
         const char *pformat, ... );
     caStatus processDG ();
+    unsigned bytesSent () const;
 protected:
     bool inBufFull () const;
     void inBufFill ( inBufClient::fillParameter );
@@ -102,6 +103,11 @@ inline ca_uint16_t casDGClient::protocolRevision () const
     return this->minor_version_number;
 }
 
+inline unsigned casDGClient::bytesSent () const
+{
+    return this->out.bytesSent ();
+}
+
 
 #endif // casDGClienth
 
@@ -0,0 +1,83 @@
+/*************************************************************************\
+* Copyright (c) 2002 The University of Chicago, as Operator of Argonne
+*     National Laboratory.
+* Copyright (c) 2002 The Regents of the University of California, as
+*     Operator of Los Alamos National Laboratory.
+* EPICS BASE is distributed subject to a Software License Agreement found
+* in file LICENSE that is included with this distribution.
+\*************************************************************************/
+
+#include <stdio.h>
+
+#define epicsExportSharedSymbols
+#include "casDirectClient.h"
+
+casDirect::casDirect ( caServer & cas, const char * pUserName,
+        const char * pHostName ) :
+    pClient ( 0 )
+{
+    if ( cas.pCAS ) {
+        this->pClient = new casDirectClient ( *cas.pCAS,
+            pUserName, pHostName );
+    }
+}
+
+casDirect::~casDirect ()
+{
+    delete this->pClient;
+}
+
+caStatus casDirect::createChannel ( const char * pPVName,
+    casDirectChannelNotify & notify, casDirectId & channel )
+{
+    if ( pClient ) {
+        return this->pClient->createChannel ( pPVName, notify, channel );
+    }
+    return S_cas_noInterface;
+}
+
+caStatus casDirect::destroyChannel ( casDirectId channel )
+{
+    if ( pClient ) {
+        return this->pClient->destroyChannel ( channel );
+    }
+    return S_cas_noInterface;
+}
+
+caStatus casDirect::subscribe ( casDirectId channel,
+    const casEventMask & mask, casDirectSubscriptionNotify & notify,
+    casDirectId & subscription )
+{
+    if ( pClient ) {
+        return this->pClient->subscribe ( channel, mask,
+            notify, subscription );
+    }
+    return S_cas_noInterface;
+}
+
+caStatus casDirect::cancelSubscription ( casDirectId subscription )
+{
+    if ( pClient ) {
+        return this->pClient->cancelSubscription ( subscription );
+    }
+    return S_cas_noInterface;
+}
+
+caStatus casDirect::read ( casDirectId channel,
+    casDirectReadNotify & notify )
+{
+    if ( pClient ) {
+        return this->pClient->read ( channel, notify );
+    }
+    return S_cas_noInterface;
+}
+
+void casDirect::show ( unsigned level ) const
+{
+    if ( pClient ) {
+        this->pClient->show ( level );
+    }
+    else {
+        printf ( "casDirect: server is not initialized\n" );
+    }
+}
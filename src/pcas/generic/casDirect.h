@@ -0,0 +1,128 @@
+/*************************************************************************\
+* Copyright (c) 2002 The University of Chicago, as Operator of Argonne
+*     National Laboratory.
+* Copyright (c) 2002 The Regents of the University of California, as
+*     Operator of Los Alamos National Laboratory.
+* EPICS BASE Versions 3.13.7
+* and higher are distributed subject to a Software License Agreement found
+* in file LICENSE that is included with this distribution.
+\*************************************************************************/
+#ifndef casDirecth
+#define casDirecth
+
+#include "casdef.h"
+
+//
+// identifies a channel, or a subscription, of one casDirect
+//
+typedef epicsUInt32 casDirectId;
+
+//
+// casDirectChannelNotify
+//
+// Called when casDirect::createChannel() completes, and when the
+// server tool destroys a channel that was connected.
+//
+class epicsShareClass casDirectChannelNotify {
+public:
+    // the status is S_cas_success if the channel connected
+    virtual void connectNotify ( caStatus status ) = 0;
+    virtual void disconnectNotify () = 0;
+protected:
+    virtual ~casDirectChannelNotify () {}
+};
+
+//
+// casDirectSubscriptionNotify
+//
+// Called with the event posted by the server tool, and first with
+// the current value of the PV. The gdd may be kept by referencing
+// it, but it must not be modified.
+//
+class epicsShareClass casDirectSubscriptionNotify {
+public:
+    virtual void update ( const gdd & value ) = 0;
+protected:
+    virtual ~casDirectSubscriptionNotify () {}
+};
+
+//
+// casDirectReadNotify
+//
+// Called once when a read started with casDirect::read() completes.
+// The gdd may be kept by referencing it, but it must not be modified.
+// A read pending when the channel disconnects completes with
+// readException ( S_cas_disconnect ).
+//
+class epicsShareClass casDirectReadNotify {
+public:
+    virtual void readCompletion ( const gdd & value ) = 0;
+    virtual void readException ( caStatus status ) = 0;
+protected:
+    virtual ~casDirectReadNotify () {}
+};
+
+//
+// casDirect
+//
+// A client of the server in the same process. PVs are attached,
+// read, and subscribed to as they would be by a CA client, but the
+// gdd posted or read by the server tool is passed directly to the
+// callbacks. There is no TCP circuit, no DBR encoding, and no byte
+// swapping. The value type is the PV's best external type, and the
+// element count is its maximum.
+//
+// The casDirect is created, used, and destroyed by the thread that
+// calls fileDescriptorManager.process(), and the callbacks are called
+// by that thread (sometimes before the request returns). A request
+// from any other thread fails an assert. The server tool may post
+// events, and complete asynchronous IO, from any thread, as it may
+// for the CA clients, and they are delivered by the same thread.
+// The callbacks are called with the client's lock held, and must not
+// destroy the channel, or cancel the subscription, they were called
+// for. A casDirect must be destroyed before the caServer it attaches
+// to.
+//
+class epicsShareClass casDirect {
+public:
+    //
+    // The user and host names are passed to casPV::createChannel()
+    // for access control.
+    //
+    casDirect ( caServer &, const char * pUserName,
+        const char * pHostName );
+    ~casDirect ();
+
+    //
+    // Attaches to the PV with caServer::pvAttach(), and calls
+    // connectNotify() when the attach completes. A server tool
+    // which postpones the attach fails it with
+    // S_casApp_postponeAsyncIO. The channel is destroyed with
+    // destroyChannel() whether or not it connected.
+    //
+    caStatus createChannel ( const char * pPVName,
+        casDirectChannelNotify &, casDirectId & channel );
+    caStatus destroyChannel ( casDirectId channel );
+
+    //
+    // Subscriptions end when they are cancelled, or when their
+    // channel is destroyed, but not when it disconnects.
+    //
+    caStatus subscribe ( casDirectId channel, const casEventMask &,
+        casDirectSubscriptionNotify &, casDirectId & subscription );
+    caStatus cancelSubscription ( casDirectId subscription );
+
+    //
+    // Reads the current value. It is the last value posted, without
+    // calling casPV::read(), if the PV caches its posted events.
+    //
+    caStatus read ( casDirectId channel, casDirectReadNotify & );
+
+    void show ( unsigned level ) const;
+private:
+    class casDirectClient * pClient;
+    casDirect ( const casDirect & );
+    casDirect & operator = ( const casDirect & );
+};
+
+#endif // casDirecth
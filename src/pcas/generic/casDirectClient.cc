@@ -0,0 +1,555 @@
+/*************************************************************************\
+* Copyright (c) 2002 The University of Chicago, as Operator of Argonne
+*     National Laboratory.
+* Copyright (c) 2002 The Regents of the University of California, as
+*     Operator of Los Alamos National Laboratory.
+* EPICS BASE is distributed subject to a Software License Agreement found
+* in file LICENSE that is included with this distribution.
+\*************************************************************************/
+
+#include <new>
+#include <string.h>
+#include <stdio.h>
+
+#include "fdManager.h"
+#include "errlog.h"
+#include "dbMapper.h"
+#include "gddAppTable.h"
+#include "gddApps.h"
+
+#define epicsExportSharedSymbols
+#include "casDirectClient.h"
+#include "casChannelI.h"
+#include "channelDestroyEvent.h"
+
+casDirectRead::casDirectRead ( casDirectReadNotify & notifyIn,
+        ca_uint32_t idIn ) :
+    notify ( notifyIn ), id ( idIn )
+{
+}
+
+casDirectSubscription::casDirectSubscription (
+        casDirectSubscriptionNotify & notifyIn, casDirectChannel & chanIn ) :
+    notify ( notifyIn ), chan ( chanIn )
+{
+}
+
+casDirectChannel::casDirectChannel ( casDirectChannelNotify & notifyIn ) :
+    notify ( notifyIn ), pChanI ( 0 ), nativeTypeDBR ( 0u ),
+    connectPending ( false ), destroyPending ( false )
+{
+}
+
+static char * copyName ( const char * pName )
+{
+    char * pCopy = new char [ strlen ( pName ) + 1u ];
+    strcpy ( pCopy, pName );
+    return pCopy;
+}
+
+casDirectClient::casDirectClient ( caServerI & cas,
+        const char * pUserNameIn, const char * pHostNameIn ) :
+    casCoreClient ( cas ), timer ( fileDescriptorManager.createTimer () ),
+    thread ( epicsThreadGetIdSelf () ), pUserName ( copyName ( pUserNameIn ) ),
+    pHostName ( copyName ( pHostNameIn ) ), nReads ( 0u )
+{
+}
+
+//
+// the timer is destroyed last because uninstalling the channels
+// may wake up the event queue
+//
+casDirectClient::~casDirectClient ()
+{
+    assert ( epicsThreadGetIdSelf () == this->thread );
+    {
+        epicsGuard < casClientMutex > guard ( this->mutex );
+        while ( casDirectChannel * pChan = this->chanList.first () ) {
+            this->uninstallChannel ( *pChan );
+        }
+    }
+    this->timer.destroy ();
+    delete [] this->pUserName;
+    delete [] this->pHostName;
+}
+
+caStatus casDirectClient::createChannel ( const char * pPVName,
+    casDirectChannelNotify & notify, casDirectId & channel )
+{
+    assert ( epicsThreadGetIdSelf () == this->thread );
+    epicsGuard < casClientMutex > guard ( this->mutex );
+
+    casDirectChannel * pChan = new casDirectChannel ( notify );
+    this->chanTable.idAssignAdd ( *pChan );
+    this->chanList.add ( *pChan );
+    pChan->connectPending = true;
+    channel = pChan->getId ();
+
+    caHdrLargeArray hdr;
+    hdr.m_postsize = 0u;
+    hdr.m_count = 0u;
+    hdr.m_cmmd = CA_PROTO_CREATE_CHAN;
+    hdr.m_dataType = 0u;
+    hdr.m_cid = channel;
+    hdr.m_available = 0u;
+    this->ctx.setMsg ( hdr, 0 );
+    this->ctx.setChannel ( 0 );
+    this->ctx.setPV ( 0 );
+
+    this->userStartedAsyncIO = false;
+    pvAttachReturn pvar = this->getCAS().pvAttach ( this->ctx, pPVName );
+    if ( this->userStartedAsyncIO ) {
+        if ( pvar.getStatus() != S_casApp_asyncCompletion ) {
+            errlogPrintf ( "Application returned %d from cas::pvAttach()"
+                " - expected S_casApp_asyncCompletion\n",
+                pvar.getStatus() );
+        }
+        // createChanResponse() is called when it completes
+        return S_cas_success;
+    }
+    if ( pvar.getStatus() == S_casApp_asyncCompletion ) {
+        errMessage ( S_cas_badParameter,
+            "- expected asynch IO creation from caServer::pvAttach()" );
+        return this->createChanResponse ( guard, this->ctx,
+            S_cas_badParameter );
+    }
+    return this->createChanResponse ( guard, this->ctx, pvar );
+}
+
+//
+// called when the attach completes, and before createChannel()
+// returns if it completes synchronously
+//
+caStatus casDirectClient::createChanResponse (
+    epicsGuard < casClientMutex > &, casCtx & ctxIn,
+    const pvAttachReturn & pvar )
+{
+    casDirectChannel * pChan =
+        this->chanTable.lookup ( ctxIn.getMsg()->m_cid );
+    assert ( pChan && pChan->connectPending );
+    pChan->connectPending = false;
+
+    caStatus status = pvar.getStatus ();
+    if ( status == S_cas_success ) {
+        status = this->connect ( ctxIn, pvar, *pChan );
+    }
+
+    if ( pChan->destroyPending ) {
+        this->uninstallChannel ( *pChan );
+    }
+    else {
+        pChan->notify.connectNotify ( status );
+    }
+    return S_cas_success;
+}
+
+caStatus casDirectClient::connect ( casCtx & ctxIn,
+    const pvAttachReturn & pvar, casDirectChannel & chan )
+{
+    casPV & pv = *pvar.getPV ();
+    if ( ! pv.pPVI ) {
+        pv.pPVI = new ( std::nothrow ) casPVI ( pv );
+        if ( ! pv.pPVI ) {
+            pv.destroyRequest ();
+            return S_casApp_pvNotFound;
+        }
+    }
+
+    unsigned nativeTypeDBR;
+    caStatus status = pv.pPVI->bestDBRType ( nativeTypeDBR );
+    if ( status ) {
+        pv.pPVI->deleteSignal ();
+        errMessage ( status, "best external dbr type fetch failed" );
+        return status;
+    }
+
+    status = pv.pPVI->attachToServer ( this->getCAS() );
+    if ( status ) {
+        pv.pPVI->deleteSignal ();
+        return status;
+    }
+
+    casChannel * pChan = pv.pPVI->createChannel (
+        ctxIn, this->pUserName, this->pHostName );
+    if ( ! pChan ) {
+        pv.pPVI->deleteSignal ();
+        return S_cas_noMemory;
+    }
+
+    if ( ! pChan->pChanI ) {
+        pChan->pChanI = new ( std::nothrow )
+            casChannelI ( *this, *pChan, *pv.pPVI, chan.getId () );
+        if ( ! pChan->pChanI ) {
+            pChan->destroyRequest ();
+            pv.pPVI->deleteSignal ();
+            return S_cas_noMemory;
+        }
+        pChan->pChanI->refreshAccessRights ();
+    }
+    pChan->pChanI->installIntoPV ();
+
+    assert ( chan.getId () == pChan->pChanI->getCID () );
+    chan.pChanI = pChan->pChanI;
+    chan.nativeTypeDBR = nativeTypeDBR;
+    return S_cas_success;
+}
+
+caStatus casDirectClient::destroyChannel ( casDirectId channel )
+{
+    assert ( epicsThreadGetIdSelf () == this->thread );
+    epicsGuard < casClientMutex > guard ( this->mutex );
+    casDirectChannel * pChan = this->chanTable.lookup ( channel );
+    if ( ! pChan || pChan->destroyPending ) {
+        return S_cas_badResourceId;
+    }
+    if ( pChan->connectPending ) {
+        // uninstalled when the attach completes
+        pChan->destroyPending = true;
+    }
+    else {
+        this->uninstallChannel ( *pChan );
+    }
+    return S_cas_success;
+}
+
+//
+// the casMonitors are destroyed with the casChannelI, and the
+// reads pending are abandoned
+//
+void casDirectClient::uninstallChannel ( casDirectChannel & chan )
+{
+    this->chanTable.remove ( chan );
+    this->chanList.remove ( chan );
+    if ( chan.pChanI ) {
+        chan.pChanI->uninstallFromPV ( this->eventSys );
+        delete chan.pChanI;
+    }
+    while ( casDirectSubscription * pSub = chan.subscriptions.get () ) {
+        this->subscriptionTable.remove ( *pSub );
+        delete pSub;
+    }
+    while ( casDirectRead * pRead = chan.reads.get () ) {
+        delete pRead;
+    }
+    delete & chan;
+}
+
+caStatus casDirectClient::subscribe ( casDirectId channel,
+    const casEventMask & mask, casDirectSubscriptionNotify & notify,
+    casDirectId & subscription )
+{
+    assert ( epicsThreadGetIdSelf () == this->thread );
+    epicsGuard < casClientMutex > guard ( this->mutex );
+    casDirectChannel * pChan = this->chanTable.lookup ( channel );
+    if ( ! pChan || pChan->destroyPending ) {
+        return S_cas_badResourceId;
+    }
+    if ( ! pChan->pChanI ) {
+        return S_cas_disconnect;
+    }
+    if ( mask.noEventsSelected () ) {
+        return S_cas_noEventsSelected;
+    }
+    if ( ! pChan->pChanI->readAccess () ) {
+        return S_cas_noRead;
+    }
+
+    casDirectSubscription * pSub = new casDirectSubscription ( notify, *pChan );
+    this->subscriptionTable.idAssignAdd ( *pSub );
+    pChan->subscriptions.add ( *pSub );
+    subscription = pSub->getId ();
+
+    casMonitor & mon = this->monitorFactory ( *pChan->pChanI,
+        subscription, pChan->pChanI->getMaxElem (),
+        dbf_type_to_DBR_TIME ( pChan->nativeTypeDBR ), mask );
+    pChan->pChanI->installMonitor ( mon );
+
+    // the first update is the current value
+    this->readValue ( *pChan, CA_PROTO_EVENT_ADD, subscription );
+    return S_cas_success;
+}
+
+caStatus casDirectClient::cancelSubscription ( casDirectId subscription )
+{
+    assert ( epicsThreadGetIdSelf () == this->thread );
+    epicsGuard < casClientMutex > guard ( this->mutex );
+    casDirectSubscription * pSub =
+        this->subscriptionTable.remove ( subscription );
+    if ( ! pSub ) {
+        return S_cas_badResourceId;
+    }
+    casDirectChannel & chan = pSub->chan;
+    chan.subscriptions.remove ( *pSub );
+    if ( chan.pChanI ) {
+        casMonitor * pMon = chan.pChanI->removeMonitor ( subscription );
+        if ( pMon ) {
+            this->eventSys.prepareMonitorForDestroy ( *pMon );
+        }
+    }
+    delete pSub;
+    return S_cas_success;
+}
+
+caStatus casDirectClient::read ( casDirectId channel,
+    casDirectReadNotify & notify )
+{
+    assert ( epicsThreadGetIdSelf () == this->thread );
+    epicsGuard < casClientMutex > guard ( this->mutex );
+    casDirectChannel * pChan = this->chanTable.lookup ( channel );
+    if ( ! pChan || pChan->destroyPending ) {
+        return S_cas_badResourceId;
+    }
+    if ( ! pChan->pChanI ) {
+        return S_cas_disconnect;
+    }
+    if ( ! pChan->pChanI->readAccess () ) {
+        return S_cas_noRead;
+    }
+    casDirectRead * pRead = new casDirectRead ( notify, this->nReads++ );
+    pChan->reads.add ( *pRead );
+    this->readValue ( *pChan, CA_PROTO_READ_NOTIFY, pRead->id );
+    return S_cas_success;
+}
+
+//
+// The value is passed to readCompletion() now, or when the
+// server tool's asynchronous read completes. The prototype is the
+// one that a CA client reading DBR_TIME_<native type> would pass
+// to casPV::read(), and so the read may be shared with other
+// clients if the PV coalesces reads.
+//
+void casDirectClient::readValue ( casDirectChannel & chan,
+    ca_uint16_t cmmd, ca_uint32_t id )
+{
+    casChannelI & chanI = *chan.pChanI;
+    casPVI & pvi = chanI.getPVI ();
+
+    smartConstGDDPointer pPosted = pvi.lastValueEvent ();
+    if ( pPosted.valid () ) {
+        this->readCompletion ( chan, cmmd, id, pPosted.get (),
+            S_cas_success );
+        return;
+    }
+
+    unsigned dbrType = dbf_type_to_DBR_TIME ( chan.nativeTypeDBR );
+    ca_uint32_t count = chanI.getMaxElem ();
+    smartGDDPointer pValue;
+    {
+        gdd * pDD = gddApplicationTypeTable::app_table.getDD (
+            gddDbrToAit[dbrType].app );
+        if ( ! pDD ) {
+            this->readCompletion ( chan, cmmd, id, 0, S_cas_noMemory );
+            return;
+        }
+        pValue.set ( pDD );
+        pDD->unreference ();
+    }
+    caStatus status = convertContainerMemberToAtomic ( *pValue,
+        gddAppType_value, count, count );
+    if ( status != S_cas_success ) {
+        this->readCompletion ( chan, cmmd, id, 0, status );
+        return;
+    }
+
+    caHdrLargeArray hdr;
+    hdr.m_postsize = 0u;
+    hdr.m_count = count;
+    hdr.m_cmmd = cmmd;
+    hdr.m_dataType = static_cast < ca_uint16_t > ( dbrType );
+    hdr.m_cid = chanI.getSID ();
+    hdr.m_available = id;
+    this->ctx.setMsg ( hdr, 0 );
+    this->ctx.setChannel ( & chanI );
+    this->ctx.setPV ( & pvi );
+
+    if ( pvi.joinReadInFlight ( this->ctx, *pValue ) ) {
+        return;
+    }
+
+    this->userStartedAsyncIO = false;
+    status = chanI.read ( this->ctx, *pValue );
+    if ( this->userStartedAsyncIO ) {
+        if ( status != S_casApp_asyncCompletion ) {
+            errlogPrintf (
+                "Application returned %d from casChannel::read() - "
+                "expected S_casApp_asyncCompletion\n", status );
+        }
+        return;
+    }
+    if ( status == S_casApp_asyncCompletion ) {
+        status = S_cas_badParameter;
+        errMessage ( status,
+            "- expected asynch IO creation from casChannel::read()" );
+    }
+    this->readCompletion ( chan, cmmd, id, pValue.get (), status );
+}
+
+//
+// the value is only used if the status is S_cas_success
+//
+void casDirectClient::readCompletion ( casDirectChannel & chan,
+    ca_uint16_t cmmd, ca_uint32_t id, const gdd * pValue,
+    caStatus status )
+{
+    if ( cmmd == CA_PROTO_EVENT_ADD ) {
+        // the subscription waits for the next event if this failed
+        casDirectSubscription * pSub =
+            this->subscriptionTable.lookup ( id );
+        if ( pSub && status == S_cas_success ) {
+            pSub->notify.update ( *pValue );
+        }
+        return;
+    }
+
+    tsDLIter < casDirectRead > iter = chan.reads.firstIter ();
+    while ( iter.valid () ) {
+        if ( iter->id == id ) {
+            casDirectRead * pRead = iter.pointer ();
+            chan.reads.remove ( *pRead );
+            if ( status == S_cas_success ) {
+                pRead->notify.readCompletion ( *pValue );
+            }
+            else {
+                pRead->notify.readException ( status );
+            }
+            delete pRead;
+            return;
+        }
+        iter++;
+    }
+}
+
+caStatus casDirectClient::readNotifyResponse (
+    epicsGuard < casClientMutex > &, casChannelI * pChanI,
+    const caHdrLargeArray & hdr, const gdd & value,
+    const caStatus status )
+{
+    casDirectChannel * pChan = this->chanTable.lookup ( pChanI->getCID () );
+    if ( pChan && pChan->pChanI == pChanI ) {
+        this->readCompletion ( *pChan, hdr.m_cmmd, hdr.m_available,
+            & value, status );
+    }
+    return S_cas_success;
+}
+
+caStatus casDirectClient::monitorResponse (
+    epicsGuard < casClientMutex > & guard, casChannelI & chanI,
+    const caHdrLargeArray & hdr, const gdd & value,
+    const caStatus status )
+{
+    return this->readNotifyResponse ( guard, & chanI, hdr, value, status );
+}
+
+caStatus casDirectClient::casMonitorCallBack (
+    epicsGuard < casClientMutex > &, casMonitor & mon,
+    const gdd & value )
+{
+    casDirectSubscription * pSub =
+        this->subscriptionTable.lookup ( mon.getClientId () );
+    if ( pSub ) {
+        pSub->notify.update ( value );
+    }
+    return S_cas_success;
+}
+
+caStatus casDirectClient::accessRightsResponse (
+    epicsGuard < casClientMutex > &, casChannelI * )
+{
+    return S_cas_success;
+}
+
+//
+// As with casStrmClient, the channel is uninstalled now when that
+// does not compromise the lock hierarchy, and is otherwise found
+// from its id when the event queue is processed.
+//
+void casDirectClient::casChannelDestroyFromInterfaceNotify (
+    casChannelI & chanI, bool immediateUninstallNeeded )
+{
+    if ( immediateUninstallNeeded ) {
+        epicsGuard < casClientMutex > guard ( this->mutex );
+        casDirectChannel * pChan = this->chanTable.lookup ( chanI.getCID () );
+        if ( pChan && pChan->pChanI == & chanI ) {
+            pChan->pChanI = 0;
+        }
+        chanI.uninstallFromPV ( this->eventSys );
+    }
+
+    class channelDestroyEvent * pEvent =
+        new ( std::nothrow ) class channelDestroyEvent (
+            immediateUninstallNeeded ? & chanI : 0,
+            chanI.getCID () );
+    if ( pEvent ) {
+        this->addToEventQueue ( *pEvent );
+    }
+    else {
+        errlogPrintf ( "CAS: no memory to disconnect direct channel\n" );
+        if ( immediateUninstallNeeded ) {
+            delete & chanI;
+        }
+    }
+}
+
+caStatus casDirectClient::channelDestroyEventNotify (
+    epicsGuard < casClientMutex > &, casChannelI * const pChanI,
+    ca_uint32_t cid )
+{
+    casDirectChannel * pChan = this->chanTable.lookup ( cid );
+    casChannelI * pChanFound = pChanI;
+    if ( ! pChanFound ) {
+        if ( ! pChan || ! pChan->pChanI ) {
+            return S_cas_success;
+        }
+        pChanFound = pChan->pChanI;
+        pChan->pChanI = 0;
+        pChanFound->uninstallFromPV ( this->eventSys );
+    }
+    delete pChanFound;
+
+    if ( pChan && ! pChan->pChanI ) {
+        this->disconnect ( *pChan );
+    }
+    return S_cas_success;
+}
+
+void casDirectClient::disconnect ( casDirectChannel & chan )
+{
+    while ( casDirectRead * pRead = chan.reads.get () ) {
+        pRead->notify.readException ( S_cas_disconnect );
+        delete pRead;
+    }
+    chan.notify.disconnectNotify ();
+}
+
+ca_uint16_t casDirectClient::protocolRevision () const
+{
+    return CA_MINOR_PROTOCOL_REVISION;
+}
+
+//
+// called by any thread when an event is posted, or asynchronous IO
+// completes, and the events are then delivered by the thread
+// servicing the server, as they are for casStreamOS
+//
+void casDirectClient::eventSignal ()
+{
+    this->timer.start ( *this, 0.0 );
+}
+
+epicsTimerNotify::expireStatus casDirectClient::expire (
+    const epicsTime & /* currentTime */ )
+{
+    this->eventSysProcess ();
+    return noRestart;
+}
+
+void casDirectClient::show ( unsigned level ) const
+{
+    printf ( "Direct client \"%s\" on \"%s\" with %u channels"
+        " and %u subscriptions\n", this->pUserName, this->pHostName,
+        this->chanTable.numEntriesInstalled (),
+        this->subscriptionTable.numEntriesInstalled () );
+    if ( level > 0u ) {
+        this->casCoreClient::show ( level - 1u );
+    }
+}
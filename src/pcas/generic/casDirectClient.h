@@ -0,0 +1,138 @@
+/*************************************************************************\
+* Copyright (c) 2002 The University of Chicago, as Operator of Argonne
+*     National Laboratory.
+* Copyright (c) 2002 The Regents of the University of California, as
+*     Operator of Los Alamos National Laboratory.
+* EPICS BASE Versions 3.13.7
+* and higher are distributed subject to a Software License Agreement found
+* in file LICENSE that is included with this distribution.
+\*************************************************************************/
+#ifndef casDirectClienth
+#define casDirectClienth
+
+#ifdef epicsExportSharedSymbols
+#   define epicsExportSharedSymbols_casDirectClienth
+#   undef epicsExportSharedSymbols
+#endif
+
+#include "epicsTimer.h"
+#include "epicsThread.h"
+
+#ifdef epicsExportSharedSymbols_casDirectClienth
+#   define epicsExportSharedSymbols
+#   include "shareLib.h"
+#endif
+
+#include "casCoreClient.h"
+#include "slotIdTable.h"
+#include "casDirect.h"
+
+class casDirectChannel;
+
+//
+// a read started by casDirect::read() which has not completed
+//
+class casDirectRead : public tsDLNode < casDirectRead > {
+public:
+    casDirectRead ( casDirectReadNotify &, ca_uint32_t id );
+    casDirectReadNotify & notify;
+    const ca_uint32_t id;
+private:
+	casDirectRead ( const casDirectRead & );
+	casDirectRead & operator = ( const casDirectRead & );
+};
+
+//
+// the id of a subscription is the client id of its casMonitor
+//
+class casDirectSubscription : public slotIdRes,
+    public tsDLNode < casDirectSubscription > {
+public:
+    casDirectSubscription ( casDirectSubscriptionNotify &,
+        casDirectChannel & );
+    casDirectSubscriptionNotify & notify;
+    casDirectChannel & chan;
+private:
+	casDirectSubscription ( const casDirectSubscription & );
+	casDirectSubscription & operator = ( const casDirectSubscription & );
+};
+
+//
+// the id of a channel is the client id (cid) of its casChannelI
+//
+class casDirectChannel : public slotIdRes,
+    public tsDLNode < casDirectChannel > {
+public:
+    casDirectChannel ( casDirectChannelNotify & );
+    casDirectChannelNotify & notify;
+    tsDLList < casDirectSubscription > subscriptions;
+    tsDLList < casDirectRead > reads;
+    casChannelI * pChanI; // nil unless connected
+    unsigned nativeTypeDBR;
+    bool connectPending;
+    bool destroyPending;
+private:
+	casDirectChannel ( const casDirectChannel & );
+	casDirectChannel & operator = ( const casDirectChannel & );
+};
+
+//
+// casDirectClient
+//
+// the client behind casDirect
+//
+class casDirectClient : public casCoreClient,
+    private epicsTimerNotify {
+public:
+    casDirectClient ( caServerI &, const char * pUserName,
+        const char * pHostName );
+    ~casDirectClient ();
+    caStatus createChannel ( const char * pPVName,
+        casDirectChannelNotify &, casDirectId & channel );
+    caStatus destroyChannel ( casDirectId channel );
+    caStatus subscribe ( casDirectId channel, const casEventMask &,
+        casDirectSubscriptionNotify &, casDirectId & subscription );
+    caStatus cancelSubscription ( casDirectId subscription );
+    caStatus read ( casDirectId channel, casDirectReadNotify & );
+    void show ( unsigned level ) const;
+private:
+    slotIdTable < casDirectChannel > chanTable;
+    tsDLList < casDirectChannel > chanList;
+    slotIdTable < casDirectSubscription > subscriptionTable;
+    epicsTimer & timer;
+    const epicsThreadId thread; // the only thread making requests
+    char * pUserName;
+    char * pHostName;
+    ca_uint32_t nReads; // rolls over
+    void uninstallChannel ( casDirectChannel & );
+    void disconnect ( casDirectChannel & );
+    caStatus connect ( casCtx &, const pvAttachReturn &,
+        casDirectChannel & );
+    void readValue ( casDirectChannel &, ca_uint16_t cmmd,
+        ca_uint32_t id );
+    void readCompletion ( casDirectChannel &, ca_uint16_t cmmd,
+        ca_uint32_t id, const gdd * pValue, caStatus status );
+    caStatus createChanResponse ( epicsGuard < casClientMutex > &,
+        casCtx &, const pvAttachReturn & );
+    caStatus readNotifyResponse ( epicsGuard < casClientMutex > &,
+        casChannelI *, const caHdrLargeArray &,
+        const gdd &, const caStatus );
+    caStatus monitorResponse ( epicsGuard < casClientMutex > &,
+        casChannelI &, const caHdrLargeArray &, const gdd &,
+        const caStatus status );
+    caStatus accessRightsResponse ( epicsGuard < casClientMutex > &,
+        casChannelI * );
+    caStatus channelDestroyEventNotify ( epicsGuard < casClientMutex > &,
+        casChannelI * const pChan, ca_uint32_t cid );
+    void casChannelDestroyFromInterfaceNotify ( casChannelI & chan,
+        bool immediateUninstallNeeded );
+    caStatus casMonitorCallBack ( epicsGuard < casClientMutex > &,
+        casMonitor &, const gdd & );
+    ca_uint16_t protocolRevision () const;
+    void eventSignal ();
+    expireStatus expire ( const epicsTime & currentTime );
+	casDirectClient ( const casDirectClient & );
+	casDirectClient & operator = ( const casDirectClient & );
+};
+
+#endif // casDirectClienth
@@ -0,0 +1,106 @@
+/*************************************************************************\
+* Copyright (c) 2002 The University of Chicago, as Operator of Argonne
+*     National Laboratory.
+* Copyright (c) 2002 The Regents of the University of California, as
+*     Operator of Los Alamos National Laboratory.
+* EPICS BASE is distributed subject to a Software License Agreement found
+* in file LICENSE that is included with this distribution.
+\*************************************************************************/
+
+#include <stdio.h>
+#include <string.h>
+
+#define epicsExportSharedSymbols
+#include "casDispatchStats.h"
+
+#ifdef CAS_DISPATCH_STATS
+
+// indexed by the CA_PROTO_XXXX request codes
+static const char * const casCommandNames[] = {
+    "VERSION",
+    "EVENT_ADD",
+    "EVENT_CANCEL",
+    "READ",
+    "WRITE",
+    "SNAPSHOT",
+    "SEARCH",
+    "BUILD",
+    "EVENTS_OFF",
+    "EVENTS_ON",
+    "READ_SYNC",
+    "ERROR",
+    "CLEAR_CHANNEL",
+    "RSRV_IS_UP",
+    "NOT_FOUND",
+    "READ_NOTIFY",
+    "READ_BUILD",
+    "REPEATER_CONFIRM",
+    "CREATE_CHAN",
+    "WRITE_NOTIFY",
+    "CLIENT_NAME",
+    "HOST_NAME",
+    "ACCESS_RIGHTS",
+    "ECHO",
+    "REPEATER_REGISTER",
+    "SIGNAL",
+    "CREATE_CH_FAIL",
+    "SERVER_DISCONN"
+};
+
+casDispatchStats::casDispatchStats ()
+{
+    this->clear ();
+}
+
+void casDispatchStats::clear ()
+{
+    memset ( this->nDispatched, '\0', sizeof ( this->nDispatched ) );
+    for ( unsigned i = 0u; i < nCommands; i++ ) {
+        this->elapsed[i] = 0.0;
+    }
+}
+
+void casDispatchStats::add ( const casDispatchStats & rhs )
+{
+    for ( unsigned i = 0u; i < nCommands; i++ ) {
+        this->nDispatched[i] += rhs.nDispatched[i];
+        this->elapsed[i] += rhs.elapsed[i];
+    }
+}
+
+const char * casDispatchStats::commandName ( unsigned command )
+{
+    if ( command < sizeof ( casCommandNames ) / sizeof ( casCommandNames[0] ) ) {
+        return casCommandNames[command];
+    }
+    return "unknown";
+}
+
+void casDispatchStats::show ( const char * pLabel, unsigned level ) const
+{
+    unsigned total = 0u;
+    double totalTime = 0.0;
+    for ( unsigned i = 0u; i < nCommands; i++ ) {
+        total += this->nDispatched[i];
+        totalTime += this->elapsed[i];
+    }
+    if ( total == 0u ) {
+        printf ( "\t%s requests: none counted\n", pLabel );
+        return;
+    }
+    printf ( "\t%s requests: n=%u, %g sec in handlers\n", 
+        pLabel, total, totalTime );
+    if ( level > 1u ) {
+        for ( unsigned i = 0u; i < nCommands; i++ ) {
+            if ( this->nDispatched[i] ) {
+                printf ( "\t\t%-18s %10u %12.3f uS/req %6.1f%%\n",
+                    commandName ( i ), this->nDispatched[i],
+                    this->elapsed[i] * 1e6 / this->nDispatched[i],
+                    totalTime > 0.0 ? 
+                        100.0 * this->elapsed[i] / totalTime : 0.0 );
+            }
+        }
+    }
+}
+
+#endif // CAS_DISPATCH_STATS
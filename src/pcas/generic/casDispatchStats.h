@@ -0,0 +1,67 @@
+/*************************************************************************\
+* Copyright (c) 2002 The University of Chicago, as Operator of Argonne
+*     National Laboratory.
+* Copyright (c) 2002 The Regents of the University of California, as
+*     Operator of Los Alamos National Laboratory.
+* EPICS BASE Versions 3.13.7
+* and higher are distributed subject to a Software License Agreement found
+* in file LICENSE that is included with this distribution.
+\*************************************************************************/
+#ifndef casDispatchStatsh
+#define casDispatchStatsh
+
+#include "shareLib.h"
+
+//
+// casDispatchStats
+//
+// The number of requests of each type dispatched by processMsg(),
+// and the time spent in their handlers. They exist only if the
+// server library, and the application which requests them, are
+// built with CAS_DISPATCH_STATS defined, so that otherwise no
+// counters are kept and the handlers are not timed.
+//
+// Each client's counters are written only by the thread servicing
+// it, without a lock, and are summed when they are requested.
+//
+#ifdef CAS_DISPATCH_STATS
+
+class epicsShareClass casDispatchStats {
+public:
+    // requests with codes beyond the last are counted in the last
+    enum { nCommands = 32u };
+    casDispatchStats ();
+    void record ( unsigned command, double delay );
+    void add ( const casDispatchStats & );
+    void clear ();
+    unsigned count ( unsigned command ) const;
+    double time ( unsigned command ) const; // seconds
+    static const char * commandName ( unsigned command );
+    void show ( const char * pLabel, unsigned level ) const;
+private:
+    unsigned nDispatched[nCommands];
+    double elapsed[nCommands];
+};
+
+inline void casDispatchStats::record ( unsigned command, double delay )
+{
+    if ( command >= nCommands ) {
+        command = nCommands - 1u;
+    }
+    this->nDispatched[command]++;
+    this->elapsed[command] += delay;
+}
+
+inline unsigned casDispatchStats::count ( unsigned command ) const
+{
+    return command < nCommands ? this->nDispatched[command] : 0u;
+}
+
+inline double casDispatchStats::time ( unsigned command ) const
+{
+    return command < nCommands ? this->elapsed[command] : 0.0;
+}
+
+#endif // CAS_DISPATCH_STATS
+
+#endif // casDispatchStatsh
@@ -22,6 +22,7 @@
 #include "casAsyncIOI.h"
 #include "casChannelI.h"
 #include "channelDestroyEvent.h"
+#include "casMonitorSet.h"
 
 void casEventSys::show ( unsigned level ) const
 {
@@ -38,6 +39,9 @@ void casEventSys::show ( unsigned level ) const
 		printf ( "Replace events flag = %d, dontProcessSubscr flag = %d\n",
 			static_cast < int > ( this->replaceEvents ), 
             static_cast < int > ( this->dontProcessSubscr ) );
+        if ( this->eventQueueLimit ) {
+		    printf ( "\tevent queue limit = %u\n", this->eventQueueLimit );
+        }
 	}
 }
 
@@ -174,6 +178,11 @@ void casEventSys::eventsOn ()
 {
     epicsGuard < epicsMutex > guard ( this->mutex );
 
+    if ( this->replaceEvents ) {
+        this->flowControlTotal += 
+            epicsTime::getCurrent () - this->flowControlBegin;
+    }
+
 	//
 	// allow multiple events for each monitor
 	//
@@ -200,6 +209,10 @@ bool casEventSys::eventsOff ()
     {
         epicsGuard < epicsMutex > guard ( this->mutex );
 
+        if ( ! this->replaceEvents ) {
+            this->flowControlBegin = epicsTime::getCurrent ();
+        }
+
 	    //
 	    // new events will replace the last event on
 	    // the queue for a particular monitor
@@ -320,56 +333,114 @@ void casEventSys::setDestroyPending ()
 	this->destroyPending = true;
 }
 
+//
+// once the queue reaches the limit set by the server's client 
+// budget only the latest update of each subscription is kept
+//
 inline bool casEventSys::full () const
 {
 	return this->replaceEvents || 
-            this->eventLogQue.count() >= this->maxLogEntries;
+            this->eventLogQue.count() >= this->maxLogEntries ||
+            ( this->eventQueueLimit && 
+                this->eventLogQue.count() >= this->eventQueueLimit );
 }
 
-bool casEventSys::postEvent ( tsDLList < casMonitor > & monitorList, 
-    const casEventMask & select, const gdd & event )
+bool casEventSys::postEvent ( casMonitorSet & monitorSet, 
+    const casEventMask & select, const gdd & event,
+    epicsUInt64 posted )
 {
     bool signalNeeded = false;
     {
         epicsGuard < epicsMutex > guard ( this->mutex );
-        tsDLIter < casMonitor > iter = monitorList.firstIter ();
-        while ( iter.valid () ) {
-            if ( iter->selected ( select ) ) {
-	            // get a new block if we havent exceeded quotas
-	            bool full = ( iter->numEventsQueued() >= individualEventEntries ) 
-                            || this->full ();
-	            casMonEvent * pLog;
-	            if ( ! full ) {
-                    // should I get rid of this try block by implementing a no 
-                    // throw version of the free list alloc? However, crude
-                    // tests on windows with ms visual C++ dont appear to argue
-                    // against the try block.
-                    try {
-                        pLog = new ( this->casMonEventFreeList ) 
-                            casMonEvent ( *iter, event );
-                    }
-                    catch ( ... ) {
-                        pLog = 0;
-                    }
-	            }
-	            else {
-		            pLog = 0;
-	            }
-            	
-                signalNeeded |= 
-                    !this->dontProcessSubscr && 
-                    this->eventLogQue.count() == 0 &&
-                    this->ioQue.count() == 0;
-
-                iter->installNewEventLog ( 
-                    this->eventLogQue, pLog, event );
+        // only visit the subscribers whose event mask matches
+        tsDLIter < casMonitorBucket > bucketIter = 
+            monitorSet.firstBucketIter ();
+        while ( bucketIter.valid () ) {
+            if ( ! bucketIter->selected ( select ) ) {
+                ++bucketIter;
+                continue;
+            }
+            tsDLIter < casMonitor > iter = bucketIter->firstIter ();
+            while ( iter.valid () ) {
+                if ( iter->selected ( select ) ) {
+	                // get a new block if we havent exceeded quotas
+	                bool full = ( iter->numEventsQueued() >= individualEventEntries ) 
+                                || this->full ();
+	                casMonEvent * pLog;
+	                if ( ! full ) {
+                        // should I get rid of this try block by implementing a no 
+                        // throw version of the free list alloc? However, crude
+                        // tests on windows with ms visual C++ dont appear to argue
+                        // against the try block.
+                        try {
+                            pLog = new ( this->casMonEventFreeList ) 
+                                casMonEvent ( *iter, event, posted );
+                        }
+                        catch ( ... ) {
+                            pLog = 0;
+                        }
+	                }
+	                else {
+		                pLog = 0;
+	                }
+                	
+                    signalNeeded |= 
+                        !this->dontProcessSubscr && 
+                        this->eventLogQue.count() == 0 &&
+                        this->ioQue.count() == 0;
+
+                    iter->installNewEventLog ( 
+                        this->eventLogQue, pLog, event, posted );
+                }
+	            ++iter;
             }
-	        ++iter;
+            ++bucketIter;
+        }
+        if ( this->eventLogQue.count () > this->queueDepthMax ) {
+            this->queueDepthMax = this->eventLogQue.count ();
         }
     }
     return signalNeeded;
 }
 
+//
+// returns the deepest that the event queue has been since
+// the last call
+//
+unsigned casEventSys::takeQueueDepthMax ()
+{
+    epicsGuard < epicsMutex > guard ( this->mutex );
+    unsigned depth = this->queueDepthMax;
+    this->queueDepthMax = this->eventLogQue.count ();
+    return depth;
+}
+
+unsigned casEventSys::eventQueueDepth () const
+{
+    epicsGuard < epicsMutex > guard ( this->mutex );
+    return this->eventLogQue.count ();
+}
+
+void casEventSys::setEventQueueLimit ( unsigned limit )
+{
+    epicsGuard < epicsMutex > guard ( this->mutex );
+    this->eventQueueLimit = limit;
+}
+
+//
+// seconds that the client has had events turned off, including
+// any period in progress
+//
+double casEventSys::flowControlDelay ( const epicsTime & current ) const
+{
+    epicsGuard < epicsMutex > guard ( this->mutex );
+    double delay = this->flowControlTotal;
+    if ( this->replaceEvents ) {
+        delay += current - this->flowControlBegin;
+    }
+    return delay;
+}
+
 void casEventSys::casMonEventDestroy ( 
     casMonEvent & ev, epicsGuard < evSysMutex > & guard )
 {
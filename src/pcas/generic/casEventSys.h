@@ -52,6 +52,7 @@
 enum casProcCond { casProcOk, casProcDisconnect };
 
 class casMonitor;
+class casMonitorSet;
 class casMonEvent;
 class casCoreClient;
 
@@ -68,8 +69,9 @@ public:
 	void installMonitor ();
 	void removeMonitor ();
     void prepareMonitorForDestroy ( casMonitor & mon );
-    bool postEvent ( tsDLList < casMonitor > & monitorList, 
-        const casEventMask & select, const gdd & event );
+    bool postEvent ( casMonitorSet & monitorSet, 
+        const casEventMask & select, const gdd & event,
+        epicsUInt64 posted );
 	caStatus addToEventQueue ( class casAsyncIOI &, 
         bool & onTheQueue, bool & posted, bool & signalNeeded );
     void removeFromEventQueue ( class casAsyncIOI &, 
@@ -85,6 +87,10 @@ public:
 	bool eventsOff ();
     void casMonEventDestroy ( 
         casMonEvent &, epicsGuard < evSysMutex > & );
+    unsigned takeQueueDepthMax ();
+    unsigned eventQueueDepth () const;
+    void setEventQueueLimit ( unsigned limit );
+    double flowControlDelay ( const epicsTime & current ) const;
 private:
     mutable evSysMutex mutex;
 	tsDLList < casEvent > eventLogQue;
@@ -94,6 +100,10 @@ private:
 	class casEventPurgeEv * pPurgeEvent; // flow control purge complete event
 	unsigned numSubscriptions; // N subscriptions installed
 	unsigned maxLogEntries; // max log entries
+    unsigned queueDepthMax; // event queue high water since last taken
+    unsigned eventQueueLimit; // zero if only maxLogEntries applies
+    epicsTime flowControlBegin; // when the client last turned events off
+    double flowControlTotal; // seconds in flow control before that
 	bool destroyPending;
 	bool replaceEvents; // replace last existing event on queue
 	bool dontProcessSubscr; // flow ctl is on - dont process subscr event queue
@@ -131,6 +141,9 @@ inline casEventSys::casEventSys ( casCoreClient & clientIn ) :
 	pPurgeEvent ( NULL ),
 	numSubscriptions ( 0u ),
 	maxLogEntries ( individualEventEntries ),
+    queueDepthMax ( 0u ),
+    eventQueueLimit ( 0u ),
+    flowControlTotal ( 0.0 ),
 	destroyPending ( false ),
 	replaceEvents ( false ), 
 	dontProcessSubscr ( false ) 
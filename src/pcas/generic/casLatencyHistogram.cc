@@ -0,0 +1,163 @@
+/*************************************************************************\
+* Copyright (c) 2002 The University of Chicago, as Operator of Argonne
+*     National Laboratory.
+* Copyright (c) 2002 The Regents of the University of California, as
+*     Operator of Los Alamos National Laboratory.
+* EPICS BASE is distributed subject to a Software License Agreement found
+* in file LICENSE that is included with this distribution.
+\*************************************************************************/
+
+#include <stdio.h>
+#include <string.h>
+#include <limits.h>
+#include <math.h>
+
+#define epicsExportSharedSymbols
+#include "casLatencyHistogram.h"
+
+casLatencyHistogram::casLatencyHistogram ()
+{
+    this->clear ();
+}
+
+casLatencyHistogram::casLatencyHistogram ( const casLatencyHistogram & rhs )
+{
+    this->copy ( rhs );
+}
+
+casLatencyHistogram & casLatencyHistogram::operator = ( 
+    const casLatencyHistogram & rhs )
+{
+    if ( this != & rhs ) {
+        this->copy ( rhs );
+    }
+    return *this;
+}
+
+//
+// the total is taken from the buckets copied so that the two agree
+// when samples are being recorded into the source
+//
+void casLatencyHistogram::copy ( const casLatencyHistogram & rhs )
+{
+    this->total = 0;
+    for ( unsigned i = 0u; i < nBuckets; i++ ) {
+        int n = epicsAtomicGetIntT ( & rhs.bucket[i] );
+        if ( n > INT_MAX - this->total ) {
+            n = INT_MAX - this->total;
+        }
+        this->bucket[i] = n;
+        this->total += n;
+    }
+}
+
+void casLatencyHistogram::clear ()
+{
+    memset ( this->bucket, '\0', sizeof ( this->bucket ) );
+    this->total = 0u;
+}
+
+unsigned casLatencyHistogram::bucketIndex ( double delay )
+{
+    if ( delay <= 0.0 ) {
+        return 0u;
+    }
+    double uSec = delay * 1e6;
+    if ( uSec >= 2147483648.0 ) {
+        return nBuckets - 1u;
+    }
+    unsigned tics = static_cast < unsigned > ( uSec );
+    if ( tics < 4u ) {
+        return tics;
+    }
+    unsigned msb = 2u;
+    while ( tics >> ( msb + 1u ) ) {
+        msb++;
+    }
+    unsigned sub = ( tics >> ( msb - 2u ) ) & 3u;
+    return 4u * ( msb - 1u ) + sub;
+}
+
+double casLatencyHistogram::bucketLimit ( unsigned index )
+{
+    if ( index >= nBuckets - 1u ) {
+        return HUGE_VAL;
+    }
+    if ( index < 4u ) {
+        return ( index + 1u ) * 1e-6;
+    }
+    unsigned msb = index / 4u + 1u;
+    unsigned sub = index % 4u;
+    return ldexp ( 5.0 + sub, msb - 2u ) * 1e-6;
+}
+
+//
+// The counts stop short of INT_MAX, but not exactly when threads
+// record at once.
+//
+void casLatencyHistogram::record ( double delay )
+{
+    unsigned index = bucketIndex ( delay );
+    if ( epicsAtomicGetIntT ( & this->total ) < INT_MAX - 1024 ) {
+        epicsAtomicIncrIntT ( & this->bucket[index] );
+        epicsAtomicIncrIntT ( & this->total );
+    }
+}
+
+//
+// adds a copy, which isnt written by other threads, into this 
+// histogram, which also isnt
+//
+void casLatencyHistogram::add ( const casLatencyHistogram & rhs )
+{
+    for ( unsigned i = 0u; i < nBuckets; i++ ) {
+        int n = rhs.bucket[i];
+        if ( n > INT_MAX - this->total ) {
+            n = INT_MAX - this->total;
+        }
+        this->bucket[i] += n;
+        this->total += n;
+    }
+}
+
+double casLatencyHistogram::percentile ( double fraction ) const
+{
+    if ( this->count () == 0u ) {
+        return 0.0;
+    }
+    double threshold = fraction * this->count ();
+    unsigned sum = 0u;
+    for ( unsigned i = 0u; i < nBuckets; i++ ) {
+        sum += this->bucketCount ( i );
+        if ( sum > 0u && sum >= threshold ) {
+            return bucketLimit ( i );
+        }
+    }
+    return bucketLimit ( nBuckets - 1u );
+}
+
+void casLatencyHistogram::show ( const char * pLabel, unsigned level ) const
+{
+    if ( this->count () == 0u ) {
+        printf ( "\t%s latency: no samples\n", pLabel );
+        return;
+    }
+    unsigned last = 0u;
+    for ( unsigned i = 0u; i < nBuckets; i++ ) {
+        if ( this->bucketCount ( i ) ) {
+            last = i;
+        }
+    }
+    printf ( "\t%s latency: n=%u p50<%.3g p90<%.3g p99<%.3g max<%.3g sec\n",
+        pLabel, this->count (), this->percentile ( 0.5 ),
+        this->percentile ( 0.9 ), this->percentile ( 0.99 ),
+        bucketLimit ( last ) );
+    if ( level > 2u ) {
+        for ( unsigned i = 0u; i < nBuckets; i++ ) {
+            if ( this->bucketCount ( i ) ) {
+                printf ( "\t\t< %10.3g sec %u\n",
+                    bucketLimit ( i ), this->bucketCount ( i ) );
+            }
+        }
+    }
+}
@@ -0,0 +1,100 @@
+/*************************************************************************\
+* Copyright (c) 2002 The University of Chicago, as Operator of Argonne
+*     National Laboratory.
+* Copyright (c) 2002 The Regents of the University of California, as
+*     Operator of Los Alamos National Laboratory.
+* EPICS BASE Versions 3.13.7
+* and higher are distributed subject to a Software License Agreement found
+* in file LICENSE that is included with this distribution.
+\*************************************************************************/
+#ifndef casLatencyHistogramh
+#define casLatencyHistogramh
+
+#ifdef epicsExportSharedSymbols
+#   define epicsExportSharedSymbols_casLatencyHistogramh
+#   undef epicsExportSharedSymbols
+#endif
+
+#include "epicsTime.h"
+#include "epicsAtomic.h"
+
+#ifdef epicsExportSharedSymbols_casLatencyHistogramh
+#   define epicsExportSharedSymbols
+#   include "shareLib.h"
+#endif
+
+//
+// casLatencyHistogram
+//
+// A log-linear histogram of delays with a resolution of one micro
+// second. Below 4 uS there is one bucket per micro second, and above
+// that each power of two is divided into four buckets, so that a
+// delay is known to within 25%. Delays longer than 2^31 uS (about
+// 36 minutes) are counted in the last bucket.
+//
+// The counts are incremented with atomic operations, and so the
+// threads servicing several clients may record into the same
+// histogram without a lock. A copy made while samples are being
+// recorded might be missing some of them, but its total is always
+// the sum of its buckets.
+//
+class epicsShareClass casLatencyHistogram {
+public:
+    enum { nBuckets = 121u };
+    casLatencyHistogram ();
+    casLatencyHistogram ( const casLatencyHistogram & );
+    casLatencyHistogram & operator = ( const casLatencyHistogram & );
+    void record ( double delay ); // seconds
+    // times from epicsMonotonicGet() (nano seconds)
+    void record ( epicsUInt64 begin, epicsUInt64 end );
+    void add ( const casLatencyHistogram & );
+    void clear ();
+    unsigned count () const;
+    unsigned bucketCount ( unsigned bucket ) const;
+    // upper limit of the delays counted in a bucket (seconds)
+    static double bucketLimit ( unsigned bucket );
+    // the delay below which the fraction specified of the samples lie
+    double percentile ( double fraction ) const;
+    void show ( const char * pLabel, unsigned level ) const;
+private:
+    int bucket[nBuckets];
+    int total;
+    static unsigned bucketIndex ( double delay );
+    void copy ( const casLatencyHistogram & );
+};
+
+//
+// used with caServer::clientLatency() to visit each client
+//
+class epicsShareClass casClientLatencyVisitor {
+public:
+    //
+    // encode - from casPV::postEvent() until the update is in the
+    //      client's output queue
+    // wire - from casPV::postEvent() until the update is sent
+    //
+    virtual void clientLatency ( const char * pHostName,
+        const char * pUserName, const casLatencyHistogram & encode,
+        const casLatencyHistogram & wire ) = 0;
+protected:
+    virtual ~casClientLatencyVisitor () {}
+};
+
+inline void casLatencyHistogram::record (
+    epicsUInt64 begin, epicsUInt64 end )
+{
+    this->record ( end > begin ? ( end - begin ) * 1e-9 : 0.0 );
+}
+
+inline unsigned casLatencyHistogram::count () const
+{
+    return static_cast < unsigned > ( epicsAtomicGetIntT ( & this->total ) );
+}
+
+inline unsigned casLatencyHistogram::bucketCount ( unsigned index ) const
+{
+    return index < nBuckets ? static_cast < unsigned > ( 
+        epicsAtomicGetIntT ( & this->bucket[index] ) ) : 0u;
+}
+
+#endif // casLatencyHistogramh
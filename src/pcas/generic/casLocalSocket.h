@@ -0,0 +1,107 @@
+/*************************************************************************\
+* Copyright (c) 2002 The University of Chicago, as Operator of Argonne
+*     National Laboratory.
+* Copyright (c) 2002 The Regents of the University of California, as
+*     Operator of Los Alamos National Laboratory.
+* EPICS BASE Versions 3.13.7
+* and higher are distributed subject to a Software License Agreement found
+* in file LICENSE that is included with this distribution.
+\*************************************************************************/
+#ifndef casLocalSocketh
+#define casLocalSocketh
+
+#include "epicsTypes.h"
+
+//
+// Clients on the same host may connect to the server through a Unix
+// domain stream socket, in addition to its TCP port, if the environment
+// variable EPICS_CAS_LOCAL_SOCKET is set. The CA protocol on the
+// socket is the same as on the TCP port.
+//
+// EPICS_CAS_LOCAL_SOCKET=YES
+//      The name of the socket is CAS_LOCAL_SOCKET_NAME, formatted with
+//      the server's TCP port. A client which found the server with a
+//      search request from the same host (or was configured with its
+//      port) connects to this name instead of to the TCP port.
+// EPICS_CAS_LOCAL_SOCKET=<name>
+//      The name of the socket.
+//
+// A name beginning with '@' is in the Linux abstract socket namespace,
+// where the '@' is replaced by a nul character, and is removed by the
+// kernel when the server exits. Any other name is a file which the
+// server creates, and removes when it exits.
+//
+// The clients trust whoever listens on the name. Any process on the
+// host may bind an abstract name, or a file in a world writable
+// directory such as /tmp, before the server does, and would then
+// receive the local clients and answer for the server's PVs. An
+// abstract name has no permissions, and any local user may connect
+// to it. A file is created with the server's umask, and /tmp files
+// may be removed by other users unless the sticky bit is set. Where
+// that matters give a name in a directory which only the server and
+// its clients may write. The server reports a name that it finds in
+// use by anything but itself.
+//
+#if defined ( __unix__ ) || defined ( __unix ) || \
+        ( defined ( __APPLE__ ) && defined ( __MACH__ ) )
+#   define CAS_LOCAL_SOCKET_SUPPORTED
+#endif
+
+#if defined ( __linux__ )
+#   define CAS_LOCAL_SOCKET_NAME "@EPICS_CA_%u"
+#else
+#   define CAS_LOCAL_SOCKET_NAME "/tmp/EPICS_CA_%u"
+#endif
+
+//
+// Shared memory ring
+//
+// A client connected to the local socket may have the server write
+// the responses, and the subscription updates, into a ring in shared
+// memory instead of into the socket. With the first bytes that it
+// sends the client passes three file descriptors in an SCM_RIGHTS
+// message:
+//
+//  1) a memfd, of at least CAS_LOCAL_RING_DATA_OFFSET plus the size
+//     of the ring bytes, sealed with F_SEAL_SHRINK, which begins with
+//     a casLocalRingHeader initialized by the client
+//  2) an eventfd written by the server when the client is waiting
+//     for data
+//  3) an eventfd written by the client when the server is waiting
+//     for space
+//
+// The server sets "attached" if it accepts the ring, and from then on
+// sends nothing through the socket. The bytes in the ring are the
+// same CA messages which would otherwise be sent through the socket.
+// The server advances "head" after it writes bytes at head modulo
+// size, and the client advances "tail" after it has read them. The
+// counts roll over. Before blocking on its eventfd each side sets its
+// waiting flag, and checks the other side's index again, and the
+// other side clears the flag before writing the eventfd. When the
+// ring is full the server stops sending to the client, and the CA
+// flow control applies as it does when a socket is full.
+//
+#if defined ( __linux__ ) && defined ( __GNUC__ ) && \
+        defined ( CAS_LOCAL_SOCKET_SUPPORTED )
+#   define CAS_LOCAL_RING_SUPPORTED
+#endif
+
+#define CAS_LOCAL_RING_MAGIC 0x43415352 // "CASR"
+#define CAS_LOCAL_RING_VERSION 1u
+#define CAS_LOCAL_RING_DATA_OFFSET 4096u
+
+struct casLocalRingHeader {
+    epicsUInt32 magic; // CAS_LOCAL_RING_MAGIC
+    epicsUInt32 version; // CAS_LOCAL_RING_VERSION
+    epicsUInt32 size; // bytes of data, a power of two
+    volatile epicsUInt32 attached; // set by the server
+    char pad0[48];
+    volatile epicsUInt32 head; // written by the server
+    volatile epicsUInt32 clientWaiting;
+    char pad1[56];
+    volatile epicsUInt32 tail; // written by the client
+    volatile epicsUInt32 serverWaiting;
+    char pad2[56];
+};
+
+#endif // casLocalSocketh
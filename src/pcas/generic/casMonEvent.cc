@@ -32,15 +32,19 @@ caStatus casMonEvent::cbFunc (
         clientGuard, evGuard );
 }
 
-void casMonEvent::assign ( const gdd & valueIn )
+void casMonEvent::assign ( const gdd & valueIn, epicsUInt64 postedIn )
 {
 	this->pValue = & valueIn;
+    this->posted = postedIn;
 }
 
 void casMonEvent::swapValues ( casMonEvent & in )
 {
     assert ( & in.monitor == & this->monitor );
     this->pValue.swap ( in.pValue );
+    epicsUInt64 tmp = this->posted;
+    this->posted = in.posted;
+    in.posted = tmp;
 }
 
 casMonEvent::~casMonEvent ()
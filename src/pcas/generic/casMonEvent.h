@@ -22,6 +22,7 @@
 #endif
 
 #include "tsFreeList.h"
+#include "epicsTime.h"
 #include "smartGDDPointer.h"
 
 #ifdef epicsExportSharedSymbols_casMonEventh
@@ -34,11 +35,13 @@
 class casMonEvent : public casEvent {
 public:
 	casMonEvent ( class casMonitor & monitor );
-	casMonEvent ( class casMonitor & monitor, const gdd & value );
+	casMonEvent ( class casMonitor & monitor, const gdd & value,
+        epicsUInt64 posted );
 	~casMonEvent ();
     void clear ();
-	void assign ( const gdd & value );
+	void assign ( const gdd & value, epicsUInt64 posted );
     void swapValues ( casMonEvent & );
+    epicsUInt64 postTime () const;
     void * operator new ( size_t size, 
         tsFreeList < casMonEvent, 1024, epicsMutexNOOP > & );
     epicsPlacementDeleteOperator (( void *, 
@@ -46,6 +49,7 @@ public:
 private:
     class casMonitor & monitor;
 	smartConstGDDPointer pValue;
+    epicsUInt64 posted; // epicsMonotonicGet() when casPV::postEvent() was called
     void operator delete ( void * );
 	caStatus cbFunc ( 
         casCoreClient &, 
@@ -56,17 +60,23 @@ private:
 };
 
 inline casMonEvent::casMonEvent ( class casMonitor & monitorIn ) :
-    monitor ( monitorIn ) {}
+    monitor ( monitorIn ), posted ( 0u ) {}
 
 inline casMonEvent::casMonEvent ( 
-    class casMonitor & monitorIn, const gdd & value ) :
-        monitor ( monitorIn ), pValue ( value ) {}
+    class casMonitor & monitorIn, const gdd & value,
+    epicsUInt64 postedIn ) :
+        monitor ( monitorIn ), pValue ( value ), posted ( postedIn ) {}
 
 inline void casMonEvent::clear ()
 {
     this->pValue.set ( 0 );
 }
 
+inline epicsUInt64 casMonEvent::postTime () const
+{
+    return this->posted;
+}
+
 inline void * casMonEvent::operator new ( size_t size, 
     tsFreeList < class casMonEvent, 1024, epicsMutexNOOP > & freeList )
 {
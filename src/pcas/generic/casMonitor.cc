@@ -28,6 +28,8 @@ casMonitor::casMonitor (
 	    const casEventMask & maskIn, 
         casMonitorCallbackInterface & cb ) :
     overFlowEvent ( *this ),
+    pNextSameHash ( 0 ),
+    pBucket ( 0 ),
 	nElem ( nElemIn ),
 	pChannel ( & chan ),
     callBackIntf ( cb ),
@@ -67,11 +69,12 @@ caStatus casMonitor::response (
 
 void casMonitor::installNewEventLog ( 
     tsDLList < casEvent > & eventLogQue, 
-    casMonEvent * pLog, const gdd & event )
+    casMonEvent * pLog, const gdd & event,
+    epicsUInt64 posted )
 {
 	if ( this->ovf ) {
 		if ( pLog ) {
-            pLog->assign ( event );
+            pLog->assign ( event, posted );
             this->overFlowEvent.swapValues ( *pLog );
 			eventLogQue.insertAfter ( *pLog, this->overFlowEvent );
             assert ( this->nPend != UCHAR_MAX );
@@ -79,7 +82,7 @@ void casMonitor::installNewEventLog (
 		}
 		else {
 			// replace the old OVF value with the current one
-			this->overFlowEvent.assign ( event );
+			this->overFlowEvent.assign ( event, posted );
 		}
         // remove OVF entry (with its new value) from the queue so
         // that it ends up properly ordered at the back of the
@@ -93,7 +96,7 @@ void casMonitor::installNewEventLog (
 		    this->ovf = true;
  		    pLog = & this->overFlowEvent;
         }
-        pLog->assign ( event );
+        pLog->assign ( event, posted );
         assert ( this->nPend != UCHAR_MAX );
 		this->nPend++;
     }
@@ -111,6 +114,8 @@ caStatus casMonitor::executeEvent ( casCoreClient & client,
 	    if ( status != S_cas_success ) {
             return status;
         }
+        client.subscriptionEncoded ( 
+            this->pChannel->getPVI (), ev.postTime () );
     }
 
     client.getCAS().incrEventsProcessedCounter ();
@@ -56,10 +56,13 @@ public:
     void markDestroyPending ();
     void installNewEventLog ( 
         tsDLList < casEvent > & eventLogQue, 
-        casMonEvent * pLog, const gdd & event );
+        casMonEvent * pLog, const gdd & event,
+        epicsUInt64 posted );
     void show ( unsigned level ) const;
     bool selected ( const casEventMask & select ) const;
     bool matchingClientId ( caResId clientIdIn ) const;
+    caResId getClientId () const;
+    const casEventMask & getMask () const;
     unsigned numEventsQueued () const;
     caStatus response ( 
         epicsGuard < casClientMutex > &, casCoreClient & client,
@@ -74,6 +77,8 @@ public:
         tsFreeList < casMonitor, 1024 > & ))
 private:
 	casMonEvent overFlowEvent;
+    casMonitor * pNextSameHash; // casMonitorSet id hash chain
+    class casMonitorBucket * pBucket; // casMonitorSet event mask bucket
 	ca_uint32_t const nElem;
 	casChannelI * pChannel;
     casMonitorCallbackInterface & callBackIntf;
@@ -86,6 +91,7 @@ private:
     void operator delete ( void * );
 	casMonitor ( const casMonitor & );
 	casMonitor & operator = ( const casMonitor & );
+    friend class casMonitorSet;
 };
 
 inline unsigned casMonitor::numEventsQueued () const
@@ -102,6 +108,16 @@ inline bool casMonitor::matchingClientId ( caResId clientIdIn ) const
     return clientIdIn == this->clientId;
 }
 
+inline caResId casMonitor::getClientId () const
+{
+    return this->clientId;
+}
+
+inline const casEventMask & casMonitor::getMask () const
+{
+    return this->mask;
+}
+
 inline bool casMonitor::selected ( const casEventMask & select ) const
 {
     casEventMask result ( select & this->mask );
@@ -0,0 +1,177 @@
+/*************************************************************************\
+* Copyright (c) 2002 The University of Chicago, as Operator of Argonne
+*     National Laboratory.
+* Copyright (c) 2002 The Regents of the University of California, as
+*     Operator of Los Alamos National Laboratory.
+* EPICS BASE is distributed subject to a Software License Agreement found
+* in file LICENSE that is included with this distribution.
+\*************************************************************************/
+
+#include <new>
+#include <string.h>
+
+#include "errlog.h"
+
+#define epicsExportSharedSymbols
+#include "caServerDefs.h"
+#include "casMonitorSet.h"
+
+static const unsigned casMonitorSetMinIdTableBits = 3u;
+static const unsigned casMonitorSetMaxIdTableBits = 16u;
+
+casMonitorSet::casMonitorSet () :
+    pIdTable ( 0 ), idTableBits ( 0u ), nMonitors ( 0u )
+{
+}
+
+casMonitorSet::~casMonitorSet ()
+{
+    // the channel removes all of its subscriptions before
+    // it is destroyed
+    casVerify ( this->nMonitors == 0u );
+    while ( casMonitorBucket * pBucket = this->bucketList.get () ) {
+        delete pBucket;
+    }
+    delete [] this->pIdTable;
+}
+
+//
+// throws std::bad_alloc if a new bucket is needed and
+// there isnt memory for it, in which case the set is
+// not modified
+//
+void casMonitorSet::add ( casMonitor & mon )
+{
+    if ( ! this->pIdTable || 
+            this->nMonitors >= ( 1u << this->idTableBits ) ) {
+        this->growIdTable ();
+    }
+
+    casMonitorBucket * pBucket = 0;
+    tsDLIter < casMonitorBucket > iter = this->bucketList.firstIter ();
+    while ( iter.valid () ) {
+        if ( iter->matchingMask ( mon.getMask () ) ) {
+            pBucket = iter.pointer ();
+            break;
+        }
+        iter++;
+    }
+    if ( ! pBucket ) {
+        pBucket = new casMonitorBucket ( mon.getMask () );
+        this->bucketList.add ( *pBucket );
+    }
+
+    pBucket->monitorList.add ( mon );
+    mon.pBucket = pBucket;
+
+    unsigned index = this->hash ( mon.getClientId () );
+    mon.pNextSameHash = this->pIdTable[index];
+    this->pIdTable[index] = & mon;
+
+    this->nMonitors++;
+}
+
+casMonitor * casMonitorSet::remove ( caResId clientIdIn )
+{
+    if ( ! this->pIdTable ) {
+        return 0;
+    }
+    casMonitor ** ppMon = & this->pIdTable[ this->hash ( clientIdIn ) ];
+    while ( casMonitor * pMon = *ppMon ) {
+        if ( pMon->matchingClientId ( clientIdIn ) ) {
+            *ppMon = pMon->pNextSameHash;
+            pMon->pNextSameHash = 0;
+            casMonitorBucket * pBucket = pMon->pBucket;
+            pMon->pBucket = 0;
+            pBucket->monitorList.remove ( *pMon );
+            if ( pBucket->monitorList.count () == 0u ) {
+                this->bucketList.remove ( *pBucket );
+                delete pBucket;
+            }
+            assert ( this->nMonitors > 0u );
+            this->nMonitors--;
+            return pMon;
+        }
+        ppMon = & pMon->pNextSameHash;
+    }
+    return 0;
+}
+
+void casMonitorSet::removeAll ( tsDLList < casMonitor > & dest )
+{
+    while ( casMonitorBucket * pBucket = this->bucketList.get () ) {
+        tsDLIter < casMonitor > iter = pBucket->monitorList.firstIter ();
+        while ( iter.valid () ) {
+            iter->pNextSameHash = 0;
+            iter->pBucket = 0;
+            iter++;
+        }
+        pBucket->monitorList.removeAll ( dest );
+        delete pBucket;
+    }
+    delete [] this->pIdTable;
+    this->pIdTable = 0;
+    this->idTableBits = 0u;
+    this->nMonitors = 0u;
+}
+
+//
+// If there isnt memory for a larger table we continue
+// with the current one (and longer hash chains)
+//
+void casMonitorSet::growIdTable ()
+{
+    unsigned newBits = this->idTableBits + 1u;
+    if ( newBits < casMonitorSetMinIdTableBits ) {
+        newBits = casMonitorSetMinIdTableBits;
+    }
+    if ( this->pIdTable && newBits > casMonitorSetMaxIdTableBits ) {
+        return;
+    }
+    unsigned newSize = 1u << newBits;
+    casMonitor ** pNewTable = new ( std::nothrow ) casMonitor * [newSize];
+    if ( ! pNewTable ) {
+        if ( this->pIdTable ) {
+            return;
+        }
+        throw std::bad_alloc ();
+    }
+    memset ( pNewTable, '\0', newSize * sizeof ( *pNewTable ) );
+
+    casMonitor ** pOldTable = this->pIdTable;
+    unsigned oldSize = pOldTable ? 1u << this->idTableBits : 0u;
+    this->pIdTable = pNewTable;
+    this->idTableBits = newBits;
+    for ( unsigned i = 0u; i < oldSize; i++ ) {
+        casMonitor * pMon = pOldTable[i];
+        while ( pMon ) {
+            casMonitor * pNext = pMon->pNextSameHash;
+            unsigned index = this->hash ( pMon->getClientId () );
+            pMon->pNextSameHash = pNewTable[index];
+            pNewTable[index] = pMon;
+            pMon = pNext;
+        }
+    }
+    delete [] pOldTable;
+}
+
+void casMonitorSet::show ( unsigned level ) const
+{
+    if ( level > 0 && this->nMonitors ) {
+        printf ( "List of subscriptions attached\n" );
+        tsDLIterConst < casMonitorBucket > bucketIter =
+            this->bucketList.firstIter ();
+        while ( bucketIter.valid () ) {
+            if ( level > 1u ) {
+                bucketIter->mask.show ( level );
+            }
+            tsDLIterConst < casMonitor > iter =
+                bucketIter->firstIter ();
+            while ( iter.valid () ) {
+                iter->show ( level - 1 );
+                ++iter;
+            }
+            ++bucketIter;
+        }
+    }
+}
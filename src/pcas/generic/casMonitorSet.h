@@ -0,0 +1,123 @@
+/*************************************************************************\
+* Copyright (c) 2002 The University of Chicago, as Operator of Argonne
+*     National Laboratory.
+* Copyright (c) 2002 The Regents of the University of California, as
+*     Operator of Los Alamos National Laboratory.
+* EPICS BASE is distributed subject to a Software License Agreement found
+* in file LICENSE that is included with this distribution.
+\*************************************************************************/
+
+#ifndef casMonitorSeth
+#define casMonitorSeth
+
+#ifdef epicsExportSharedSymbols
+#   define epicsExportSharedSymbols_casMonitorSeth
+#   undef epicsExportSharedSymbols
+#endif
+
+#include "tsDLList.h"
+
+#ifdef epicsExportSharedSymbols_casMonitorSeth
+#   define epicsExportSharedSymbols
+#   include "shareLib.h"
+#endif
+
+#include "casMonitor.h"
+
+//
+// casMonitorBucket
+//
+// the subscriptions on one channel that share the same event mask
+//
+class casMonitorBucket : public tsDLNode < casMonitorBucket > {
+public:
+    casMonitorBucket ( const casEventMask & maskIn );
+    bool selected ( const casEventMask & select ) const;
+    bool matchingMask ( const casEventMask & maskIn ) const;
+    tsDLIter < casMonitor > firstIter ();
+    tsDLIterConst < casMonitor > firstIter () const;
+private:
+    tsDLList < casMonitor > monitorList;
+    const casEventMask mask;
+    casMonitorBucket ( const casMonitorBucket & );
+    casMonitorBucket & operator = ( const casMonitorBucket & );
+    friend class casMonitorSet;
+};
+
+//
+// casMonitorSet
+//
+// The subscriptions installed on a channel. They are hashed on
+// the client's subscription id so that an event cancel does not
+// search, and they are grouped into one bucket per distinct event
+// mask so that posting an event only visits subscribers whose
+// mask matches.
+//
+// The PV's lock protects this data structure.
+//
+class casMonitorSet {
+public:
+    casMonitorSet ();
+    ~casMonitorSet ();
+    void add ( casMonitor & );
+    casMonitor * remove ( caResId clientIdIn );
+    void removeAll ( tsDLList < casMonitor > & dest );
+    unsigned count () const;
+    tsDLIter < casMonitorBucket > firstBucketIter ();
+    void show ( unsigned level ) const;
+private:
+    tsDLList < casMonitorBucket > bucketList;
+    casMonitor ** pIdTable;
+    unsigned idTableBits;
+    unsigned nMonitors;
+    unsigned hash ( caResId clientIdIn ) const;
+    void growIdTable ();
+    casMonitorSet ( const casMonitorSet & );
+    casMonitorSet & operator = ( const casMonitorSet & );
+};
+
+inline casMonitorBucket::casMonitorBucket ( const casEventMask & maskIn ) :
+    mask ( maskIn )
+{
+}
+
+inline bool casMonitorBucket::selected ( const casEventMask & select ) const
+{
+    casEventMask result ( select & this->mask );
+    return result.eventsSelected ();
+}
+
+inline bool casMonitorBucket::matchingMask ( const casEventMask & maskIn ) const
+{
+    return this->mask == maskIn;
+}
+
+inline tsDLIter < casMonitor > casMonitorBucket::firstIter ()
+{
+    return this->monitorList.firstIter ();
+}
+
+inline tsDLIterConst < casMonitor > casMonitorBucket::firstIter () const
+{
+    return this->monitorList.firstIter ();
+}
+
+inline unsigned casMonitorSet::count () const
+{
+    return this->nMonitors;
+}
+
+inline tsDLIter < casMonitorBucket > casMonitorSet::firstBucketIter ()
+{
+    return this->bucketList.firstIter ();
+}
+
+inline unsigned casMonitorSet::hash ( caResId clientIdIn ) const
+{
+    // Fibonacci hashing because clients usually
+    // allocate their subscription ids sequentially
+    return static_cast < unsigned > (
+        ( clientIdIn * 2654435761u ) >> ( 32u - this->idTableBits ) );
+}
+
+#endif // casMonitorSeth
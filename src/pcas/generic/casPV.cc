@@ -147,6 +147,24 @@ aitIndex casPV::maxBound (unsigned /* dimension */) const
 	return 1u;
 }
 
+//
+// casPV::coalesceReads()
+// (base does not share reads between clients)
+//
+bool casPV::coalesceReads () const
+{
+	return false;
+}
+
+//
+// casPV::cachePostedEvents()
+// (base reads the value from the server tool)
+//
+bool casPV::cachePostedEvents () const
+{
+	return false;
+}
+
 //
 // casPV::show (unsigned level) 
 //
@@ -164,6 +182,16 @@ void casPV::postEvent ( const casEventMask &select, const gdd &event )
     }
 }
 
+void casPV::subscriptionLatency ( casLatencyHistogram & dest ) const
+{
+    if ( this->pPVI ) {
+        this->pPVI->subscriptionLatency ( dest );
+    }
+    else {
+        dest.clear ();
+    }
+}
+
 //
 // Find the server associated with this PV
 // ****WARNING****
@@ -24,7 +24,10 @@
 #include "casPVI.h"
 #include "chanIntfForPV.h"
 #include "casAsyncIOI.h"
+#include "casAsyncReadIOI.h"
+#include "casCoalescedReadIOI.h"
 #include "casMonitor.h"
+#include "casMonitorSet.h"
 
 
 // Use casErrMessage instead of errMessage to show PV name
@@ -33,7 +36,9 @@
 
 casPVI::casPVI ( casPV & intf ) : 
 	pCAS ( NULL ), pPV ( & intf ), nMonAttached ( 0u ), 
-        nIOAttached ( 0u ), deletePending ( false ) {}
+        nIOAttached ( 0u ), deletePending ( false ), 
+        coalesceReads ( intf.coalesceReads () ),
+        cachePostedEvents ( intf.cachePostedEvents () ) {}
 
 casPVI::~casPVI ()
 {
@@ -72,6 +77,12 @@ void casPVI::casPVDestroyNotify ()
 {
     epicsGuard < epicsMutex > guard ( this->mutex );
     this->pPV = 0;
+    {
+        // reads must no longer be answered from the cache
+        epicsGuard < epicsMutex > cacheGuard ( this->cacheMutex );
+        this->pLastValueEvent = 0;
+        this->pPropertyCache = 0;
+    }
     if ( ! this->deletePending ) {
         // last channel to be destroyed destroys the casPVI
         tsDLIter < chanIntfForPV > iter = this->chanList.firstIter ();
@@ -277,28 +288,46 @@ void casPVI::postEvent ( const casEventMask & select, const gdd & event )
             menu = event.getDD( gddAppTypeIndex_dbr_ctrl_enum_enums );
         if ( menu )
             updateEnumStringTableAsyncCompletion( *menu );
+        // the limits, units, and precision for the
+        // value only events that follow
+        if ( event.isContainer() ) {
+            epicsGuard < epicsMutex > cacheGuard ( this->cacheMutex );
+            this->pPropertyCache = & event;
+        }
+    }
+
+    if ( this->cachePostedEvents ) {
+        casEventMask valueSelect = this->pCAS->valueEventMask () |
+            this->pCAS->logEventMask () | this->pCAS->alarmEventMask ();
+        if ( ( select & valueSelect ).eventsSelected () ) {
+            epicsGuard < epicsMutex > cacheGuard ( this->cacheMutex );
+            this->pLastValueEvent = & event;
+        }
     }
 
 	if ( this->nMonAttached ) {
         // we are paying some significant locking overhead for
         // these diagnostic counters
         this->pCAS->updateEventsPostedCounter ( this->nMonAttached );
+        // one time stamp for all subscribers so that the
+        // latency histograms measure from the same instant
+        epicsUInt64 posted = epicsMonotonicGet ();
 	    tsDLIter < chanIntfForPV > iter = this->chanList.firstIter ();
         while ( iter.valid () ) {
-		    iter->postEvent ( select, event );
+		    iter->postEvent ( select, event, posted );
 		    ++iter;
 	    }
 	}
 }
 
 caStatus casPVI::installMonitor ( 
-    casMonitor & mon, ::tsDLList < casMonitor > & monitorList )
+    casMonitor & mon, casMonitorSet & monitorSet )
 {
     epicsGuard < epicsMutex > guard ( this->mutex );
     assert ( this->nMonAttached < UINT_MAX );
+    // use pv lock to protect channel's monitor set
+	monitorSet.add ( mon );
 	this->nMonAttached++;
-    // use pv lock to protect channel's monitor list
-	monitorList.add ( mon );
     if ( this->nMonAttached == 1u && this->pPV ) {
 		return this->pPV->interestRegister ();
     }
@@ -308,26 +337,14 @@ caStatus casPVI::installMonitor (
 }
 
 casMonitor * casPVI::removeMonitor ( 
-    ::tsDLList < casMonitor > & list, ca_uint32_t clientIdIn )
+    casMonitorSet & monitorSet, ca_uint32_t clientIdIn )
 {
     epicsGuard < epicsMutex > guard ( this->mutex );
-    casMonitor * pMon = 0;
-	//
-	// (it is reasonable to do a linear search here because
-	// sane clients will require only one or two monitors 
-	// per channel)
-	//
-	tsDLIter < casMonitor > iter = list.firstIter ();
-    while ( iter.valid () ) {
-		if ( iter->matchingClientId ( clientIdIn ) ) {
-            list.remove ( *iter.pointer () );
-            assert ( this->nMonAttached > 0 );
-	        this->nMonAttached--;
-            pMon = iter.pointer ();
-            break;
-		}
-		iter++;
-	}
+    casMonitor * pMon = monitorSet.remove ( clientIdIn );
+    if ( pMon ) {
+        assert ( this->nMonAttached > 0 );
+        this->nMonAttached--;
+    }
     if ( this->nMonAttached == 0u && this->pPV ) {
         this->pPV->interestDelete ();
     }
@@ -352,12 +369,30 @@ void casPVI::show ( unsigned level )  const
 		this->chanList.count(), this->nMonAttached, this->nIOAttached );
 	if ( level >= 1u ) {
 		printf ( "\tBest external type = %d\n", this->bestExternalType() );
+        if ( this->coalesceReads ) {
+            printf ( "\tReads in flight = %u\n", this->readsInFlight.count() );
+        }
+        casLatencyHistogram encode;
+        this->subscriptionLatency ( encode );
+        if ( encode.count () ) {
+            encode.show ( "Subscription encode", level );
+        }
 	}
 	if ( level >= 2u ) {
         this->pPV->show ( level - 2u );
 	}
 }
 
+void casPVI::recordEncodeLatency ( double delay )
+{
+    this->encodeLatency.record ( delay );
+}
+
+void casPVI::subscriptionLatency ( casLatencyHistogram & dest ) const
+{
+    dest = this->encodeLatency;
+}
+
 void casPVI::installChannel ( chanIntfForPV & chan )
 {
     epicsGuard < epicsMutex > guard ( this->mutex );
@@ -365,7 +400,7 @@ void casPVI::installChannel ( chanIntfForPV & chan )
 }
  
 void casPVI::removeChannel ( 
-    chanIntfForPV & chan, ::tsDLList < casMonitor > & src,
+    chanIntfForPV & chan, casMonitorSet & src,
     ::tsDLList < casMonitor > & dest )
 {
     epicsGuard < epicsMutex > guard ( this->mutex );
@@ -432,6 +467,84 @@ void casPVI::uninstallIO (
 	this->ioBlockedList::signal();
 }
 
+//
+// Reads of a PV which returns true from casPV::coalesceReads() 
+// are shared while the server tool's asynchronous read is pending.
+// The first read is passed to the server tool, and reads by other 
+// clients of the same prototype wait for it to complete. Each of
+// them converts the result to its own DBR type.
+//
+void casPVI::installReadInFlight ( casAsyncReadIOI & io )
+{
+    epicsGuard < epicsMutex > guard ( this->mutex );
+    if ( this->coalesceReads && io.coalescable () ) {
+        this->readsInFlight.add ( io );
+        io.inFlight = true;
+    }
+}
+
+//
+// returns true if the read will complete with a read in flight
+//
+bool casPVI::joinReadInFlight ( const casCtx & ctx, gdd & prototype )
+{
+    epicsGuard < epicsMutex > guard ( this->mutex );
+    if ( ! this->coalesceReads ) {
+        return false;
+    }
+    tsDLIter < casAsyncReadIOI > iter = this->readsInFlight.firstIter ();
+    while ( iter.valid () ) {
+        if ( iter->coalescesWith ( *ctx.getMsg () ) ) {
+            casCoalescedReadIOI * pIO = 
+                new casCoalescedReadIOI ( ctx, prototype );
+            iter->coalescedReads.add ( *pIO );
+            pIO->pLeader = iter.pointer ();
+            return true;
+        }
+        iter++;
+    }
+    return false;
+}
+
+void casPVI::completeReadInFlight ( casAsyncReadIOI & io, 
+    caStatus completionStatus, const gdd & valueRead )
+{
+    epicsGuard < epicsMutex > guard ( this->mutex );
+    if ( io.inFlight ) {
+        this->readsInFlight.remove ( io );
+        io.inFlight = false;
+        while ( casCoalescedReadIOI * pIO = io.coalescedReads.get () ) {
+            pIO->pLeader = 0;
+            pIO->postIOCompletion ( completionStatus, valueRead );
+        }
+    }
+}
+
+//
+// the server tool's read was destroyed before it completed
+//
+void casPVI::cancelReadInFlight ( casAsyncReadIOI & io )
+{
+    epicsGuard < epicsMutex > guard ( this->mutex );
+    if ( io.inFlight ) {
+        this->readsInFlight.remove ( io );
+        io.inFlight = false;
+        while ( casCoalescedReadIOI * pIO = io.coalescedReads.get () ) {
+            pIO->pLeader = 0;
+            pIO->postIOCompletion ( S_casApp_canceledAsyncIO, *pIO->pDD );
+        }
+    }
+}
+
+void casPVI::removeCoalescedRead ( casCoalescedReadIOI & io )
+{
+    epicsGuard < epicsMutex > guard ( this->mutex );
+    if ( io.pLeader ) {
+        io.pLeader->coalescedReads.remove ( io );
+        io.pLeader = 0;
+    }
+}
+
 caStatus  casPVI::bestDBRType ( unsigned & dbrType )
 {
     epicsGuard < epicsMutex > guard ( this->mutex );
@@ -447,6 +560,64 @@ caStatus  casPVI::bestDBRType ( unsigned & dbrType )
 	return S_cas_success;
 }
 
+//
+// the last container posted with the property event mask,
+// or nil if there isnt one
+//
+smartConstGDDPointer casPVI::propertyCache () const
+{
+    epicsGuard < epicsMutex > guard ( this->cacheMutex );
+    return this->pPropertyCache;
+}
+
+//
+// the last value posted if the server tool asked for posted
+// events to be kept (see casPV::cachePostedEvents()), or nil
+//
+smartConstGDDPointer casPVI::lastValueEvent () const
+{
+    epicsGuard < epicsMutex > guard ( this->cacheMutex );
+    return this->pLastValueEvent;
+}
+
+//
+// Answers a read of a PV which returns true from 
+// casPV::cachePostedEvents() from the last events posted. 
+// Returns false if the server tool must be asked instead.
+//
+// The PV lock isnt taken because postEvent() holds it while
+// it visits the subscriptions. The posted gdds are not modified
+// after they are posted, and so they are copied after the
+// references to them are taken under the cache lock.
+//
+bool casPVI::readPostedEvents ( gdd & prototype )
+{
+    smartConstGDDPointer pValue;
+    smartConstGDDPointer pProperty;
+    {
+        epicsGuard < epicsMutex > guard ( this->cacheMutex );
+        pValue = this->pLastValueEvent;
+        pProperty = this->pPropertyCache;
+    }
+    if ( ! pValue.valid () ) {
+        return false;
+    }
+    gddApplicationTypeTable & table = gddApplicationTypeTable::AppTable ();
+    if ( prototype.isContainer () ) {
+        // the acknowledge fields of DBR_STSACK_STRING arent in 
+        // any posted event, and a DBR_GR or DBR_CTRL read must 
+        // not be answered with the value alone
+        if ( ! pProperty.valid () || 
+                prototype.applicationType () == gddAppType_dbr_stsack_string ) {
+            return false;
+        }
+        if ( table.smartCopy ( & prototype, pProperty.get () ) < 0 ) {
+            return false;
+        }
+    }
+    return table.smartCopy ( & prototype, pValue.get () ) >= 0;
+}
+
 caStatus casPVI::read ( const casCtx & ctx, gdd & prototype )
 {
     epicsGuard < epicsMutex > guard ( this->mutex );
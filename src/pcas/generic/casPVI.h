@@ -25,6 +25,7 @@
 #include "tsSLList.h"
 #include "epicsMutex.h"
 #include "caProto.h"
+#include "smartGDDPointer.h"
 
 #ifdef epicsExportSharedSymbols_casPVIh
 #   define epicsExportSharedSymbols
@@ -37,6 +38,9 @@
 class chanIntfForPV;
 class caServerI;
 class casMonitor;
+class casMonitorSet;
+class casAsyncReadIOI;
+class casCoalescedReadIOI;
 
 class casPVI : 
     public tsSLNode < casPVI >, // server resource table installation 
@@ -56,14 +60,25 @@ public:
         ::tsDLList < casAsyncIOI > &, casAsyncIOI & );
     void uninstallIO ( 
         ::tsDLList < casAsyncIOI > &, casAsyncIOI & );
+    void installReadInFlight ( casAsyncReadIOI & );
+    bool joinReadInFlight ( const casCtx & ctx, gdd & prototype );
+    void completeReadInFlight ( casAsyncReadIOI &, 
+        caStatus completionStatus, const gdd & valueRead );
+    void cancelReadInFlight ( casAsyncReadIOI & );
+    void removeCoalescedRead ( casCoalescedReadIOI & );
+    bool readPostedEvents ( gdd & prototype );
+    smartConstGDDPointer propertyCache () const;
+    smartConstGDDPointer lastValueEvent () const;
+    void recordEncodeLatency ( double delay );
+    void subscriptionLatency ( casLatencyHistogram & ) const;
     void installChannel ( chanIntfForPV & chan );
     void removeChannel ( 
-        chanIntfForPV & chan, ::tsDLList < casMonitor > & src,
+        chanIntfForPV & chan, casMonitorSet & src,
         ::tsDLList < casMonitor > & dest );
     caStatus installMonitor ( 
-        casMonitor & mon, ::tsDLList < casMonitor > & monitorList );
+        casMonitor & mon, casMonitorSet & monitorSet );
     casMonitor * removeMonitor ( 
-        ::tsDLList < casMonitor > & list, ca_uint32_t clientIdIn );
+        casMonitorSet & monitorSet, ca_uint32_t clientIdIn );
     void deleteSignal ();
     void postEvent ( const casEventMask & select, const gdd & event );
     caServer * getExtServer () const;
@@ -84,13 +99,23 @@ public:
 
 private:
     mutable epicsMutex mutex;
+    // protects only the posted event cache so that reads from 
+    // it dont wait for postEvent() to visit the subscriptions
+    mutable epicsMutex cacheMutex;
     ::tsDLList < chanIntfForPV > chanList;
+    ::tsDLList < casAsyncReadIOI > readsInFlight;
+    smartConstGDDPointer pLastValueEvent;
+    smartConstGDDPointer pPropertyCache;
     gddEnumStringTable enumStrTbl;
+    // written by the threads servicing the clients
+    casLatencyHistogram encodeLatency;
     caServerI * pCAS;
     casPV * pPV;
     unsigned nMonAttached;
     unsigned nIOAttached;
     bool deletePending;
+    const bool coalesceReads;
+    const bool cachePostedEvents;
 
 	casPVI ( const casPVI & );
 	casPVI & operator = ( const casPVI & );
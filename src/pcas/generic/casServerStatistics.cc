@@ -0,0 +1,195 @@
+/*************************************************************************\
+* Copyright (c) 2002 The University of Chicago, as Operator of Argonne
+*     National Laboratory.
+* Copyright (c) 2002 The Regents of the University of California, as
+*     Operator of Los Alamos National Laboratory.
+* EPICS BASE is distributed subject to a Software License Agreement found
+* in file LICENSE that is included with this distribution.
+\*************************************************************************/
+
+#include <string.h>
+#include <stdio.h>
+
+#include "fdManager.h"
+#include "gddApps.h"
+#include "gddAppTable.h"
+
+#define epicsExportSharedSymbols
+#include "caServerI.h"
+#include "casServerStatistics.h"
+
+static const char * const statisticsName[] = {
+    "nClients",
+    "eventRate",
+    "bytesOut",
+    "queueDepthMax",
+    "searchRate"
+};
+
+casStatisticsPV::casStatisticsPV (
+        const char * pPrefix, const char * pSuffix ) :
+    pName ( new char [ strlen ( pPrefix ) + strlen ( pSuffix ) + 6u ] ),
+    pValue ( new gddScalar ( gddAppType_value, aitEnumFloat64 ) ),
+    interest ( false )
+{
+    sprintf ( this->pName, "%s:CAS:%s", pPrefix, pSuffix );
+    this->pValue->unreference ();
+    this->pValue->put ( static_cast < aitFloat64 > ( 0.0 ) );
+    aitTimeStamp ts = epicsTime::getCurrent ();
+    this->pValue->setTimeStamp ( & ts );
+    this->pValue->setStatSevr ( 0, 0 );
+}
+
+casStatisticsPV::~casStatisticsPV ()
+{
+    delete [] this->pName;
+}
+
+//
+// A new gdd is used each time so that the one referenced
+// by the event queues of the clients is never modified.
+//
+void casStatisticsPV::update ( caServerI & cas,
+    aitFloat64 value, const epicsTime & current )
+{
+    aitFloat64 previous = this->value ();
+
+    gdd * pDD = new gddScalar ( gddAppType_value, aitEnumFloat64 );
+    pDD->put ( value );
+    aitTimeStamp ts = current;
+    pDD->setTimeStamp ( & ts );
+    pDD->setStatSevr ( 0, 0 );
+    this->pValue = pDD;
+    pDD->unreference ();
+
+    if ( this->interest && value != previous ) {
+        casEventMask select ( cas.valueEventMask () |
+            cas.logEventMask () );
+        this->postEvent ( select, *this->pValue );
+    }
+}
+
+aitFloat64 casStatisticsPV::value () const
+{
+    aitFloat64 current = 0.0;
+    this->pValue->get ( current );
+    return current;
+}
+
+const char * casStatisticsPV::getName () const
+{
+    return this->pName;
+}
+
+aitEnum casStatisticsPV::bestExternalType () const
+{
+    return aitEnumFloat64;
+}
+
+caStatus casStatisticsPV::interestRegister ()
+{
+    this->interest = true;
+    return S_casApp_success;
+}
+
+void casStatisticsPV::interestDelete ()
+{
+    this->interest = false;
+}
+
+caStatus casStatisticsPV::read ( const casCtx &, gdd & prototype )
+{
+    gddStatus status = gddApplicationTypeTable::app_table.smartCopy (
+        & prototype, this->pValue.get () );
+    return status ? S_cas_noConvert : S_casApp_success;
+}
+
+//
+// the PVs are deleted by casServerStatistics
+//
+void casStatisticsPV::destroy ()
+{
+}
+
+casServerStatistics::casServerStatistics ( caServerI & casIn,
+        const char * pPrefix, double updatePeriodIn ) :
+    timer ( fileDescriptorManager.createTimer () ), cas ( casIn ),
+    lastSample ( epicsTime::getCurrent () ), updatePeriod ( updatePeriodIn ),
+    bytesOut ( 0.0 ), lastEventsProcessed ( 0u ), lastBytesSent ( 0u ),
+    lastSearchRequests ( 0u )
+{
+    for ( unsigned i = 0u; i < nStatisticsPV; i++ ) {
+        this->pPV[i] = new casStatisticsPV ( pPrefix, statisticsName[i] );
+    }
+    unsigned nClients, queueDepthMax;
+    this->cas.sampleStatistics ( nClients, this->lastBytesSent,
+        this->lastSearchRequests, queueDepthMax );
+    this->lastEventsProcessed = this->cas.subscriptionEventsProcessed ();
+    this->timer.start ( *this, this->updatePeriod );
+}
+
+casServerStatistics::~casServerStatistics ()
+{
+    this->timer.destroy ();
+    for ( unsigned i = 0u; i < nStatisticsPV; i++ ) {
+        delete this->pPV[i];
+    }
+}
+
+casPV * casServerStatistics::find ( const char * pName ) const
+{
+    for ( unsigned i = 0u; i < nStatisticsPV; i++ ) {
+        if ( strcmp ( this->pPV[i]->getName (), pName ) == 0 ) {
+            return this->pPV[i];
+        }
+    }
+    return 0;
+}
+
+//
+// the counters are allowed to roll over between samples
+//
+epicsTimerNotify::expireStatus casServerStatistics::expire (
+    const epicsTime & currentTime )
+{
+    unsigned nClients, bytesSent, searchRequests, queueDepthMax;
+    this->cas.sampleStatistics ( nClients, bytesSent,
+        searchRequests, queueDepthMax );
+    unsigned eventsProcessed = this->cas.subscriptionEventsProcessed ();
+
+    double delay = currentTime - this->lastSample;
+    if ( delay <= 0.0 ) {
+        delay = this->updatePeriod;
+    }
+    this->bytesOut += bytesSent - this->lastBytesSent;
+
+    this->pPV[nClientsPV]->update ( this->cas, nClients, currentTime );
+    this->pPV[eventRatePV]->update ( this->cas,
+        ( eventsProcessed - this->lastEventsProcessed ) / delay,
+        currentTime );
+    this->pPV[bytesOutPV]->update ( this->cas, this->bytesOut, currentTime );
+    this->pPV[queueDepthMaxPV]->update ( this->cas, queueDepthMax,
+        currentTime );
+    this->pPV[searchRatePV]->update ( this->cas,
+        ( searchRequests - this->lastSearchRequests ) / delay,
+        currentTime );
+
+    this->lastSample = currentTime;
+    this->lastEventsProcessed = eventsProcessed;
+    this->lastBytesSent = bytesSent;
+    this->lastSearchRequests = searchRequests;
+
+    return expireStatus ( restart, this->updatePeriod );
+}
+
+void casServerStatistics::show ( unsigned level ) const
+{
+    printf ( "Server statistics PVs updated every %f sec\n",
+        this->updatePeriod );
+    if ( level >= 1u ) {
+        for ( unsigned i = 0u; i < nStatisticsPV; i++ ) {
+            printf ( "\t%s = %g\n", this->pPV[i]->getName (),
+                this->pPV[i]->value () );
+        }
+    }
+}
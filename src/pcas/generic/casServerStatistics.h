@@ -0,0 +1,90 @@
+/*************************************************************************\
+* Copyright (c) 2002 The University of Chicago, as Operator of Argonne
+*     National Laboratory.
+* Copyright (c) 2002 The Regents of the University of California, as
+*     Operator of Los Alamos National Laboratory.
+* EPICS BASE Versions 3.13.7
+* and higher are distributed subject to a Software License Agreement found
+* in file LICENSE that is included with this distribution.
+\*************************************************************************/
+#ifndef casServerStatisticsh
+#define casServerStatisticsh
+
+#ifdef epicsExportSharedSymbols
+#   define epicsExportSharedSymbols_casServerStatisticsh
+#   undef epicsExportSharedSymbols
+#endif
+
+// external headers included here
+#include "epicsTimer.h"
+#include "smartGDDPointer.h"
+
+#ifdef epicsExportSharedSymbols_casServerStatisticsh
+#   define epicsExportSharedSymbols
+#   include "shareLib.h"
+#endif
+
+#include "casdef.h"
+
+class caServerI;
+
+//
+// one of the read only aitFloat64 PVs published by casServerStatistics
+//
+class casStatisticsPV : public casPV {
+public:
+    casStatisticsPV ( const char * pPrefix, const char * pSuffix );
+    ~casStatisticsPV ();
+    void update ( caServerI &, aitFloat64 value, const epicsTime & );
+    aitFloat64 value () const;
+    const char * getName () const;
+    aitEnum bestExternalType () const;
+    caStatus interestRegister ();
+    void interestDelete ();
+    caStatus read ( const casCtx &, gdd & prototype );
+    void destroy ();
+private:
+    char * pName;
+    smartGDDPointer pValue;
+    bool interest;
+	casStatisticsPV ( const casStatisticsPV & );
+	casStatisticsPV & operator = ( const casStatisticsPV & );
+};
+
+//
+// The server's own diagnostics, which are published as PVs named
+// "<prefix>:CAS:<statistic>" (see caServer::publishStatistics()).
+// The counters are sampled from the clients when the timer expires,
+// and are otherwise written only by the thread servicing the client.
+//
+class casServerStatistics : public epicsTimerNotify {
+public:
+    casServerStatistics ( caServerI &, const char * pPrefix,
+        double updatePeriod );
+    ~casServerStatistics ();
+    casPV * find ( const char * pName ) const;
+    void show ( unsigned level ) const;
+private:
+    enum {
+        nClientsPV,
+        eventRatePV,
+        bytesOutPV,
+        queueDepthMaxPV,
+        searchRatePV,
+        nStatisticsPV
+    };
+    casStatisticsPV * pPV[nStatisticsPV];
+    epicsTimer & timer;
+    caServerI & cas;
+    epicsTime lastSample;
+    double updatePeriod;
+    double bytesOut;
+    unsigned lastEventsProcessed;
+    unsigned lastBytesSent;
+    unsigned lastSearchRequests;
+    expireStatus expire ( const epicsTime & currentTime );
+	casServerStatistics ( const casServerStatistics & );
+	casServerStatistics & operator = ( const casServerStatistics & );
+};
+
+#endif // casServerStatisticsh
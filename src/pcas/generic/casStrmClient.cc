@@ -27,6 +27,7 @@ typedef unsigned long arrayElementCount;
 #include "casChannelI.h"
 #include "casAsyncIOI.h"
 #include "channelDestroyEvent.h"
+#include "casArena.h"
 
 #if defined(__BORLANDC__) && defined(__linux__)
 namespace  std  {
@@ -79,10 +80,14 @@ casStrmClient::casStrmClient (
     pUserName ( 0 ),
     pHostName ( 0 ),
     incommingBytesToDrain ( 0 ),
+    captureGeneration ( 0u ),
+    captureCircuit ( cas.captureConnect ( clientAddr, 
+        this->captureGeneration ) ),
     pendingResponseStatus ( S_cas_success ),
     minor_version_number ( 0 ),
     reqPayloadNeedsByteSwap ( true ),
-    responseIsPending ( false )
+    responseIsPending ( false ),
+    overBudget ( false )
 {
     this->pHostName = new char [1u];
     *this->pHostName = '\0';
@@ -93,6 +98,15 @@ casStrmClient::casStrmClient (
         throw std::bad_alloc();
     }
     *this->pUserName= '\0';
+
+    for ( unsigned i = 0u; i < NELEMENTS ( this->pDBRDDCache ); i++ ) {
+        this->pDBRDDCache[i] = 0;
+    }
+
+    this->ctx.setArena ( & this->arena );
+
+    this->eventSys.setEventQueueLimit ( 
+        cas.clientBudget ().maxQueuedEvents );
 }
 
 //
@@ -100,6 +114,8 @@ casStrmClient::casStrmClient (
 //
 casStrmClient::~casStrmClient ()
 {
+    this->getCAS().captureDisconnect ( this->captureCircuit, 
+        this->captureGeneration, this->_clientAddr );
     while ( casChannelI * pChan = this->chanList.get() ) {
         pChan->uninstallFromPV ( this->eventSys );
         this->chanTable.remove ( *pChan );
@@ -107,6 +123,11 @@ casStrmClient::~casStrmClient ()
     }
     delete [] this->pUserName;
     delete [] this->pHostName;
+    for ( unsigned i = 0u; i < NELEMENTS ( this->pDBRDDCache ); i++ ) {
+        if ( this->pDBRDDCache[i] ) {
+            this->pDBRDDCache[i]->unreference ();
+        }
+    }
 }
 
 //
@@ -248,7 +269,15 @@ caStatus casStrmClient :: processMsg ()
             else {
                 pHandler = & casStrmClient::uknownMessageAction;
             }
+#ifdef CAS_DISPATCH_STATS
+            epicsTime dispatchBegin = epicsTime::getCurrent ();
+#endif
             status = ( this->*pHandler ) ( guard );
+#ifdef CAS_DISPATCH_STATS
+            this->dispatchStats.record ( msgTmp.m_cmmd, 
+                epicsTime::getCurrent () - dispatchBegin );
+#endif
+            this->arena.release ();
             if ( status ) {
                 break;
             }
@@ -403,8 +432,7 @@ caStatus casStrmClient::verifyRequest (casChannelI * & pChan , bool allowdyn)
     //
     // channel exists for this resource id ?
     //
-    chronIntId tmpId ( ctx.msg.m_cid );
-    pChan = this->chanTable.lookup ( tmpId );
+    pChan = this->chanTable.lookup ( ctx.msg.m_cid );
     if ( ! pChan ) {
         return ECA_BADCHID;
     }
@@ -441,6 +469,16 @@ void casStrmClient::show ( unsigned level ) const
         this->in.show ( level - 1 );
         this->out.show ( level - 1 );
         this->chanTable.show ( level - 1 );
+        this->arena.show ( level - 1 );
+    }
+    if ( level > 0u ) {
+        casClientResources res;
+        this->resources ( res, epicsTime::getCurrent () );
+        printf ( "\t%u queued events, %u bytes out, %u bytes in, "
+            "%u bytes of buffer\n", res.queuedEvents, res.outputBytes,
+            res.inputBytes, res.bufferBytes );
+        printf ( "\t%f sec in flow control, %f sec over budget\n",
+            res.flowControlDelay, res.overBudgetDelay );
     }
 }
 
@@ -808,6 +846,29 @@ caStatus convertContainerMemberToAtomic ( gdd & dd,
     return S_cas_success;
 }
 
+//
+// fixDBRDDCounts ()
+//
+static caStatus fixDBRDDCounts ( gdd & dd, unsigned dbrType,
+        unsigned requestedCount, unsigned nativeCount )
+{
+    // fix the value element count
+    caStatus status = convertContainerMemberToAtomic ( 
+        dd, gddAppType_value, requestedCount, nativeCount );
+    if ( status != S_cas_success ) {
+        return status;
+    }
+
+    // fix the enum string table element count
+    // (this is done here because the application type table in gdd 
+    // does not appear to handle this correctly)
+    if ( dbrType == DBR_CTRL_ENUM || dbrType == DBR_GR_ENUM ) {
+        status = convertContainerMemberToAtomic ( 
+            dd, gddAppType_enums, MAX_ENUM_STATES );
+    }
+    return status;
+}
+
 //
 // createDBRDD ()
 //
@@ -838,28 +899,59 @@ static caStatus createDBRDD ( unsigned dbrType,
         return S_cas_noMemory;
     }
 
-    // fix the value element count
-    caStatus status = convertContainerMemberToAtomic ( 
-        *pDescRet, gddAppType_value, requestedCount, nativeCount );
+    caStatus status = fixDBRDDCounts ( 
+        *pDescRet, dbrType, requestedCount, nativeCount );
     if ( status != S_cas_success ) {
         pDescRet->unreference ();
         return status;
     }
 
-    // fix the enum string table element count
-    // (this is done here because the application type table in gdd 
-    // does not appear to handle this correctly)
-    if ( dbrType == DBR_CTRL_ENUM || dbrType == DBR_GR_ENUM ) {
-        status = convertContainerMemberToAtomic ( 
-            *pDescRet, gddAppType_enums, MAX_ENUM_STATES );
+    pDD = pDescRet;
+    return S_cas_success;
+}
+
+//
+// casStrmClient::createCachedDBRDD ()
+//
+// Responses that do not pass the descriptor to the server tool
+// reuse the descriptor from the previous response of the same DBR
+// type, avoiding the free list locking and the destructor allocation
+// in gddApplicationTypeTable::getDD()
+//
+caStatus casStrmClient::createCachedDBRDD ( unsigned dbrType,
+        unsigned requestedCount, unsigned nativeCount, gdd * & pDD )
+{
+    if ( dbrType < NELEMENTS ( this->pDBRDDCache ) && 
+            this->pDBRDDCache[dbrType] ) {
+        gdd * pDescRet = this->pDBRDDCache[dbrType];
+        this->pDBRDDCache[dbrType] = 0;
+        caStatus status = fixDBRDDCounts ( 
+            *pDescRet, dbrType, requestedCount, nativeCount );
         if ( status != S_cas_success ) {
             pDescRet->unreference ();
             return status;
         }
+        pDD = pDescRet;
+        return S_cas_success;
     }
+    return createDBRDD ( dbrType, requestedCount, nativeCount, pDD );
+}
 
-    pDD = pDescRet;
-    return S_cas_success;
+//
+// casStrmClient::releaseCachedDBRDD ()
+//
+// only for descriptors that no one else holds a reference to
+//
+void casStrmClient::releaseCachedDBRDD ( unsigned dbrType, gdd & dd )
+{
+    if ( dbrType < NELEMENTS ( this->pDBRDDCache ) && 
+            ! this->pDBRDDCache[dbrType] &&
+            ! gddApplicationTypeTable::app_table.resetDD ( & dd ) ) {
+        this->pDBRDDCache[dbrType] = & dd;
+    }
+    else {
+        dd.unreference ();
+    }
 }
 
 //
@@ -928,7 +1020,7 @@ caStatus casStrmClient::monitorResponse (
 
     gdd * pDBRDD = 0;
     if ( completionStatus == S_cas_success ) {
-        caStatus status = createDBRDD ( msg.m_dataType, count,
+        caStatus status = this->createCachedDBRDD ( msg.m_dataType, count,
                 chan.getMaxElem(), pDBRDD );
         if ( status != S_cas_success ) {
             caStatus ecaStatus;
@@ -944,10 +1036,24 @@ caStatus casStrmClient::monitorResponse (
             return monitorFailureResponse ( guard, msg, ecaStatus );
         }
         else {
+            //
+            // the properties missing from a value only event
+            // come from the last property event posted
+            //
+            if ( msg.m_dataType >= DBR_GR_STRING && 
+                    msg.m_dataType <= DBR_CTRL_DOUBLE &&
+                    ! ( desc.isContainer () && 
+                        desc.applicationType () == pDBRDD->applicationType () ) ) {
+                smartConstGDDPointer pProperties = chan.getPVI().propertyCache ();
+                if ( pProperties.valid () ) {
+                    gddApplicationTypeTable::app_table.smartCopy ( 
+                        pDBRDD, pProperties.get () );
+                }
+            }
             gddStatus gdds = gddApplicationTypeTable::
                 app_table.smartCopy ( pDBRDD, & desc );
             if ( gdds < 0 ) {
-                pDBRDD->unreference ();
+                this->releaseCachedDBRDD ( msg.m_dataType, *pDBRDD );
                 errPrintf ( S_cas_noConvert, __FILE__, __LINE__,
         "no conversion between event app type=%d and DBR type=%d Element count=%d",
                     desc.applicationType (), msg.m_dataType, count);
@@ -975,14 +1081,14 @@ caStatus casStrmClient::monitorResponse (
     int mapDBRStatus = gddMapDbr[msg.m_dataType].conv_dbr ( 
         pPayload, count, *pDBRDD, chan.enumStringTable() );
     if ( mapDBRStatus < 0 ) {
-        pDBRDD->unreference ();
+        this->releaseCachedDBRDD ( msg.m_dataType, *pDBRDD );
         return monitorFailureResponse ( guard, msg, ECA_NOCONVERT );
     }
 
     int cacStatus = caNetConvert ( 
         msg.m_dataType, pPayload, pPayload, true, count );
     if ( cacStatus != ECA_NORMAL ) {
-        pDBRDD->unreference ();
+        this->releaseCachedDBRDD ( msg.m_dataType, *pDBRDD );
         return this->sendErrWithEpicsStatus ( 
             guard, & msg, chan.getCID(), S_cas_internal, cacStatus );
     }
@@ -998,7 +1104,7 @@ caStatus casStrmClient::monitorResponse (
         this->out.commitMsg ();
     }
 
-    pDBRDD->unreference ();
+    this->releaseCachedDBRDD ( msg.m_dataType, *pDBRDD );
 
     return S_cas_success;
 }
@@ -1380,6 +1486,8 @@ caStatus casStrmClient :: searchAction ( epicsGuard < casClientMutex > & guard )
     const char              *pChanName = static_cast <char * > ( this->ctx.getData() );
     caStatus                status;
 
+    this->nSearchRequests++;
+
     if (!CA_VSUPPORTED(mp->m_count)) {
         if ( this->getCAS().getDebugLevel() > 3u ) {
             char pHostName[64u];
@@ -1438,7 +1546,7 @@ caStatus casStrmClient :: searchAction ( epicsGuard < casClientMutex > & guard )
     //
     this->userStartedAsyncIO = false;
     pvExistReturn pver = 
-        this->getCAS()->pvExistTest ( 
+        this->getCAS().pvExistTest ( 
             this->ctx, _clientAddr, pChanName );
 
     //
@@ -1625,7 +1733,7 @@ caStatus casStrmClient::claimChannelAction (
     //
     // attach to the PV
     //
-    pvAttachReturn pvar = cas->pvAttach ( this->ctx, pName );
+    pvAttachReturn pvar = cas.pvAttach ( this->ctx, pName );
 
     //
     // prevent problems when they initiate
@@ -1770,6 +1878,9 @@ caStatus casStrmClient::createChanResponse (
             return this->channelCreateFailedResp ( 
                 guard, hdr, S_cas_noMemory );
         }
+
+        // the server tool may need getPV() to decide
+        pChan->pChanI->refreshAccessRights ();
     }
 
     //
@@ -2133,8 +2244,7 @@ caStatus casStrmClient::clearChannelAction (
     this->out.commitMsg ();
 
     // Verify the channel
-    chronIntId tmpId ( mp->m_cid );
-    casChannelI * pciu = this->chanTable.remove ( tmpId );
+    casChannelI * pciu = this->chanTable.remove ( mp->m_cid );
     if ( pciu ) {
         this->chanList.remove ( *pciu );
         pciu->uninstallFromPV ( this->eventSys );
@@ -2177,9 +2287,8 @@ caStatus casStrmClient::channelDestroyEventNotify (
         pChanFound = pChan;
     }
     else {
-        chronIntId tmpId ( sid );
         pChanFound = 
-            this->chanTable.lookup ( tmpId );
+            this->chanTable.lookup ( sid );
         if ( ! pChanFound ) {
             return S_cas_success;
         }
@@ -2247,8 +2356,7 @@ caStatus casStrmClient::eventCancelAction (
     const void * dp = this->ctx.getData ();
 
     {
-        chronIntId tmpId ( mp->m_cid );
-        casChannelI * pChan = this->chanTable.lookup ( tmpId );
+        casChannelI * pChan = this->chanTable.lookup ( mp->m_cid );
         if ( ! pChan ) {
             // It is possible that the event delete arrives just 
             // after the server tool has deleted the PV. Its probably 
@@ -2587,8 +2695,6 @@ caStatus casStrmClient :: writeArrayData ( PWriteMethod pWriteMethod )
         return S_cas_badType;
     }
 
-    aitEnum bestExternalType = this->ctx.getPV()->bestExternalType ();
-
     // the application type best maching this DBR_XXX type
     aitUint16 app = gddDbrToAit[pHdr->m_dataType].app;
 
@@ -2604,27 +2710,27 @@ caStatus casStrmClient :: writeArrayData ( PWriteMethod pWriteMethod )
         return S_cas_noMemory;
     }
 
-    size_t size = aitSize[bestExternalType] * pHdr->m_count;
-    char * pData = new char [size];
-    if ( ! pData ) {
-        pDD->unreference();
-        return S_cas_noMemory;
-    }
-
     //
-    // ok to use the default gddDestructor here because
-    // an array of characters was allocated above
+    // the converted data are carved from the request arena, and the
+    // destructor keeps them allocated after the arena is released if
+    // the server tool keeps the DD, or duplicates it
     //
-    gddDestructor * pDestructor = new gddDestructor;
+    size_t size = aitSize[bestWritePrimType] * pHdr->m_count;
+    char * pData;
+    gddDestructor * pDestructor;
+    try {
+        pData = static_cast < char * > 
+            ( this->ctx.getArena()->allocate ( size ) );
+        pDestructor = this->ctx.getArena()->promote ( pData );
+    }
+    catch ( std::bad_alloc & ) {
+        pDD->unreference ();
+        return S_cas_noMemory;
+    }
     if ( ! pDestructor ) {
-        pDD->unreference();
-        delete [] pData;
+        pDD->unreference ();
         return S_cas_noMemory;
     }
-
-    //
-    // install allocated area into the DD
-    //
     pDD->putRef ( pData, bestWritePrimType, pDestructor );
 
     //
@@ -2688,6 +2794,20 @@ caStatus casStrmClient::read ()
     //
     this->userStartedAsyncIO = false;
 
+    casPVI & pvi ( this->ctx.getChannel()->getPVI() );
+    if ( pvi.readPostedEvents ( *pValueRead ) ) {
+        return S_casApp_success;
+    }
+
+    //
+    // share a read of the same prototype that the 
+    // server tool has not completed yet
+    //
+    if ( pvi.joinReadInFlight ( this->ctx, *pValueRead ) ) {
+        pValueRead.set ( 0 );
+        return S_casApp_asyncCompletion;
+    }
+
     {
         //
         // call the server tool's virtual function
@@ -2718,7 +2838,6 @@ caStatus casStrmClient::read ()
         else if ( servStat != S_casApp_success ) {
             pValueRead.set ( 0 );
             if ( servStat == S_casApp_postponeAsyncIO ) {
-                casPVI & pvi ( this->ctx.getChannel()->getPVI() );
                 if ( pvi.ioIsPending () ) {
                     pvi.addItemToIOBLockedList ( *this );
                 }
@@ -2780,6 +2899,10 @@ inBufClient::fillCondition casStrmClient::xRecv ( char * pBufIn, bufSizeT nBytes
     // this is used to set the time stamp for write GDD's
     //
     this->lastRecvTS = epicsTime::getCurrent ();
+    if ( stat == casFillProgress ) {
+        this->getCAS().captureStream ( this->captureCircuit, 
+            this->captureGeneration, this->_clientAddr, this->lastRecvTS, pBufIn, nActualBytes );
+    }
     return stat;
 }
 
@@ -2801,6 +2924,83 @@ caStatus casStrmClient::casMonitorCallBack (
     return mon.response ( guard, *this, value );
 }
 
+//
+// casStrmClient::subscriptionEncoded()
+//
+void casStrmClient::subscriptionEncoded ( 
+    casPVI & pvi, epicsUInt64 posted )
+{
+    this->casCoreClient::subscriptionEncoded ( pvi, posted );
+    this->out.notePostTime ( posted );
+}
+
+void casStrmClient::subscriptionLatency ( 
+    casLatencyHistogram & encode, casLatencyHistogram & wire ) const
+{
+    epicsGuard < epicsMutex > guard ( this->mutex );
+    encode = this->encodeLatency;
+    wire = this->out.wireLatency ();
+}
+
+void casStrmClient::resources ( casClientResources & res, 
+    const epicsTime & current ) const
+{
+    epicsGuard < epicsMutex > guard ( this->mutex );
+    res.queuedEvents = this->eventSys.eventQueueDepth ();
+    res.outputBytes = this->out.bytesPresent ();
+    res.inputBytes = this->in.bytesPresent ();
+    res.bufferBytes = this->out.bufferSize () + this->in.bufferSize ();
+    res.flowControlDelay = this->eventSys.flowControlDelay ( current );
+    if ( this->overBudget ) {
+        res.overBudgetDelay = current - this->overBudgetBegin;
+    }
+    else {
+        res.overBudgetDelay = 0.0;
+    }
+}
+
+//
+// casStrmClient::enforceBudget()
+//
+// The client is shut down if it has been over budget since the 
+// previous checks for longer than the budget allows. The delay 
+// is measured from the first check which found it over budget.
+//
+void casStrmClient::enforceBudget ( const casClientBudget & budget, 
+    const epicsTime & current )
+{
+    epicsGuard < epicsMutex > guard ( this->mutex );
+    bool over = false;
+    if ( budget.maxQueuedEvents && 
+            this->eventSys.eventQueueDepth () >= budget.maxQueuedEvents ) {
+        over = true;
+    }
+    if ( budget.maxBufferBytes && 
+            this->out.bufferSize () + this->in.bufferSize () > 
+                budget.maxBufferBytes ) {
+        over = true;
+    }
+    if ( ! over ) {
+        this->overBudget = false;
+        return;
+    }
+    if ( ! this->overBudget ) {
+        this->overBudget = true;
+        this->overBudgetBegin = current;
+        return;
+    }
+    double delay = current - this->overBudgetBegin;
+    if ( budget.maxOverBudgetDelay > 0.0 && 
+            delay >= budget.maxOverBudgetDelay ) {
+        errlogPrintf ( "CAS: disconnecting client %s at %s "
+            "because it was over budget for %f sec\n",
+            this->pUserName, this->pHostName, delay );
+        this->forceDisconnect ();
+        // not logged again unless it stays connected for another delay
+        this->overBudget = false;
+    }
+}
+
 //
 //  casStrmClient::sendErr()
 //
@@ -16,6 +16,7 @@
 #endif
 
 #include "epicsTime.h"
+#include "dbMapper.h"
 
 #ifdef epicsExportSharedSymbols_casStrmClienth
 #   define epicsExportSharedSymbols
@@ -25,6 +26,8 @@
 #include "casCoreClient.h"
 #include "inBuf.h"
 #include "outBuf.h"
+#include "slotIdTable.h"
+#include "casArena.h"
 
 enum xBlockingStatus { xIsBlocking, xIsntBlocking };
 
@@ -44,6 +47,12 @@ public:
     void userName ( char * pBuf, unsigned bufSize ) const;
     ca_uint16_t protocolRevision () const;
     void sendVersion ();
+    void subscriptionLatency ( casLatencyHistogram & encode,
+        casLatencyHistogram & wire ) const;
+    unsigned bytesSent () const;
+    void resources ( casClientResources &, const epicsTime & current ) const;
+    void setEventQueueLimit ( unsigned limit );
+    void enforceBudget ( const casClientBudget &, const epicsTime & current );
 protected:
     caStatus processMsg ();
     bool inBufFull () const;
@@ -54,21 +63,32 @@ private:
     //char hostNameStr [32];
     inBuf in;
     outBuf out;
-    chronIntIdResTable < casChannelI > chanTable;
+    slotIdTable < casChannelI > chanTable;
     tsDLList < casChannelI > chanList;
     epicsTime lastSendTS;
     epicsTime lastRecvTS;
+    epicsTime overBudgetBegin;
     caNetAddr _clientAddr;
     char * pUserName;
     char * pHostName;
     smartGDDPointer pValueRead;
+    // temporary storage for the message being processed
+    casArena arena;
+    // reset descriptors kept for reuse by the next response of each DBR type
+    gdd * pDBRDDCache[DBM_N_DBR_TYPES];
     unsigned incommingBytesToDrain;
+    unsigned captureGeneration; // the capture which has the circuit
+    unsigned captureCircuit; // zero unless capturing requests
     caStatus pendingResponseStatus;
     ca_uint16_t minor_version_number;
     bool reqPayloadNeedsByteSwap;
     bool responseIsPending;
+    bool overBudget;
 
     caStatus createChannel ( const char * pName );
+    caStatus createCachedDBRDD ( unsigned dbrType,
+        unsigned requestedCount, unsigned nativeCount, gdd * & pDD );
+    void releaseCachedDBRDD ( unsigned dbrType, gdd & dd );
     caStatus verifyRequest ( casChannelI * & pChan, bool allowdyn = false );
     typedef caStatus ( casStrmClient :: * pCASMsgHandler ) 
         ( epicsGuard < casClientMutex > & );
@@ -171,6 +191,7 @@ private:
     virtual void forceDisconnect () = 0;
         caStatus casMonitorCallBack ( 
         epicsGuard < casClientMutex > &, casMonitor &, const gdd & );
+    void subscriptionEncoded ( casPVI &, epicsUInt64 posted );
     caStatus logBadIdWithFileAndLineno (    
         epicsGuard < casClientMutex > & guard, const caHdrLargeArray * mp,
         const void * dp, const int cacStatus, const char * pFileName, 
@@ -193,4 +214,14 @@ inline ca_uint16_t casStrmClient::protocolRevision () const
     return this->minor_version_number;
 }
 
+inline unsigned casStrmClient::bytesSent () const
+{
+    return this->out.bytesSent ();
+}
+
+inline void casStrmClient::setEventQueueLimit ( unsigned limit )
+{
+    this->eventSys.setEventQueueLimit ( limit );
+}
+
 #endif // casStrmClienth
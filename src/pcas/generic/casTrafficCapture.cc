@@ -0,0 +1,126 @@
+/*************************************************************************\
+* Copyright (c) 2002 The University of Chicago, as Operator of Argonne
+*     National Laboratory.
+* Copyright (c) 2002 The Regents of the University of California, as
+*     Operator of Los Alamos National Laboratory.
+* EPICS BASE is distributed subject to a Software License Agreement found
+* in file LICENSE that is included with this distribution.
+\*************************************************************************/
+
+#include <string.h>
+
+#include "osiSock.h"
+#include "epicsGuard.h"
+#include "errlog.h"
+
+#define epicsExportSharedSymbols
+#include "caNetAddr.h"
+#include "casTrafficCapture.h"
+
+static const size_t casCaptureBufSize = 0x100000;
+
+casTrafficCapture::casTrafficCapture ( 
+        FILE * pFileIn, const char * pFileNameIn ) :
+    pFile ( pFileIn ), 
+    pFileName ( new char [ strlen ( pFileNameIn ) + 1u ] ),
+    pBuf ( new char [ casCaptureBufSize ] ), nRecords ( 0u ), 
+    nBytes ( 0u ), failed ( false )
+{
+    strcpy ( this->pFileName, pFileNameIn );
+    setvbuf ( this->pFile, this->pBuf, _IOFBF, casCaptureBufSize );
+    if ( fwrite ( casCaptureMagic, 8u, 1u, this->pFile ) != 1u ) {
+        this->failed = true;
+    }
+}
+
+casTrafficCapture::~casTrafficCapture ()
+{
+    if ( fclose ( this->pFile ) != 0 ) {
+        this->failed = true;
+    }
+    if ( this->failed ) {
+        errlogPrintf ( "CAS: capture file \"%s\" is incomplete\n",
+            this->pFileName );
+    }
+    delete [] this->pBuf;
+    delete [] this->pFileName;
+}
+
+void casTrafficCapture::connect ( unsigned circuit, const caNetAddr & addr )
+{
+    this->write ( casCaptureConnect, circuit, addr, 
+        epicsTime::getCurrent (), 0, 0u );
+}
+
+void casTrafficCapture::stream ( unsigned circuit, const caNetAddr & addr,
+    const epicsTime & received, const char * pBufIn, unsigned nBytesIn )
+{
+    this->write ( casCaptureStream, circuit, addr, 
+        received, pBufIn, nBytesIn );
+}
+
+void casTrafficCapture::disconnect ( unsigned circuit, const caNetAddr & addr )
+{
+    this->write ( casCaptureDisconnect, circuit, addr, 
+        epicsTime::getCurrent (), 0, 0u );
+}
+
+void casTrafficCapture::datagram ( const caNetAddr & addr, 
+    const char * pBufIn, unsigned nBytesIn )
+{
+    this->write ( casCaptureDatagram, 0u, addr, 
+        epicsTime::getCurrent (), pBufIn, nBytesIn );
+}
+
+//
+// After a write fails the capture is abandoned, since a replay
+// of a stream with a gap in it wouldnt make sense.
+//
+void casTrafficCapture::write ( casCaptureType type, unsigned circuit,
+    const caNetAddr & addr, const epicsTime & received, 
+    const char * pBufIn, unsigned nBytesIn )
+{
+    epicsTimeStamp ts = received;
+    struct sockaddr_in ip;
+    if ( addr.isInet () ) {
+        ip = addr.getSockIP ();
+    }
+    else {
+        memset ( & ip, '\0', sizeof ( ip ) );
+    }
+
+    casCaptureHeader hdr;
+    hdr.secPastEpoch = htonl ( ts.secPastEpoch );
+    hdr.nSec = htonl ( ts.nsec );
+    hdr.circuit = htonl ( circuit );
+    hdr.addr = ip.sin_addr.s_addr;
+    hdr.port = ip.sin_port;
+    hdr.type = static_cast < epicsUInt8 > ( type );
+    hdr.pad = 0u;
+    hdr.nBytes = htonl ( nBytesIn );
+
+    epicsGuard < epicsMutex > guard ( this->mutex );
+    if ( this->failed ) {
+        return;
+    }
+    if ( fwrite ( & hdr, sizeof ( hdr ), 1u, this->pFile ) != 1u ||
+        ( nBytesIn > 0u && 
+            fwrite ( pBufIn, nBytesIn, 1u, this->pFile ) != 1u ) ) {
+        errlogPrintf ( "CAS: write to capture file \"%s\" failed\n",
+            this->pFileName );
+        this->failed = true;
+        return;
+    }
+    this->nRecords++;
+    this->nBytes += sizeof ( hdr ) + nBytesIn;
+}
+
+void casTrafficCapture::show ( unsigned level ) const
+{
+    epicsGuard < epicsMutex > guard ( this->mutex );
+    printf ( "Capturing requests to \"%s\"%s\n", this->pFileName,
+        this->failed ? " (failed)" : "" );
+    if ( level >= 1u ) {
+        printf ( "\t%u records, %u bytes\n", this->nRecords, this->nBytes );
+    }
+}
@@ -0,0 +1,91 @@
+/*************************************************************************\
+* Copyright (c) 2002 The University of Chicago, as Operator of Argonne
+*     National Laboratory.
+* Copyright (c) 2002 The Regents of the University of California, as
+*     Operator of Los Alamos National Laboratory.
+* EPICS BASE Versions 3.13.7
+* and higher are distributed subject to a Software License Agreement found
+* in file LICENSE that is included with this distribution.
+\*************************************************************************/
+#ifndef casTrafficCaptureh
+#define casTrafficCaptureh
+
+#ifdef epicsExportSharedSymbols
+#   define epicsExportSharedSymbols_casTrafficCaptureh
+#   undef epicsExportSharedSymbols
+#endif
+
+// external headers included here
+#include <stdio.h>
+#include "epicsTypes.h"
+#include "epicsTime.h"
+#include "epicsMutex.h"
+
+#ifdef epicsExportSharedSymbols_casTrafficCaptureh
+#   define epicsExportSharedSymbols
+#   include "shareLib.h"
+#endif
+
+class caNetAddr;
+
+//
+// Capture file format
+//
+// The file begins with the eight characters of casCaptureMagic,
+// followed by one record for each event. A record is a header
+// followed by nBytes of the request stream exactly as it was
+// received. The fields of the header are in network byte order.
+//
+#define casCaptureMagic "CASCAPT1"
+
+enum casCaptureType {
+    casCaptureConnect = 1, // a TCP circuit was accepted
+    casCaptureStream = 2, // bytes received on a TCP circuit
+    casCaptureDisconnect = 3, // a TCP circuit was destroyed
+    casCaptureDatagram = 4 // one UDP datagram was received
+};
+
+struct casCaptureHeader {
+    epicsUInt32 secPastEpoch; // time that the bytes were received
+    epicsUInt32 nSec;
+    epicsUInt32 circuit; // identifies the circuit (zero for datagrams)
+    epicsUInt32 addr; // IP address and port of the client
+    epicsUInt16 port;
+    epicsUInt8 type; // casCaptureType
+    epicsUInt8 pad;
+    epicsUInt32 nBytes;
+};
+
+//
+// casTrafficCapture
+//
+// Writes the raw requests received by the server to a capture file
+// as they enter the input buffers of its clients (see 
+// caServer::startCapture()). The records are written through a 
+// large stdio buffer so that most of them cost a copy.
+//
+class epicsShareClass casTrafficCapture {
+public:
+    casTrafficCapture ( FILE * pFile, const char * pFileName );
+    ~casTrafficCapture ();
+    void connect ( unsigned circuit, const caNetAddr & );
+    void stream ( unsigned circuit, const caNetAddr &,
+        const epicsTime & received, const char * pBuf, unsigned nBytes );
+    void disconnect ( unsigned circuit, const caNetAddr & );
+    void datagram ( const caNetAddr &, const char * pBuf, unsigned nBytes );
+    void show ( unsigned level ) const;
+private:
+    mutable epicsMutex mutex;
+    FILE * pFile;
+    char * pFileName;
+    char * pBuf;
+    unsigned nRecords;
+    unsigned nBytes;
+    bool failed;
+    void write ( casCaptureType, unsigned circuit, const caNetAddr &,
+        const epicsTime &, const char * pBuf, unsigned nBytes );
+	casTrafficCapture ( const casTrafficCapture & );
+	casTrafficCapture & operator = ( const casTrafficCapture & );
+};
+
+#endif // casTrafficCaptureh
@@ -37,6 +37,9 @@
 
 #include "caNetAddr.h"
 #include "casEventMask.h"   // EPICS event select class 
+#include "casLatencyHistogram.h" // subscription update latency
+#include "casClientBudget.h" // per client resource limits
+#include "casDispatchStats.h" // request counts and handler times
 
 typedef aitUint32 caStatus;
 
@@ -152,6 +155,7 @@ private:
 //
 class epicsShareClass caServer {
     friend class casPVI;
+    friend class casDirect;
 public:
     caServer ();
     virtual ~caServer() = 0;
@@ -266,6 +270,87 @@ public:
     unsigned subscriptionEventsPosted () const;
     unsigned subscriptionEventsProcessed () const;
 
+    //
+    // subscription update latency histograms (see casLatencyHistogram.h)
+    //
+    // subscriptionLatency()
+    //      - summed over all clients, from casPV::postEvent() until
+    //      the update is encoded, and until it is sent
+    // clientLatency()
+    //      - the same histograms for each client (the visitor is 
+    //      called with a server lock held, and must not call into
+    //      the server library)
+    //
+    void subscriptionLatency ( casLatencyHistogram & encode,
+        casLatencyHistogram & wire ) const;
+    void clientLatency ( casClientLatencyVisitor & ) const;
+
+#ifdef CAS_DISPATCH_STATS
+    //
+    // The requests received over TCP and UDP by type, and the time
+    // spent processing them, summed over all clients (see 
+    // casDispatchStats.h). The counts are added to those supplied.
+    // Only present if the library and the application are built
+    // with CAS_DISPATCH_STATS defined.
+    //
+    void dispatchStatistics ( casDispatchStats & stream,
+        casDispatchStats & datagram ) const;
+#endif
+
+    //
+    // Publishes the server's own diagnostics as read only PVs which
+    // are updated every updatePeriod seconds. They are found before
+    // pvExistTest() and pvAttach() are called.
+    //
+    // <prefix>:CAS:nClients - number of TCP clients attached
+    // <prefix>:CAS:eventRate - subscription updates sent per second
+    // <prefix>:CAS:bytesOut - bytes sent since publication began
+    // <prefix>:CAS:queueDepthMax - deepest subscription event queue 
+    //      of any client since the last update
+    // <prefix>:CAS:searchRate - search requests received per second
+    //
+    // Returns S_cas_badParameter if the statistics are already
+    // published.
+    //
+    caStatus publishStatistics ( const char * pPrefix, 
+        double updatePeriod = 1.0 );
+
+    //
+    // Limits the resources held by each TCP client so that one slow
+    // consumer cannot exhaust the server's memory or delay the others
+    // (see casClientBudget.h). By default there are no limits. Clients
+    // which are disconnected for exceeding the budget are logged.
+    //
+    // Returns S_cas_badParameter if a delay is negative, or if
+    // maxBufferBytes is set without maxOverBudgetDelay.
+    //
+    caStatus setClientBudget ( const casClientBudget & );
+    casClientBudget clientBudget () const;
+
+    //
+    // the resources held by each TCP client (the visitor is called 
+    // with a server lock held, and must not call into the server 
+    // library)
+    //
+    void clientResources ( casClientResourceVisitor & ) const;
+
+    //
+    // Writes the raw requests received from the clients, with the 
+    // time that they were received, to a binary capture file which
+    // casReplay can send to another server (the format is in 
+    // casTrafficCapture.h). Only the TCP circuits accepted after the
+    // capture starts are recorded. Returns S_cas_badParameter if a
+    // capture is already in progress or the file cant be created.
+    //
+    // The capture isnt locked against the clients which write to it,
+    // and so startCapture() and stopCapture() must be called from the
+    // thread which services the server (the thread which calls
+    // fileDescriptorManager.process()), for example from a timer or
+    // a PV's write().
+    //
+    caStatus startCapture ( const char * pFileName );
+    void stopCapture ();
+
     class epicsTimer & createTimer ();
 
     void generateBeaconAnomaly ();
@@ -480,6 +565,46 @@ public:
     //
     virtual unsigned maxDimension () const; // return zero if scalar
     virtual aitIndex maxBound ( unsigned dimension ) const;
+
+    //
+    // Return true if concurrent reads of this PV may share one
+    // asynchronous read. While a read started by read() above is
+    // pending, a read from another client requesting the same
+    // application type and element count does not call read(). It
+    // completes when the pending read completes, and with the same
+    // value, converted to the DBR type requested by that client.
+    //
+    // This is only useful if read() completes asynchronously, and
+    // if any of the clients may be given the value read for another.
+    //
+    // The server library calls this once when the PV is first
+    // attached to. The default (base) "coalesceReads()" returns false.
+    //
+    virtual bool coalesceReads () const;
+
+    //
+    // Return true if the value of this PV is always the value in
+    // the event most recently posted with postEvent() below, as it
+    // is for a PV which only publishes values. The server library
+    // then keeps the last event posted with the value, log, or alarm
+    // event mask. A synchronous read is answered from it, and from 
+    // the last container posted with the property event mask (see
+    // postEvent() below), without calling
+    // beginTransaction(), read(), and endTransaction(), or the
+    // corresponding casChannel functions. read() is still called
+    // until the first event is posted, for DBR_GR and DBR_CTRL reads
+    // until a container is posted with the property event mask, and
+    // for DBR_STSACK_STRING reads.
+    //
+    // The PV must post every change, even when interestRegister()
+    // has not been called, and must not modify a gdd after it is
+    // posted.
+    //
+    // The server library calls this once when the PV is first
+    // attached to. The default (base) "cachePostedEvents()" returns
+    // false.
+    //
+    virtual bool cachePostedEvents () const;
     
     //
     // destroy() is called 
@@ -495,7 +620,22 @@ public:
     //
     // Server tool calls this function to post a PV event.
     //
+    // The server library keeps the last container posted with
+    // the property event mask. The limits, units, precision, and
+    // enum state strings of a DBR_GR or DBR_CTRL subscription update
+    // are taken from it when the posted gdd does not include them.
+    // A PV may therefore post a container with the property event
+    // mask when they change, and only the value otherwise.
+    //
     void postEvent ( const casEventMask & select, const gdd & event );
+
+    //
+    // Copies the histogram of the delay between postEvent() and
+    // the encoding of each subscription update for this PV, summed
+    // over all of its clients. The histogram is empty if the PV
+    // isnt currently installed into a server.
+    //
+    void subscriptionLatency ( casLatencyHistogram & ) const;
     
     //
     // peek at the pv name
@@ -532,6 +672,7 @@ private:
     casPV & operator = ( const casPV & );
 
     friend class casStrmClient;
+    friend class casDirectClient;
 public:
     //
     // This constructor has been deprecated, and is preserved for 
@@ -583,6 +724,11 @@ public:
     // the following are encouraged to change during an channel's
     // lifetime
     //
+    // The server calls these when the channel is created, and again
+    // only after postAccessRightsEvent() is called. The results are
+    // cached, so postAccessRightsEvent() must be called whenever
+    // the access rights change.
+    //
     virtual bool readAccess () const;
     virtual bool writeAccess () const;
     // return true to hint that the opi should ask the operator
@@ -667,6 +813,7 @@ private:
     casChannel ( const casChannel & );
     casChannel & operator = ( const casChannel & );
     friend class casStrmClient;
+    friend class casDirectClient;
 };
 
 //
@@ -28,7 +28,9 @@ chanIntfForPV::chanIntfForPV ( class casCoreClient & clientIn,
 
 chanIntfForPV::~chanIntfForPV () 
 {
-    while ( casMonitor * pMon = this->monitorList.get () ) {
+    tsDLList < casMonitor > tmp;
+    this->monitorSet.removeAll ( tmp );
+    while ( casMonitor * pMon = tmp.get () ) {
 	    this->clientRef.destroyMonitor ( *pMon );
     }
 }
@@ -41,7 +43,7 @@ class casCoreClient & chanIntfForPV::client () const
 void chanIntfForPV::installMonitor ( casPVI & pv, casMonitor & mon )
 {
 	caStatus status = pv.installMonitor ( 
-                    mon, this->monitorList );
+                    mon, this->monitorSet );
 	if ( status ) {
 		errMessage ( status,
 			"Server tool failed to register event\n" );
@@ -51,15 +53,7 @@ void chanIntfForPV::installMonitor ( casPVI & pv, casMonitor & mon )
 void chanIntfForPV::show ( unsigned level ) const
 {
 	printf ( "chanIntfForPV\n" );
-    if ( level > 0 && this->monitorList.count() ) {
-		printf ( "List of subscriptions attached\n" );
-	    tsDLIterConst < casMonitor > iter = 
-            this->monitorList.firstIter ();
-	    while ( iter.valid () ) {
-		    iter->show ( level - 1 );
-		    ++iter;
-	    }
-    }
+    this->monitorSet.show ( level );
 }
 
 
@@ -32,6 +32,7 @@
 
 #include "casStrmClient.h"
 #include "casPVI.h"
+#include "casMonitorSet.h"
 
 class casMonitor;
 class casPVI;
@@ -54,11 +55,12 @@ public:
     casMonitor * removeMonitor ( casPVI &, ca_uint32_t monId );
     void removeSelfFromPV ( casPVI &, 
         tsDLList < casMonitor > & dest );
-    void postEvent ( const casEventMask &, const gdd & );
+    void postEvent ( const casEventMask &, const gdd &,
+        epicsUInt64 posted );
     void show ( unsigned level ) const;
     void postDestroyEvent ();
 private:
-	tsDLList < casMonitor > monitorList;
+	casMonitorSet monitorSet;
 	class casCoreClient & clientRef;
     casChannelDestroyFromPV & destroyRef;
 	chanIntfForPV ( const chanIntfForPV & );
@@ -66,21 +68,22 @@ private:
 };
 
 inline void chanIntfForPV::postEvent (
-    const casEventMask & select, const gdd & event )
+    const casEventMask & select, const gdd & event,
+    epicsUInt64 posted )
 {
-    this->clientRef.postEvent ( this->monitorList, select, event );
+    this->clientRef.postEvent ( this->monitorSet, select, event, posted );
 }
 
 inline casMonitor * chanIntfForPV::removeMonitor ( 
     casPVI & pv, ca_uint32_t clientIdIn )
 {
-    return pv.removeMonitor ( this->monitorList, clientIdIn );
+    return pv.removeMonitor ( this->monitorSet, clientIdIn );
 }
 
 inline void chanIntfForPV::removeSelfFromPV ( 
     casPVI & pv, tsDLList < casMonitor > & dest )
 {
-    pv.removeChannel ( *this, this->monitorList, dest );
+    pv.removeChannel ( *this, this->monitorSet, dest );
 }
 
 inline void chanIntfForPV::postDestroyEvent ()
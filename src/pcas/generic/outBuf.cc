@@ -32,7 +32,8 @@ const char * outBufClient :: ppFlushCondText[3] =
 outBuf::outBuf ( outBufClient & clientIn, 
                 clientBufMemoryManager & memMgrIn ) : 
     client ( clientIn ), memMgr ( memMgrIn ), bufSize ( 0 ), 
-        stack ( 0u ), ctxRecursCount ( 0u )
+        stack ( 0u ), ctxRecursCount ( 0u ), nPostTimesPending ( 0u ),
+        nBytesSentTotal ( 0u )
 {
     casBufferParm bufParm = memMgr.allocate ( 1 );
     this->pBuf = bufParm.pBuf;
@@ -235,6 +236,10 @@ outBufClient::flushCondition outBuf :: flush ()
     //printf ( "send of %u bytes, stat =%s, cost us %f u sec\n", 
     //    this->stack, this->client.ppFlushCondText[cond], ( end - beg ) * 1e6 );
     if ( cond == outBufClient::flushProgress ) {
+        this->nBytesSentTotal += nBytesSent;
+        if ( this->nPostTimesPending ) {
+            this->recordWireLatency ( nBytesSent );
+        }
         if ( nBytesSent >= this->stack ) {
             this->stack = 0u;	
         }
@@ -260,6 +265,42 @@ outBufClient::flushCondition outBuf :: flush ()
     return cond;
 }
 
+//
+// outBuf::notePostTime ()
+//
+void outBuf::notePostTime ( epicsUInt64 posted )
+{
+    if ( this->ctxRecursCount == 0u && 
+            this->nPostTimesPending < nPostTimes ) {
+        postTime & pt = this->postTimes[this->nPostTimesPending++];
+        pt.posted = posted;
+        pt.end = this->stack;
+    }
+}
+
+//
+// outBuf::recordWireLatency ()
+// (the updates which were only partially sent are kept
+// with their offsets adjusted for the bytes removed)
+//
+void outBuf::recordWireLatency ( bufSizeT nBytesSent )
+{
+    epicsUInt64 current = epicsMonotonicGet ();
+    unsigned nKept = 0u;
+    for ( unsigned i = 0u; i < this->nPostTimesPending; i++ ) {
+        postTime & pt = this->postTimes[i];
+        if ( pt.end <= nBytesSent ) {
+            this->wireLatencyHist.record ( pt.posted, current );
+        }
+        else {
+            postTime & kept = this->postTimes[nKept++];
+            kept.posted = pt.posted;
+            kept.end = pt.end - nBytesSent;
+        }
+    }
+    this->nPostTimesPending = nKept;
+}
+
 //
 // outBuf::pushCtx ()
 //
@@ -313,9 +354,15 @@ void outBuf::show (unsigned level) const
 {
     if ( level > 1u ) {
         printf("\tUndelivered response bytes = %d\n", this->bytesPresent());
+        this->wireLatencyHist.show ( "Subscription wire", level );
     }
 }
 
+unsigned outBuf::bufferSize () const
+{
+    return this->bufSize;
+}
+
 void outBuf::expandBuffer (bufSizeT needed)
 {
     if (needed > bufSize) {
@@ -114,6 +114,18 @@ public:
         bufSizeT maxBodySize, void *&pHeader );
 	bufSizeT popCtx ( const outBufCtx & ); // returns actual size
 
+    //
+    // Called after a subscription update is committed with the time
+    // that it was posted. The delay until its last byte is sent is 
+    // recorded in the wire latency histogram. Only the first
+    // nPostTimes updates committed between two sends are sampled.
+    //
+    void notePostTime ( epicsUInt64 posted );
+    const casLatencyHistogram & wireLatency () const;
+
+    // number of bytes sent (rolls over)
+    unsigned bytesSent () const;
+
 private:
     outBufClient & client;       
     clientBufMemoryManager & memMgr;
@@ -121,8 +133,17 @@ private:
 	bufSizeT bufSize;
 	bufSizeT stack;
     unsigned ctxRecursCount;
+    enum { nPostTimes = 64u };
+    struct postTime {
+        epicsUInt64 posted;
+        bufSizeT end; // offset of the end of the update in the buffer
+    } postTimes[nPostTimes];
+    unsigned nPostTimesPending;
+    casLatencyHistogram wireLatencyHist;
+    unsigned nBytesSentTotal;
 
     void expandBuffer (bufSizeT needed);
+    void recordWireLatency ( bufSizeT nBytesSent );
 
 	outBuf ( const outBuf & );
 	outBuf & operator = ( const outBuf & );
@@ -146,6 +167,16 @@ inline void outBuf::commitRawMsg (bufSizeT size)
 	assert ( this->stack <= this->bufSize );
 }
 
+inline const casLatencyHistogram & outBuf::wireLatency () const
+{
+    return this->wireLatencyHist;
+}
+
+inline unsigned outBuf::bytesSent () const
+{
+    return this->nBytesSentTotal;
+}
+
 //
 // outBufCtx::outBufCtx ()
 //
@@ -0,0 +1,245 @@
+/*************************************************************************\
+* Copyright (c) 2002 The University of Chicago, as Operator of Argonne
+*     National Laboratory.
+* Copyright (c) 2002 The Regents of the University of California, as
+*     Operator of Los Alamos National Laboratory.
+* EPICS BASE is distributed subject to a Software License Agreement found
+* in file LICENSE that is included with this distribution.
+\*************************************************************************/
+
+//
+// slotIdTable
+//
+// Resource id table for the server ids handed out to a client. The id
+// is the index of a slot in a dense array (low order bits) tagged with
+// the generation count of that slot (high order bits). A lookup is
+// therefore a bounds check and one array load, and the generation
+// tag rejects stale ids that refer to a slot which has since been
+// reused. Free slots are recycled in FIFO order so that an id is
+// not reissued any sooner than necessary.
+//
+
+#ifndef slotIdTableh
+#define slotIdTableh
+
+#include <new>
+#include <stdio.h>
+
+#ifdef epicsExportSharedSymbols
+#   define epicsExportSharedSymbols_slotIdTableh
+#   undef epicsExportSharedSymbols
+#endif
+
+#include "epicsTypes.h"
+#include "epicsAssert.h"
+
+#ifdef epicsExportSharedSymbols_slotIdTableh
+#   define epicsExportSharedSymbols
+#   include "shareLib.h"
+#endif
+
+static const unsigned slotIdIndexBits = 20u;
+static const epicsUInt32 slotIdIndexMask = ( 1u << slotIdIndexBits ) - 1u;
+static const epicsUInt32 slotIdGenMask = 0xffffffff >> slotIdIndexBits;
+// the last index is never used so that ~0u is never a valid id
+static const epicsUInt32 slotIdMaxSlots = slotIdIndexMask;
+static const epicsUInt32 slotIdMinSlots = 16u;
+static const epicsUInt32 slotIdNil = 0xffffffff;
+
+template < class T > class slotIdTable;
+
+//
+// slotIdRes
+//
+// resource installed into a slotIdTable
+//
+class slotIdRes {
+public:
+    slotIdRes ();
+    epicsUInt32 getId () const;
+private:
+    epicsUInt32 id;
+    template < class T > friend class slotIdTable;
+};
+
+template < class T >
+class slotIdTable {
+public:
+    slotIdTable ();
+    ~slotIdTable ();
+    void idAssignAdd ( T & res );
+    T * lookup ( epicsUInt32 id ) const;
+    T * remove ( epicsUInt32 id );
+    void remove ( T & res );
+    unsigned numEntriesInstalled () const;
+    void show ( unsigned level ) const;
+private:
+    struct slot {
+        T * pRes;
+        epicsUInt32 gen;
+        epicsUInt32 nextFree;
+    };
+    slot * pSlots;
+    epicsUInt32 nSlots;
+    epicsUInt32 nInstalled;
+    epicsUInt32 freeHead;
+    epicsUInt32 freeTail;
+    void grow ();
+    void release ( epicsUInt32 index );
+    slotIdTable ( const slotIdTable & );
+    slotIdTable & operator = ( const slotIdTable & );
+};
+
+inline slotIdRes::slotIdRes () :
+    id ( slotIdNil )
+{
+}
+
+inline epicsUInt32 slotIdRes::getId () const
+{
+    return this->id;
+}
+
+template < class T >
+inline slotIdTable < T > :: slotIdTable () :
+    pSlots ( 0 ), nSlots ( 0u ), nInstalled ( 0u ),
+    freeHead ( slotIdNil ), freeTail ( slotIdNil )
+{
+}
+
+template < class T >
+inline slotIdTable < T > :: ~slotIdTable ()
+{
+    delete [] this->pSlots;
+}
+
+template < class T >
+inline T * slotIdTable < T > :: lookup ( epicsUInt32 id ) const
+{
+    epicsUInt32 index = id & slotIdIndexMask;
+    if ( index >= this->nSlots ) {
+        return 0;
+    }
+    const slot & s = this->pSlots[index];
+    if ( s.gen != ( id >> slotIdIndexBits ) ) {
+        return 0;
+    }
+    return s.pRes;
+}
+
+template < class T >
+void slotIdTable < T > :: idAssignAdd ( T & res )
+{
+    if ( this->freeHead == slotIdNil ) {
+        this->grow ();
+    }
+    epicsUInt32 index = this->freeHead;
+    slot & s = this->pSlots[index];
+    this->freeHead = s.nextFree;
+    if ( this->freeHead == slotIdNil ) {
+        this->freeTail = slotIdNil;
+    }
+    s.nextFree = slotIdNil;
+    s.pRes = & res;
+    this->nInstalled++;
+    static_cast < slotIdRes & > ( res ).id =
+        ( s.gen << slotIdIndexBits ) | index;
+}
+
+template < class T >
+T * slotIdTable < T > :: remove ( epicsUInt32 id )
+{
+    T * pRes = this->lookup ( id );
+    if ( pRes ) {
+        this->release ( id & slotIdIndexMask );
+    }
+    return pRes;
+}
+
+template < class T >
+void slotIdTable < T > :: remove ( T & res )
+{
+    epicsUInt32 id = static_cast < slotIdRes & > ( res ).id;
+    if ( this->lookup ( id ) == & res ) {
+        this->release ( id & slotIdIndexMask );
+    }
+}
+
+template < class T >
+inline unsigned slotIdTable < T > :: numEntriesInstalled () const
+{
+    return this->nInstalled;
+}
+
+template < class T >
+void slotIdTable < T > :: show ( unsigned level ) const
+{
+    printf ( "slotIdTable with %u resources installed in %u slots\n",
+        this->nInstalled, this->nSlots );
+    if ( level > 0u ) {
+        printf ( "\t%u bytes of slot storage\n",
+            static_cast < unsigned > ( this->nSlots * sizeof ( slot ) ) );
+    }
+}
+
+//
+// retire the id by advancing the generation count
+// of the slot and place the slot at the end of the
+// free list
+//
+template < class T >
+void slotIdTable < T > :: release ( epicsUInt32 index )
+{
+    slot & s = this->pSlots[index];
+    s.pRes = 0;
+    s.gen = ( s.gen + 1u ) & slotIdGenMask;
+    s.nextFree = slotIdNil;
+    if ( this->freeTail == slotIdNil ) {
+        this->freeHead = index;
+    }
+    else {
+        this->pSlots[this->freeTail].nextFree = index;
+    }
+    this->freeTail = index;
+    assert ( this->nInstalled > 0u );
+    this->nInstalled--;
+}
+
+//
+// throws std::bad_alloc when the table cant be expanded
+//
+template < class T >
+void slotIdTable < T > :: grow ()
+{
+    if ( this->nSlots >= slotIdMaxSlots ) {
+        throw std::bad_alloc ();
+    }
+    epicsUInt32 newSize = this->nSlots * 2u;
+    if ( newSize < slotIdMinSlots ) {
+        newSize = slotIdMinSlots;
+    }
+    else if ( newSize > slotIdMaxSlots ) {
+        newSize = slotIdMaxSlots;
+    }
+    slot * pNewSlots = new slot [ newSize ];
+    for ( epicsUInt32 i = 0u; i < this->nSlots; i++ ) {
+        pNewSlots[i] = this->pSlots[i];
+    }
+    for ( epicsUInt32 i = this->nSlots; i < newSize; i++ ) {
+        pNewSlots[i].pRes = 0;
+        pNewSlots[i].gen = 0u;
+        pNewSlots[i].nextFree = i + 1u;
+    }
+    pNewSlots[newSize - 1u].nextFree = slotIdNil;
+
+    // only called when the free list is empty
+    assert ( this->freeHead == slotIdNil );
+    this->freeHead = this->nSlots;
+    this->freeTail = newSize - 1u;
+
+    delete [] this->pSlots;
+    this->pSlots = pNewSlots;
+    this->nSlots = newSize;
+}
+
+#endif // slotIdTableh
@@ -19,11 +19,12 @@
 
 class casServerReg : public fdReg {
 public:
-    casServerReg (casIntfOS &osIn) :
-    fdReg (osIn.casIntfIO::getFD(), fdrRead), os (osIn) {}
+    casServerReg ( casIntfOS &osIn, int fd, bool localIn ) :
+    fdReg ( fd, fdrRead ), os ( osIn ), local ( localIn ) {}
     ~casServerReg ();
 private:
     casIntfOS &os;
+    bool local; // the Unix domain socket
     void callBack ();
 	casServerReg ( const casServerReg & );
 	casServerReg & operator = ( const casServerReg & );
@@ -31,25 +32,34 @@ private:
 
 casIntfOS::casIntfOS ( caServerI & casIn, clientBufMemoryManager & memMgrIn,
     const caNetAddr & addrIn, bool autoBeaconAddr, bool addConfigBeaconAddr ) : 
-    casIntfIO ( addrIn ),
+    casIntfIO ( casIn, addrIn ),
     casDGIntfOS ( casIn, memMgrIn, addrIn, autoBeaconAddr, 
         addConfigBeaconAddr ),
     cas ( casIn )
 {    
     this->setNonBlocking();
     
-    this->pRdReg = new casServerReg ( *this );
+    this->pRdReg = new casServerReg ( *this, 
+        this->casIntfIO::getFD (), false );
+    if ( this->getLocalFD () != INVALID_SOCKET ) {
+        this->pLocalRdReg = new casServerReg ( *this, 
+            this->getLocalFD (), true );
+    }
+    else {
+        this->pLocalRdReg = 0;
+    }
 }
 
 casIntfOS::~casIntfOS()
 {
 	delete this->pRdReg;
+	delete this->pLocalRdReg;
 }
 
 void casServerReg::callBack()
 {
 	assert ( this->os.pRdReg );
-	this->os.cas.connectCB ( this->os );	
+	this->os.cas.connectCB ( this->os, this->local );	
 }
 
 casServerReg::~casServerReg()
@@ -33,6 +33,7 @@ public:
 private:
 	caServerI & cas;
 	class casServerReg * pRdReg;
+	class casServerReg * pLocalRdReg; // nil if no local socket
 
 	casIntfOS ( const casIntfOS & );
 	casIntfOS & operator = ( const casIntfOS & );
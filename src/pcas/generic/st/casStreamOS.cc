@@ -99,8 +99,12 @@ private:
 //
 // casStreamWriteReg::casStreamWriteReg()
 //
+// a client with a shared memory ring signals when there
+// is space in it with an eventfd
+//
 inline casStreamWriteReg::casStreamWriteReg (casStreamOS &osIn) :
-	fdReg (osIn.getFD(), fdrWrite, true), os (osIn)
+	fdReg (osIn.getSendFD(), 
+        osIn.sendFDIsReadable() ? fdrRead : fdrWrite, true), os (osIn)
 {
     this->os.printStatus ( "write schedualed" );
 }
@@ -368,12 +372,8 @@ casStreamOS::casStreamOS (
     casStreamIO ( cas, bufMgrIn, ioArgs ),
     evWk ( *this ), 
     pWtReg ( 0 ), 
-    pRdReg ( 0 ), 
-    _sendBacklogThresh ( osSendBufferSize () / 2u )
+    pRdReg ( 0 )
 {
- 	if ( _sendBacklogThresh < MAX_TCP / 2 ) {
-	    _sendBacklogThresh = MAX_TCP / 2;
-	}
 	this->xSetNonBlocking ();
 	this->armRecv ();
 }
@@ -624,7 +624,13 @@ void casStreamOS::sendCB ()
 bool casStreamOS :: 
     _sendNeeded () const 
 {
-    bool sn = this->outBufBytesPending() >= this->_sendBacklogThresh;
+    // not cached because the shared memory ring of a local 
+    // client is attached when its first bytes are received
+    bufSizeT sendBacklogThresh = this->osSendBufferSize () / 2u;
+    if ( sendBacklogThresh < MAX_TCP / 2 ) {
+        sendBacklogThresh = MAX_TCP / 2;
+    }
+    bool sn = this->outBufBytesPending() >= sendBacklogThresh;
     bufSizeT inBytesPending = this->inBufBytesPending ();
     return sn || ( inBytesPending == 0u );
 }   
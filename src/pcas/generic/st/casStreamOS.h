@@ -68,7 +68,6 @@ private:
 	casStreamIOWakeup ioWk;
 	class casStreamWriteReg * pWtReg;
 	class casStreamReadReg * pRdReg;
-	bufSizeT _sendBacklogThresh;
 	void armSend ();
 	void armRecv ();
 	void disarmSend();
@@ -12,6 +12,9 @@
 //
 
 #include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stddef.h>
 
 #include "errlog.h"
 #define epicsAssertAuthor "Jeff Hill johill@lanl.gov"
@@ -24,6 +27,11 @@
 #include "casStreamIO.h"
 #include "casStreamOS.h"
 
+#ifdef CAS_LOCAL_SOCKET_SUPPORTED
+#   include <unistd.h>
+#   include <sys/un.h>
+#endif
+
 //
 // 5 appears to be a TCP/IP built in maximum
 //
@@ -32,9 +40,11 @@ const unsigned caServerConnectPendQueueSize = 5u;
 //
 // casIntfIO::casIntfIO()
 //
-casIntfIO::casIntfIO ( const caNetAddr & addrIn ) :
+casIntfIO::casIntfIO ( caServerI & cas, const caNetAddr & addrIn ) :
     sock ( INVALID_SOCKET ),
-    addr ( addrIn.getSockIP() )
+    localSock ( INVALID_SOCKET ),
+    addr ( addrIn.getSockIP() ),
+    pLocalName ( 0 )
 {
     int status;
     osiSocklen_t addrSize;
@@ -127,6 +137,135 @@ casIntfIO::casIntfIO ( const caNetAddr & addrIn ) :
         epicsSocketDestroy (this->sock);
         throw S_cas_internal;
     }
+
+    this->listenLocal ( cas );
+}
+
+#ifdef CAS_LOCAL_SOCKET_SUPPORTED
+
+//
+// a file left by a server which has exited refuses connections
+//
+static bool localNameIsStale ( const struct sockaddr_un & name, 
+                              osiSocklen_t size )
+{
+    SOCKET probe = epicsSocketCreate ( AF_UNIX, SOCK_STREAM, 0 );
+    if ( probe == INVALID_SOCKET ) {
+        return false;
+    }
+    int status = connect ( probe, 
+        reinterpret_cast < const sockaddr * > ( & name ), size );
+    bool stale = status < 0 && SOCKERRNO == SOCK_ECONNREFUSED;
+    epicsSocketDestroy ( probe );
+    return stale;
+}
+
+#endif
+
+//
+// casIntfIO::listenLocal()
+//
+// The interfaces of a server which have the same TCP port also
+// have the same conventional local socket name, and only the first
+// one that binds the name accepts the local clients. A name in use
+// by anything else is reported, because the local clients of this
+// server would then connect to whoever holds it.
+//
+void casIntfIO::listenLocal ( caServerI & cas )
+{
+#ifdef CAS_LOCAL_SOCKET_SUPPORTED
+    const char * pName = getenv ( "EPICS_CAS_LOCAL_SOCKET" );
+    if ( ! pName || pName[0] == '\0' || 
+            strcmp ( pName, "NO" ) == 0 || strcmp ( pName, "no" ) == 0 ) {
+        return;
+    }
+
+    char conventionalName[64];
+    bool conventional = 
+        strcmp ( pName, "YES" ) == 0 || strcmp ( pName, "yes" ) == 0;
+    if ( conventional ) {
+        sprintf ( conventionalName, CAS_LOCAL_SOCKET_NAME, 
+            static_cast < unsigned > ( ntohs ( this->addr.sin_port ) ) );
+        pName = conventionalName;
+    }
+
+    struct sockaddr_un name;
+    memset ( & name, '\0', sizeof ( name ) );
+    name.sun_family = AF_UNIX;
+    size_t length = strlen ( pName );
+    if ( length >= sizeof ( name.sun_path ) ) {
+        errlogPrintf ( "CAS: local socket name \"%s\" is too long\n", 
+            pName );
+        return;
+    }
+    memcpy ( name.sun_path, pName, length );
+    bool abstract = pName[0] == '@';
+    osiSocklen_t size;
+    if ( abstract ) {
+        name.sun_path[0] = '\0';
+        size = static_cast < osiSocklen_t > ( 
+            offsetof ( struct sockaddr_un, sun_path ) + length );
+    }
+    else {
+        size = static_cast < osiSocklen_t > ( sizeof ( name ) );
+    }
+
+    SOCKET newSock = epicsSocketCreate ( AF_UNIX, SOCK_STREAM, 0 );
+    if ( newSock == INVALID_SOCKET ) {
+        char sockErrBuf[64];
+        epicsSocketConvertErrnoToString ( sockErrBuf, sizeof ( sockErrBuf ) );
+        errlogPrintf ( "CAS: no local socket because %s\n", sockErrBuf );
+        return;
+    }
+
+    int status = bind ( newSock, 
+        reinterpret_cast < sockaddr * > ( & name ), size );
+    if ( status < 0 && SOCKERRNO == SOCK_EADDRINUSE && ! abstract &&
+            localNameIsStale ( name, size ) ) {
+        unlink ( name.sun_path );
+        status = bind ( newSock, 
+            reinterpret_cast < sockaddr * > ( & name ), size );
+    }
+    if ( status < 0 ) {
+        int errnoCpy = SOCKERRNO;
+        if ( errnoCpy == SOCK_EADDRINUSE ) {
+            // quietly leave the name to another interface 
+            // of this server
+            if ( ! cas.holdsLocalSocketName ( pName ) ) {
+                errlogPrintf ( "CAS: local socket name \"%s\" is in use by "
+                    "another process, which may receive this server's "
+                    "local clients\n", pName );
+            }
+        }
+        else {
+            char sockErrBuf[64];
+            epicsSocketConvertErrnoToString ( 
+                sockErrBuf, sizeof ( sockErrBuf ) );
+            errlogPrintf ( "CAS: local socket bind to \"%s\" failed with %s\n",
+                pName, sockErrBuf );
+        }
+        epicsSocketDestroy ( newSock );
+        return;
+    }
+
+    status = listen ( newSock, caServerConnectPendQueueSize );
+    if ( status < 0 ) {
+        char sockErrBuf[64];
+        epicsSocketConvertErrnoToString ( sockErrBuf, sizeof ( sockErrBuf ) );
+        errlogPrintf ( "CAS: local socket listen() error %s\n", sockErrBuf );
+        epicsSocketDestroy ( newSock );
+        if ( ! abstract ) {
+            unlink ( name.sun_path );
+        }
+        return;
+    }
+
+    // the name is held, and removed by the destructor, only once 
+    // the socket accepts clients
+    this->pLocalName = new char [ length + 1u ];
+    strcpy ( this->pLocalName, pName );
+    this->localSock = newSock;
+#endif
 }
 
 //
@@ -137,6 +276,15 @@ casIntfIO::~casIntfIO()
     if (this->sock != INVALID_SOCKET) {
         epicsSocketDestroy (this->sock);
     }
+    if ( this->localSock != INVALID_SOCKET ) {
+        epicsSocketDestroy ( this->localSock );
+    }
+#ifdef CAS_LOCAL_SOCKET_SUPPORTED
+    if ( this->pLocalName && this->pLocalName[0] != '@' ) {
+        unlink ( this->pLocalName );
+    }
+#endif
+    delete [] this->pLocalName;
 
     osiSockRelease ();
 }
@@ -172,11 +320,55 @@ casStreamOS *casIntfIO::newStreamClient ( caServerI & cas,
     ioArgsToNewStreamIO args;
     args.clientAddr = newClientAddr;
     args.sock = newSock;
+    args.local = false;
+    return this->createStreamClient ( cas, bufMgr, args );
+}
+
+//
+// casIntfIO::newLocalStreamClient()
+//
+// the clients of the Unix domain socket are all on this host
+//
+casStreamOS * casIntfIO::newLocalStreamClient ( caServerI & cas,
+                               clientBufMemoryManager & bufMgr ) const
+{
+    static bool oneMsgFlag = false;
+
+    SOCKET newSock = epicsSocketAccept ( this->localSock, 0, 0 );
+    if ( newSock == INVALID_SOCKET ) {
+        int errnoCpy = SOCKERRNO;
+        if ( errnoCpy != SOCK_EWOULDBLOCK && ! oneMsgFlag ) {
+            char sockErrBuf[64];
+            epicsSocketConvertErrnoToString ( sockErrBuf, sizeof ( sockErrBuf ) );
+            errlogPrintf ( "CAS: %s local accept error \"%s\"\n",
+                __FILE__, sockErrBuf );
+            oneMsgFlag = true;
+        }
+        return NULL;
+    }
+    oneMsgFlag = false;
+    struct sockaddr_in loopback;
+    memset ( & loopback, '\0', sizeof ( loopback ) );
+    loopback.sin_family = AF_INET;
+    loopback.sin_addr.s_addr = htonl ( INADDR_LOOPBACK );
+    ioArgsToNewStreamIO args;
+    args.clientAddr = caNetAddr ( loopback );
+    args.sock = newSock;
+    args.local = true;
+    return this->createStreamClient ( cas, bufMgr, args );
+}
+
+//
+// casIntfIO::createStreamClient()
+//
+casStreamOS * casIntfIO::createStreamClient ( caServerI & cas,
+    clientBufMemoryManager & bufMgr, const ioArgsToNewStreamIO & args ) const
+{
     casStreamOS	* pOS = new casStreamOS ( cas, bufMgr, args );
     if ( ! pOS ) {
         errMessage ( S_cas_noMemory,
             "unable to create data structures for a new client" );
-        epicsSocketDestroy ( newSock );
+        epicsSocketDestroy ( args.sock );
     }
     else {
         if ( cas.getDebugLevel() > 0u ) {
@@ -198,6 +390,9 @@ void casIntfIO::setNonBlocking()
     osiSockIoctl_t yes = true;
 
     status = socket_ioctl(this->sock, FIONBIO, &yes);
+    if ( status >= 0 && this->localSock != INVALID_SOCKET ) {
+        status = socket_ioctl ( this->localSock, FIONBIO, &yes );
+    }
     if ( status < 0 ) {
         char sockErrBuf[64];
         epicsSocketConvertErrnoToString ( sockErrBuf, sizeof ( sockErrBuf ) );
@@ -215,6 +410,22 @@ int casIntfIO::getFD() const
     return this->sock;
 }
 
+//
+// casIntfIO::getLocalFD()
+//
+int casIntfIO::getLocalFD() const
+{
+    return this->localSock;
+}
+
+//
+// casIntfIO::localSocketName()
+//
+const char * casIntfIO::localSocketName () const
+{
+    return this->pLocalName;
+}
+
 //
 // casIntfIO::show()
 //
@@ -222,6 +433,9 @@ void casIntfIO::show(unsigned level) const
 {
     if (level>2u) {
         printf(" casIntfIO::sock = %d\n", this->sock);
+        if ( this->localSock != INVALID_SOCKET ) {
+            printf ( " casIntfIO::localSock = %d\n", this->localSock );
+        }
     }
 }
 
@@ -24,20 +24,28 @@
 #   include "shareLib.h"
 #endif
 
+#include "casLocalSocket.h"
+
 class caNetAddr;
 class caServerI;
 class clientBufMemoryManager;
+struct ioArgsToNewStreamIO;
 
 //
 // casIntfIO
 //
 class casIntfIO {
 public:
-	casIntfIO ( const caNetAddr & addr );
+	casIntfIO ( caServerI & cas, const caNetAddr & addr );
 	virtual ~casIntfIO ();
 	void show ( unsigned level ) const;
 
 	int getFD () const;
+    // the Unix domain listen socket (see casLocalSocket.h), 
+    // or INVALID_SOCKET if there isnt one
+	int getLocalFD () const;
+    // the name that the local socket is bound to, or nil
+    const char * localSocketName () const;
 
 	void setNonBlocking ();
 
@@ -47,12 +55,21 @@ public:
 	// 
 	class casStreamOS * newStreamClient ( caServerI & cas, 
         clientBufMemoryManager & ) const;
+	class casStreamOS * newLocalStreamClient ( caServerI & cas, 
+        clientBufMemoryManager & ) const;
 
     caNetAddr serverAddress () const;
     
 private:
 	SOCKET sock;
+	SOCKET localSock;
 	struct sockaddr_in addr;
+    char * pLocalName; // a file is removed by the destructor
+    void listenLocal ( caServerI & cas );
+    class casStreamOS * createStreamClient ( caServerI & cas, 
+        clientBufMemoryManager &, const ioArgsToNewStreamIO & ) const;
+	casIntfIO ( const casIntfIO & );
+	casIntfIO & operator = ( const casIntfIO & );
 };
 
 #endif // casIntfIOh
@@ -0,0 +1,227 @@
+/*************************************************************************\
+* Copyright (c) 2002 The University of Chicago, as Operator of Argonne
+*     National Laboratory.
+* Copyright (c) 2002 The Regents of the University of California, as
+*     Operator of Los Alamos National Laboratory.
+* EPICS BASE is distributed subject to a Software License Agreement found
+* in file LICENSE that is included with this distribution.
+\*************************************************************************/
+
+#include <stdio.h>
+#include <string.h>
+#include <errno.h>
+
+#include "errlog.h"
+
+#define epicsExportSharedSymbols
+#include "casdef.h"
+#include "casLocalRing.h"
+
+#ifdef CAS_LOCAL_RING_SUPPORTED
+
+#include <stdint.h>
+#include <unistd.h>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+//
+// casLocalRing::casLocalRing()
+//
+casLocalRing::casLocalRing ( int memFDIn, int dataEventFDIn,
+                            int spaceEventFDIn ) :
+    pHeader ( 0 ), pData ( 0 ), mapSize ( 0u ), memFD ( memFDIn ),
+    dataEventFD ( dataEventFDIn ), spaceEventFD ( spaceEventFDIn ),
+    ringSize ( 0u ), head ( 0u ), spaceWait ( false )
+{
+    const char * pReason = 0;
+
+    //
+    // the client must not be able to truncate the memory
+    // from under us
+    //
+    struct stat st;
+    int seals = fcntl ( this->memFD, F_GET_SEALS );
+    casLocalRingHeader header;
+    if ( seals < 0 || ! ( seals & F_SEAL_SHRINK ) ) {
+        pReason = "it isnt a memfd sealed with F_SEAL_SHRINK";
+    }
+    else if ( fstat ( this->memFD, & st ) < 0 ||
+            pread ( this->memFD, & header, sizeof ( header ), 0 ) !=
+                static_cast < ssize_t > ( sizeof ( header ) ) ) {
+        pReason = "its header cant be read";
+    }
+    else if ( header.magic != CAS_LOCAL_RING_MAGIC ||
+            header.version != CAS_LOCAL_RING_VERSION ) {
+        pReason = "its header has the wrong magic number or version";
+    }
+    else if ( header.size == 0u || header.size > 0x80000000u ||
+            ( header.size & ( header.size - 1u ) ) != 0u ||
+            static_cast < uint64_t > ( st.st_size ) <
+                CAS_LOCAL_RING_DATA_OFFSET +
+                    static_cast < uint64_t > ( header.size ) ) {
+        pReason = "its size isnt a power of two within the memfd";
+    }
+    else if ( header.head != header.tail ) {
+        pReason = "it isnt empty";
+    }
+    else {
+        int flags = fcntl ( this->spaceEventFD, F_GETFL );
+        if ( flags < 0 ||
+                fcntl ( this->spaceEventFD, F_SETFL, flags | O_NONBLOCK ) < 0 ) {
+            pReason = "its space eventfd cant be set to non-blocking";
+        }
+    }
+
+    if ( ! pReason ) {
+        this->mapSize = CAS_LOCAL_RING_DATA_OFFSET + header.size;
+        void * p = mmap ( 0, this->mapSize, PROT_READ | PROT_WRITE,
+            MAP_SHARED, this->memFD, 0 );
+        if ( p == MAP_FAILED ) {
+            pReason = strerror ( errno );
+        }
+        else {
+            this->pHeader = static_cast < casLocalRingHeader * > ( p );
+            this->pData = static_cast < char * > ( p ) +
+                CAS_LOCAL_RING_DATA_OFFSET;
+        }
+    }
+
+    if ( pReason ) {
+        errlogPrintf ( "CAS: local client's ring refused because %s\n",
+            pReason );
+        this->destroy ();
+        throw S_cas_badProtocol;
+    }
+
+    this->ringSize = header.size;
+    this->head = header.head;
+    __sync_synchronize ();
+    this->pHeader->attached = 1u;
+}
+
+//
+// casLocalRing::~casLocalRing()
+//
+casLocalRing::~casLocalRing ()
+{
+    this->destroy ();
+}
+
+//
+// casLocalRing::destroy()
+//
+void casLocalRing::destroy ()
+{
+    if ( this->pHeader ) {
+        munmap ( this->pHeader, this->mapSize );
+        this->pHeader = 0;
+    }
+    close ( this->memFD );
+    close ( this->dataEventFD );
+    close ( this->spaceEventFD );
+}
+
+//
+// casLocalRing::space()
+//
+// returns false if the client has corrupted its tail
+//
+bool casLocalRing::space ( bufSizeT & nBytes ) const
+{
+    epicsUInt32 used = this->head - this->pHeader->tail;
+    if ( used > this->ringSize ) {
+        return false;
+    }
+    nBytes = this->ringSize - used;
+    return true;
+}
+
+//
+// casLocalRing::send()
+//
+outBufClient::flushCondition casLocalRing::send ( const char * pBuf,
+    bufSizeT nBytesReq, bufSizeT & nBytesActual )
+{
+    if ( this->spaceWait ) {
+        // the space eventfd is non-blocking
+        uint64_t count;
+        ssize_t status = read ( this->spaceEventFD, & count, sizeof ( count ) );
+        if ( status < 0 && errno != EAGAIN && errno != EINTR ) {
+            errlogPrintf ( "CAS: local ring space eventfd read failed with %s\n",
+                strerror ( errno ) );
+            return outBufClient::flushDisconnect;
+        }
+        this->spaceWait = false;
+    }
+
+    bufSizeT nBytes;
+    if ( ! this->space ( nBytes ) ) {
+        errlogPrintf ( "CAS: local client corrupted its ring\n" );
+        return outBufClient::flushDisconnect;
+    }
+    if ( nBytes == 0u ) {
+        //
+        // the client checks this after it advances the
+        // tail, and we check the tail again after setting it
+        //
+        this->pHeader->serverWaiting = 1u;
+        __sync_synchronize ();
+        if ( ! this->space ( nBytes ) ) {
+            errlogPrintf ( "CAS: local client corrupted its ring\n" );
+            return outBufClient::flushDisconnect;
+        }
+        if ( nBytes == 0u ) {
+            this->spaceWait = true;
+            return outBufClient::flushNone;
+        }
+    }
+    if ( nBytes > nBytesReq ) {
+        nBytes = nBytesReq;
+    }
+
+    epicsUInt32 offset = this->head & ( this->ringSize - 1u );
+    bufSizeT nFirst = this->ringSize - offset;
+    if ( nFirst > nBytes ) {
+        nFirst = nBytes;
+    }
+    memcpy ( this->pData + offset, pBuf, nFirst );
+    memcpy ( this->pData, pBuf + nFirst, nBytes - nFirst );
+    this->head += nBytes;
+
+    // the bytes must be visible before the head, and the
+    // head before we check if the client is waiting
+    __sync_synchronize ();
+    this->pHeader->head = this->head;
+    __sync_synchronize ();
+    if ( this->pHeader->clientWaiting ) {
+        this->pHeader->clientWaiting = 0u;
+        uint64_t one = 1u;
+        ssize_t status = write ( this->dataEventFD, & one, sizeof ( one ) );
+        if ( status < 0 && errno != EAGAIN && errno != EINTR ) {
+            errlogPrintf ( "CAS: local ring data eventfd write failed with %s\n",
+                strerror ( errno ) );
+            return outBufClient::flushDisconnect;
+        }
+    }
+
+    nBytesActual = nBytes;
+    return outBufClient::flushProgress;
+}
+
+//
+// casLocalRing::show()
+//
+void casLocalRing::show ( unsigned level ) const
+{
+    printf ( "casLocalRing at %p with %u bytes\n",
+        static_cast < const void * > ( this ), this->ringSize );
+    if ( level > 1u ) {
+        bufSizeT nBytes = 0u;
+        this->space ( nBytes );
+        printf ( "\t%u bytes free, head %u, %s\n", nBytes, this->head,
+            this->spaceWait ? "waiting for space" : "not waiting" );
+    }
+}
+
+#endif // CAS_LOCAL_RING_SUPPORTED
@@ -0,0 +1,65 @@
+/*************************************************************************\
+* Copyright (c) 2002 The University of Chicago, as Operator of Argonne
+*     National Laboratory.
+* Copyright (c) 2002 The Regents of the University of California, as
+*     Operator of Los Alamos National Laboratory.
+* EPICS BASE is distributed subject to a Software License Agreement found
+* in file LICENSE that is included with this distribution.
+\*************************************************************************/
+
+#ifndef casLocalRingh
+#define casLocalRingh
+
+#include "outBuf.h"
+#include "casLocalSocket.h"
+
+#ifdef CAS_LOCAL_RING_SUPPORTED
+
+//
+// casLocalRing
+//
+// the server's side of the shared memory ring of a local client
+// (see casLocalSocket.h), only on the targets which support it
+//
+class casLocalRing {
+public:
+    //
+    // takes ownership of the file descriptors, and throws
+    // S_cas_badProtocol if they arent a ring
+    //
+    casLocalRing ( int memFD, int dataEventFD, int spaceEventFD );
+    ~casLocalRing ();
+    outBufClient::flushCondition send ( const char * pBuf,
+        bufSizeT nBytesReq, bufSizeT & nBytesActual );
+    int getSpaceFD () const;
+    bufSizeT size () const;
+    void show ( unsigned level ) const;
+private:
+    casLocalRingHeader * pHeader;
+    char * pData;
+    size_t mapSize;
+    int memFD;
+    int dataEventFD;
+    int spaceEventFD;
+    epicsUInt32 ringSize;
+    epicsUInt32 head; // not read back from the client's memory
+    bool spaceWait;
+    bool space ( bufSizeT & nBytes ) const;
+    void destroy ();
+    casLocalRing ( const casLocalRing & );
+    casLocalRing & operator = ( const casLocalRing & );
+};
+
+inline int casLocalRing::getSpaceFD () const
+{
+    return this->spaceEventFD;
+}
+
+inline bufSizeT casLocalRing::size () const
+{
+    return this->ringSize;
+}
+
+#endif // CAS_LOCAL_RING_SUPPORTED
+
+#endif // casLocalRingh
@@ -11,11 +11,19 @@
 // Author: Jeff Hill
 //
 
+#include <string.h>
+
 #include "errlog.h"
 
 #define epicsExportSharedSymbols
 #include "casStreamIO.h"
 
+#ifdef CAS_LOCAL_RING_SUPPORTED
+#   include "casLocalRing.h"
+#   include <unistd.h>
+#   include <sys/uio.h>
+#endif
+
 // casStreamIO::casStreamIO()
 casStreamIO::casStreamIO ( caServerI & cas, clientBufMemoryManager & bufMgr,
                            const ioArgsToNewStreamIO & args ) :
@@ -23,40 +31,51 @@ casStreamIO::casStreamIO ( caServerI & cas, clientBufMemoryManager & bufMgr,
     sock ( args.sock ),  
     _osSendBufferSize ( MAX_TCP ), 
     blockingFlag ( xIsBlocking ),
+    local ( args.local ),
+#ifdef CAS_LOCAL_RING_SUPPORTED
+    pRing ( 0 ),
+#endif
+    ringMayAttach ( args.local ),
     sockHasBeenShutdown ( false )
 {
 	assert ( sock >= 0 );
 	int yes = true;
 	int	status;
 
-	/*
-	 * see TCP(4P) this seems to make unsollicited single events much
-	 * faster. I take care of queue up as load increases.
-	 */
-	status = setsockopt ( this->sock, IPPROTO_TCP, TCP_NODELAY,
-							( char * ) & yes, sizeof ( yes ) );
-	if ( status < 0 ) {
-        char sockErrBuf[64];
-        epicsSocketConvertErrnoToString ( sockErrBuf, sizeof ( sockErrBuf ) );
-		errlogPrintf (
-			"CAS: %s TCP_NODELAY option set failed %s\n",
-			__FILE__, sockErrBuf );
-		throw S_cas_internal;
-	}
+	//
+	// the TCP options dont apply to a Unix domain socket, and
+	// a local client which exits is always detected
+	//
+	if ( ! this->local ) {
+		/*
+		 * see TCP(4P) this seems to make unsollicited single events much
+		 * faster. I take care of queue up as load increases.
+		 */
+		status = setsockopt ( this->sock, IPPROTO_TCP, TCP_NODELAY,
+								( char * ) & yes, sizeof ( yes ) );
+		if ( status < 0 ) {
+	        char sockErrBuf[64];
+	        epicsSocketConvertErrnoToString ( sockErrBuf, sizeof ( sockErrBuf ) );
+			errlogPrintf (
+				"CAS: %s TCP_NODELAY option set failed %s\n",
+				__FILE__, sockErrBuf );
+			throw S_cas_internal;
+		}
 
-	/*
-	 * turn on KEEPALIVE so if the client crashes
-	 * this task will find out and exit
-	 */
-	status = setsockopt ( sock, SOL_SOCKET, SO_KEEPALIVE,
-					(char *) & yes, sizeof ( yes ) );
-	if (status<0) {
-        char sockErrBuf[64];
-        epicsSocketConvertErrnoToString ( sockErrBuf, sizeof ( sockErrBuf ) );
-		errlogPrintf (
-			"CAS: %s SO_KEEPALIVE option set failed %s\n",
-			__FILE__, sockErrBuf );
-		throw S_cas_internal;
+		/*
+		 * turn on KEEPALIVE so if the client crashes
+		 * this task will find out and exit
+		 */
+		status = setsockopt ( sock, SOL_SOCKET, SO_KEEPALIVE,
+						(char *) & yes, sizeof ( yes ) );
+		if (status<0) {
+	        char sockErrBuf[64];
+	        epicsSocketConvertErrnoToString ( sockErrBuf, sizeof ( sockErrBuf ) );
+			errlogPrintf (
+				"CAS: %s SO_KEEPALIVE option set failed %s\n",
+				__FILE__, sockErrBuf );
+			throw S_cas_internal;
+		}
 	}
 
 	/*
@@ -113,6 +132,9 @@ casStreamIO::casStreamIO ( caServerI & cas, clientBufMemoryManager & bufMgr,
 // casStreamIO::~casStreamIO()
 casStreamIO::~casStreamIO()
 {
+#ifdef CAS_LOCAL_RING_SUPPORTED
+	delete this->pRing;
+#endif
 	epicsSocketDestroy ( this->sock );
 }
 
@@ -126,6 +148,12 @@ outBufClient::flushCondition casStreamIO::osdSend ( const char *pInBuf, bufSizeT
         nBytesActual = 0;
         return outBufClient::flushNone;
     }
+
+#ifdef CAS_LOCAL_RING_SUPPORTED
+    if ( this->pRing ) {
+        return this->pRing->send ( pInBuf, nBytesReq, nBytesActual );
+    }
+#endif
     
     status = send (this->sock, (char *) pInBuf, nBytesReq, 0);
     if (status == 0) {
@@ -173,7 +201,12 @@ casStreamIO::osdRecv ( char * pInBuf, bufSizeT nBytes,
 {
     int nchars;
     
-    nchars = recv (this->sock, pInBuf, nBytes, 0);
+    if ( this->ringMayAttach ) {
+        nchars = this->recvFirst ( pInBuf, nBytes );
+    }
+    else {
+        nchars = recv (this->sock, pInBuf, nBytes, 0);
+    }
     if ( nchars == 0 ) {
         return casFillDisconnect;
     }
@@ -213,6 +246,80 @@ casStreamIO::osdRecv ( char * pInBuf, bufSizeT nBytes,
     }
 }
 
+// casStreamIO::recvFirst()
+//
+// a local client may pass the file descriptors of a shared 
+// memory ring with the first bytes that it sends, and nothing 
+// has been sent to it yet (see casLocalSocket.h)
+//
+int casStreamIO::recvFirst ( char * pInBuf, bufSizeT nBytes )
+{
+#ifdef CAS_LOCAL_RING_SUPPORTED
+    static const unsigned nRingFD = 3u;
+    struct iovec iov;
+    iov.iov_base = pInBuf;
+    iov.iov_len = nBytes;
+    union {
+        struct cmsghdr align;
+        char buf [ CMSG_SPACE ( nRingFD * sizeof ( int ) ) ];
+    } control;
+    struct msghdr msg;
+    memset ( & msg, '\0', sizeof ( msg ) );
+    msg.msg_iov = & iov;
+    msg.msg_iovlen = 1;
+    msg.msg_control = control.buf;
+    msg.msg_controllen = sizeof ( control.buf );
+    int nchars = recvmsg ( this->sock, & msg, MSG_CMSG_CLOEXEC );
+    if ( nchars <= 0 ) {
+        return nchars;
+    }
+    this->ringMayAttach = false;
+
+    int fds [ nRingFD ];
+    unsigned nFD = 0u;
+    for ( struct cmsghdr * pCmsg = CMSG_FIRSTHDR ( & msg ); pCmsg; 
+            pCmsg = CMSG_NXTHDR ( & msg, pCmsg ) ) {
+        if ( pCmsg->cmsg_level != SOL_SOCKET || 
+                pCmsg->cmsg_type != SCM_RIGHTS ) {
+            continue;
+        }
+        unsigned n = static_cast < unsigned > ( 
+            ( pCmsg->cmsg_len - CMSG_LEN ( 0 ) ) / sizeof ( int ) );
+        for ( unsigned i = 0u; i < n; i++ ) {
+            int fd;
+            memcpy ( & fd, CMSG_DATA ( pCmsg ) + i * sizeof ( int ), 
+                sizeof ( fd ) );
+            if ( nFD < nRingFD ) {
+                fds[nFD++] = fd;
+            }
+            else {
+                close ( fd );
+            }
+        }
+    }
+    if ( nFD == nRingFD && ! ( msg.msg_flags & MSG_CTRUNC ) ) {
+        try {
+            this->pRing = new casLocalRing ( fds[0], fds[1], fds[2] );
+        }
+        catch ( ... ) {
+            // the client continues with the socket
+        }
+    }
+    else if ( nFD > 0u || ( msg.msg_flags & MSG_CTRUNC ) ) {
+        for ( unsigned i = 0u; i < nFD; i++ ) {
+            close ( fds[i] );
+        }
+        errlogPrintf ( 
+            "CAS: local client passed other than %u file descriptors\n",
+            nRingFD );
+    }
+    return nchars;
+#else
+    this->ringMayAttach = false;
+    return recv ( this->sock, pInBuf, nBytes, 0 );
+#endif
+}
+
 // casStreamIO::forceDisconnect()
 void casStreamIO::forceDisconnect ()
 {
@@ -235,8 +342,14 @@ void casStreamIO::forceDisconnect ()
 // casStreamIO::show()
 void casStreamIO::osdShow (unsigned level) const
 {
-	printf ( "casStreamIO at %p\n", 
-        static_cast <const void *> ( this ) );
+	printf ( "casStreamIO at %p%s\n", 
+        static_cast <const void *> ( this ),
+        this->local ? " (local socket)" : "" );
+#ifdef CAS_LOCAL_RING_SUPPORTED
+	if ( this->pRing ) {
+		this->pRing->show ( level );
+	}
+#endif
 	if (level>1u) {
 		char buf[64];
 		this->hostName ( buf, sizeof ( buf ) );
@@ -304,6 +417,11 @@ bufSizeT casStreamIO :: inCircuitBytesPending () const
 // casStreamIO :: osSendBufferSize ()
 bufSizeT casStreamIO :: osSendBufferSize () const 
 {
+#ifdef CAS_LOCAL_RING_SUPPORTED
+    if ( this->pRing ) {
+        return this->pRing->size ();
+    }
+#endif
     return _osSendBufferSize;
 }
 
@@ -312,3 +430,24 @@ int casStreamIO::getFD() const
 {
 	return this->sock;
 }
+
+// casStreamIO::getSendFD()
+int casStreamIO::getSendFD () const
+{
+#ifdef CAS_LOCAL_RING_SUPPORTED
+	if ( this->pRing ) {
+		return this->pRing->getSpaceFD ();
+	}
+#endif
+	return this->sock;
+}
+
+// casStreamIO::sendFDIsReadable()
+bool casStreamIO::sendFDIsReadable () const
+{
+#ifdef CAS_LOCAL_RING_SUPPORTED
+	return this->pRing != 0;
+#else
+	return false;
+#endif
+}
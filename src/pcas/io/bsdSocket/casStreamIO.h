@@ -11,18 +11,30 @@
 #define casStreamIOh
 
 #include "casStrmClient.h"
+#include "casLocalSocket.h"
 
 struct ioArgsToNewStreamIO {
     caNetAddr clientAddr;
     SOCKET sock;
+    bool local; // a Unix domain socket
 };
 
+#ifdef CAS_LOCAL_RING_SUPPORTED
+class casLocalRing;
+#endif
+
 class casStreamIO : public casStrmClient {
 public:
     casStreamIO ( caServerI &, clientBufMemoryManager &, 
         const ioArgsToNewStreamIO & );
     ~casStreamIO ();
     int getFD () const;
+    //
+    // the file descriptor which becomes ready when a blocked send
+    // can make progress, and if it becomes readable or writable
+    //
+    int getSendFD () const;
+    bool sendFDIsReadable () const;
     void xSetNonBlocking ();
 	bufSizeT inCircuitBytesPending () const;
 	bufSizeT osSendBufferSize () const;
@@ -30,6 +42,11 @@ private:
     SOCKET sock;
 	bufSizeT _osSendBufferSize;
     xBlockingStatus blockingFlag;
+    const bool local;
+#ifdef CAS_LOCAL_RING_SUPPORTED
+    casLocalRing * pRing; // nil unless the client attached one
+#endif
+    bool ringMayAttach;
 
     bool sockHasBeenShutdown;
     xBlockingStatus blockingState() const;
@@ -38,6 +55,7 @@ private:
         bufSizeT & nBytesActual );
     inBufClient::fillCondition osdRecv ( char *pBuf, bufSizeT nBytesReq, 
         bufSizeT & nBytesActual );
+    int recvFirst ( char * pBuf, bufSizeT nBytesReq );
     void forceDisconnect ();
     casStreamIO ( const casStreamIO & );
     casStreamIO & operator = ( const casStreamIO & );
@@ -0,0 +1,289 @@
+/*************************************************************************\
+* Copyright (c) 2002 The University of Chicago, as Operator of Argonne
+*     National Laboratory.
+* Copyright (c) 2002 The Regents of the University of California, as
+*     Operator of Los Alamos National Laboratory.
+* EPICS BASE is distributed subject to a Software License Agreement found
+* in file LICENSE that is included with this distribution.
+\*************************************************************************/
+
+//
+// casLocalRingTest.cc
+//
+// regression tests of the server's side of the shared memory ring
+// of a local client (see casLocalSocket.h)
+//
+// The test is the client. It passes the memfd and the eventfds over
+// a socketpair, as it would with its first bytes on the local
+// socket, and consumes what the server writes into the ring.
+//
+
+#include <string.h>
+
+#include "epicsUnitTest.h"
+
+#include "casdef.h"
+#include "casLocalRing.h"
+
+#ifdef CAS_LOCAL_RING_SUPPORTED
+
+#include <stdint.h>
+#include <unistd.h>
+#include <fcntl.h>
+#include <poll.h>
+#include <sys/mman.h>
+#include <sys/socket.h>
+#include <sys/eventfd.h>
+
+static const epicsUInt32 testRingSize = 64u;
+// the counts roll over during the first message
+static const epicsUInt32 testRingStart = 0u - 24u;
+
+//
+// the client's side of a ring
+//
+struct testRingClient {
+    casLocalRingHeader * pHeader;
+    char * pData;
+    int dataEventFD;
+    int spaceEventFD;
+};
+
+//
+// returns the file descriptors received, or false if
+// they werent passed
+//
+static bool testPassFDs ( const int * pFDs, int * pReceived )
+{
+    static const unsigned nFD = 3u;
+    int sv[2];
+    if ( socketpair ( AF_UNIX, SOCK_STREAM, 0, sv ) < 0 ) {
+        return false;
+    }
+
+    char byte = 0;
+    struct iovec iov;
+    iov.iov_base = & byte;
+    iov.iov_len = 1u;
+    union {
+        struct cmsghdr align;
+        char buf [ CMSG_SPACE ( nFD * sizeof ( int ) ) ];
+    } control;
+    struct msghdr msg;
+    memset ( & msg, '\0', sizeof ( msg ) );
+    msg.msg_iov = & iov;
+    msg.msg_iovlen = 1;
+    msg.msg_control = control.buf;
+    msg.msg_controllen = sizeof ( control.buf );
+    struct cmsghdr * pCmsg = CMSG_FIRSTHDR ( & msg );
+    pCmsg->cmsg_level = SOL_SOCKET;
+    pCmsg->cmsg_type = SCM_RIGHTS;
+    pCmsg->cmsg_len = CMSG_LEN ( nFD * sizeof ( int ) );
+    memcpy ( CMSG_DATA ( pCmsg ), pFDs, nFD * sizeof ( int ) );
+
+    bool ok = sendmsg ( sv[0], & msg, 0 ) == 1;
+    if ( ok ) {
+        memset ( control.buf, '\0', sizeof ( control.buf ) );
+        msg.msg_controllen = sizeof ( control.buf );
+        ok = recvmsg ( sv[1], & msg, MSG_CMSG_CLOEXEC ) == 1 &&
+            ( pCmsg = CMSG_FIRSTHDR ( & msg ) ) != 0 &&
+            pCmsg->cmsg_type == SCM_RIGHTS &&
+            pCmsg->cmsg_len == CMSG_LEN ( nFD * sizeof ( int ) );
+        if ( ok ) {
+            memcpy ( pReceived, CMSG_DATA ( pCmsg ), nFD * sizeof ( int ) );
+        }
+    }
+    close ( sv[0] );
+    close ( sv[1] );
+    return ok;
+}
+
+//
+// Returns the server's side of a ring initialized by the client,
+// or nil if it was refused. The client's mapping, and eventfds,
+// remain open.
+//
+static casLocalRing * testCreateRing ( testRingClient & client, bool seal )
+{
+    client.pHeader = 0;
+    client.pData = 0;
+    client.dataEventFD = -1;
+    client.spaceEventFD = -1;
+
+    size_t mapSize = CAS_LOCAL_RING_DATA_OFFSET + testRingSize;
+    int fds[3];
+    fds[0] = memfd_create ( "casLocalRingTest", MFD_ALLOW_SEALING );
+    if ( fds[0] < 0 || ftruncate ( fds[0], mapSize ) < 0 ) {
+        return 0;
+    }
+    void * p = mmap ( 0, mapSize, PROT_READ | PROT_WRITE, MAP_SHARED,
+        fds[0], 0 );
+    if ( p == MAP_FAILED ) {
+        close ( fds[0] );
+        return 0;
+    }
+    client.pHeader = static_cast < casLocalRingHeader * > ( p );
+    client.pData = static_cast < char * > ( p ) + CAS_LOCAL_RING_DATA_OFFSET;
+    memset ( client.pHeader, '\0', sizeof ( *client.pHeader ) );
+    client.pHeader->magic = CAS_LOCAL_RING_MAGIC;
+    client.pHeader->version = CAS_LOCAL_RING_VERSION;
+    client.pHeader->size = testRingSize;
+    client.pHeader->head = testRingStart;
+    client.pHeader->tail = testRingStart;
+    if ( seal ) {
+        fcntl ( fds[0], F_ADD_SEALS, F_SEAL_SHRINK );
+    }
+    fds[1] = client.dataEventFD = eventfd ( 0, EFD_NONBLOCK );
+    fds[2] = client.spaceEventFD = eventfd ( 0, EFD_NONBLOCK );
+
+    int received[3];
+    bool ok = testPassFDs ( fds, received );
+    close ( fds[0] );
+    if ( ! ok ) {
+        return 0;
+    }
+    try {
+        return new casLocalRing ( received[0], received[1], received[2] );
+    }
+    catch ( ... ) {
+        return 0;
+    }
+}
+
+static void testDestroyClient ( testRingClient & client )
+{
+    if ( client.pHeader ) {
+        munmap ( client.pHeader, CAS_LOCAL_RING_DATA_OFFSET + testRingSize );
+    }
+    if ( client.dataEventFD >= 0 ) {
+        close ( client.dataEventFD );
+    }
+    if ( client.spaceEventFD >= 0 ) {
+        close ( client.spaceEventFD );
+    }
+}
+
+static bool testReadable ( int fd )
+{
+    struct pollfd pfd;
+    pfd.fd = fd;
+    pfd.events = POLLIN;
+    pfd.revents = 0;
+    return poll ( & pfd, 1, 0 ) == 1 && ( pfd.revents & POLLIN );
+}
+
+//
+// the client reads what the server wrote, as far as its head,
+// and advances the tail
+//
+static epicsUInt32 testConsume ( testRingClient & client, char * pBuf )
+{
+    epicsUInt32 head = client.pHeader->head;
+    epicsUInt32 n = 0u;
+    for ( epicsUInt32 tail = client.pHeader->tail; tail != head; tail++ ) {
+        pBuf[n++] = client.pData[tail & ( testRingSize - 1u )];
+    }
+    client.pHeader->tail = head;
+    return n;
+}
+
+static void testRing ()
+{
+    testRingClient client;
+    casLocalRing * pRing = testCreateRing ( client, true );
+    testOk ( pRing && client.pHeader->attached == 1u,
+        "a sealed memfd was attached" );
+    if ( ! pRing ) {
+        testSkip ( 8, "no ring" );
+        testDestroyClient ( client );
+        return;
+    }
+
+    char msg[2u * testRingSize];
+    char received[2u * testRingSize];
+    for ( unsigned i = 0u; i < sizeof ( msg ); i++ ) {
+        msg[i] = static_cast < char > ( i + 1u );
+    }
+
+    // the first message wraps past the end of the ring, and
+    // its head and tail roll over
+    bufSizeT nBytes = 0u;
+    outBufClient::flushCondition cond = pRing->send ( msg, 40u, nBytes );
+    bool ok = cond == outBufClient::flushProgress && nBytes == 40u &&
+        client.pHeader->head == testRingStart + 40u;
+    testOk ( ok && testConsume ( client, received ) == 40u &&
+        memcmp ( received, msg, 40u ) == 0,
+        "the message which wrapped around was received intact" );
+    cond = pRing->send ( msg + 40u, 40u, nBytes );
+    ok = cond == outBufClient::flushProgress && nBytes == 40u &&
+        client.pHeader->head == testRingStart + 80u;
+    testOk ( ok && testConsume ( client, received ) == 40u &&
+        memcmp ( received, msg + 40u, 40u ) == 0,
+        "the next message was received intact, and the head is %u",
+        client.pHeader->head );
+
+    // the client isnt reading, and the ring fills
+    cond = pRing->send ( msg, sizeof ( msg ), nBytes );
+    testOk ( cond == outBufClient::flushProgress && nBytes == testRingSize,
+        "%u bytes of %u were sent to the empty ring", nBytes,
+        static_cast < unsigned > ( sizeof ( msg ) ) );
+    cond = pRing->send ( msg, sizeof ( msg ), nBytes );
+    testOk ( cond == outBufClient::flushNone &&
+        client.pHeader->serverWaiting == 1u,
+        "nothing was sent to the full ring, and the server waits" );
+
+    // the client frees some space and wakes up the server
+    client.pHeader->tail += 32u;
+    client.pHeader->serverWaiting = 0u;
+    uint64_t one = 1u;
+    ok = write ( client.spaceEventFD, & one, sizeof ( one ) ) ==
+        static_cast < ssize_t > ( sizeof ( one ) );
+    testOk ( ok && testReadable ( pRing->getSpaceFD () ),
+        "the space eventfd woke up the server" );
+    client.pHeader->clientWaiting = 1u;
+    cond = pRing->send ( msg, sizeof ( msg ), nBytes );
+    testOk ( cond == outBufClient::flushProgress && nBytes == 32u &&
+        ! testReadable ( pRing->getSpaceFD () ),
+        "the server sent %u bytes and drained the space eventfd", nBytes );
+    testOk ( testReadable ( client.dataEventFD ) &&
+        client.pHeader->clientWaiting == 0u,
+        "the data eventfd woke up the waiting client" );
+
+    // the client advances its tail past the head
+    client.pHeader->tail = client.pHeader->head + 1u;
+    cond = pRing->send ( msg, 1u, nBytes );
+    testOk ( cond == outBufClient::flushDisconnect,
+        "a client which corrupted its tail was disconnected" );
+
+    delete pRing;
+    testDestroyClient ( client );
+}
+
+static void testUnsealed ()
+{
+    testRingClient client;
+    casLocalRing * pRing = testCreateRing ( client, false );
+    testOk ( ! pRing && client.pHeader && client.pHeader->attached == 0u,
+        "a memfd which isnt sealed was refused" );
+    delete pRing;
+    testDestroyClient ( client );
+}
+
+MAIN ( casLocalRingTest )
+{
+    testPlan ( 10 );
+    testRing ();
+    testUnsealed ();
+    return testDone ();
+}
+
+#else // CAS_LOCAL_RING_SUPPORTED
+
+MAIN ( casLocalRingTest )
+{
+    testPlan ( 1 );
+    testSkip ( 1, "there is no shared memory ring on this target" );
+    return testDone ();
+}
+
+#endif // CAS_LOCAL_RING_SUPPORTED
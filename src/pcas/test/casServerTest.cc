@@ -0,0 +1,1281 @@
+/*************************************************************************\
+* Copyright (c) 2002 The University of Chicago, as Operator of Argonne
+*     National Laboratory.
+* Copyright (c) 2002 The Regents of the University of California, as
+*     Operator of Los Alamos National Laboratory.
+* EPICS BASE is distributed subject to a Software License Agreement found
+* in file LICENSE that is included with this distribution.
+\*************************************************************************/
+
+//
+// casServerTest.cc
+//
+// regression tests of the server library through CA clients in
+// the same process
+//
+// The server runs in its own thread, on the loopback interface at
+// a port which isnt the default. The clients speak the wire
+// protocol directly, rather than through the CA client library,
+// so that the order in which their requests reach the server is
+// known.
+//
+
+#include <string.h>
+
+// *must* be defined before including net_convert.h
+typedef unsigned long arrayElementCount;
+
+#include "epicsUnitTest.h"
+#include "epicsThread.h"
+#include "epicsEvent.h"
+#include "envDefs.h"
+#include "fdManager.h"
+#include "tsDLList.h"
+#include "errlog.h"
+#include "osiSock.h"
+#include "caerr.h"
+#include "db_access.h"
+#include "net_convert.h"    // byte order conversion from libca
+
+#include "casdef.h"
+#include "casDirect.h"
+#include "gddApps.h"
+#include "gddAppTable.h"
+#include "smartGDDPointer.h"
+#include "caHdrLargeArray.h"
+
+static const char * const testPort = "15071";
+static const unsigned short testPortNumber = 15071u;
+static const unsigned testArrayCount = 64u;
+static const unsigned testClientBufSize = 0x4000;
+static const double testTimeout = 5.0;
+
+class testServer;
+
+//
+// keeps the first value written to it, without copying it,
+// and returns it when read
+//
+class testArrayPV : public casPV {
+public:
+    testArrayPV ();
+    const char * getName () const;
+    aitEnum bestExternalType () const;
+    unsigned maxDimension () const;
+    aitIndex maxBound ( unsigned dimension ) const;
+    caStatus read ( const casCtx &, gdd & prototype );
+    caStatus write ( const casCtx &, const gdd & value );
+    void destroy ();
+private:
+    smartConstGDDPointer pFirst;
+    testArrayPV ( const testArrayPV & );
+    testArrayPV & operator = ( const testArrayPV & );
+};
+
+//
+// caches its posted events, and posts only the value when it is
+// written
+//
+class testCachedPV : public casPV {
+public:
+    testCachedPV ( testServer & );
+    const char * getName () const;
+    aitEnum bestExternalType () const;
+    bool cachePostedEvents () const;
+    caStatus read ( const casCtx &, gdd & prototype );
+    caStatus write ( const casCtx &, const gdd & value );
+    void destroy ();
+    void postValue ( aitFloat64 value );
+    unsigned readCount () const;
+private:
+    testServer & cas;
+    aitFloat64 value;
+    volatile unsigned nRead;
+    testCachedPV ( const testCachedPV & );
+    testCachedPV & operator = ( const testCachedPV & );
+};
+
+//
+// posts its limits, precision, and units in a property event, and
+// its value alone in value events, and returns only the value when
+// read
+//
+class testPropertyPV : public casPV {
+public:
+    testPropertyPV ( testServer & );
+    const char * getName () const;
+    aitEnum bestExternalType () const;
+    caStatus read ( const casCtx &, gdd & prototype );
+    void destroy ();
+    void postProperties ();
+    void postValue ( aitFloat64 value );
+private:
+    testServer & cas;
+    volatile aitFloat64 value;
+    testPropertyPV ( const testPropertyPV & );
+    testPropertyPV & operator = ( const testPropertyPV & );
+};
+
+class testAsyncPV;
+
+//
+// a read of the asynchronous PV which hasnt been completed
+//
+class testAsyncReadIO : public casAsyncReadIO,
+    public tsDLNode < testAsyncReadIO > {
+public:
+    testAsyncReadIO ( const casCtx &, testAsyncPV &, gdd & prototype );
+    ~testAsyncReadIO ();
+private:
+    smartGDDPointer pProto;
+    testAsyncPV * pPV; // nil after it is completed
+    testAsyncReadIO ( const testAsyncReadIO & );
+    testAsyncReadIO & operator = ( const testAsyncReadIO & );
+    friend class testAsyncPV;
+};
+
+//
+// Reads complete when the test completes them, and are shared by
+// the clients (see casPV::coalesceReads()). It is only used by the
+// server's thread.
+//
+class testAsyncPV : public casPV {
+public:
+    testAsyncPV ();
+    const char * getName () const;
+    aitEnum bestExternalType () const;
+    bool coalesceReads () const;
+    caStatus read ( const casCtx &, gdd & prototype );
+    void destroy ();
+    // returns the number of reads, and clears it
+    unsigned takeReadCount ();
+    unsigned pendingCount () const;
+    void complete ( aitFloat64 value );
+private:
+    tsDLList < testAsyncReadIO > pending;
+    unsigned nRead;
+    testAsyncPV ( const testAsyncPV & );
+    testAsyncPV & operator = ( const testAsyncPV & );
+    friend class testAsyncReadIO;
+};
+
+class testServer : public caServer {
+public:
+    testServer ();
+    pvExistReturn pvExistTest ( const casCtx &,
+        const caNetAddr &, const char * pPVName );
+    pvAttachReturn pvAttach ( const casCtx &, const char * pPVName );
+    testCachedPV cachedPV;
+    testAsyncPV asyncPV;
+    testPropertyPV propertyPV;
+private:
+    testArrayPV arrayPV;
+    casPV * find ( const char * pPVName );
+    testServer ( const testServer & );
+    testServer & operator = ( const testServer & );
+};
+
+testArrayPV::testArrayPV ()
+{
+}
+
+const char * testArrayPV::getName () const
+{
+    return "casTest:array";
+}
+
+aitEnum testArrayPV::bestExternalType () const
+{
+    return aitEnumFloat64;
+}
+
+unsigned testArrayPV::maxDimension () const
+{
+    return 1u;
+}
+
+aitIndex testArrayPV::maxBound ( unsigned dimension ) const
+{
+    return dimension == 0u ? testArrayCount : 1u;
+}
+
+caStatus testArrayPV::read ( const casCtx &, gdd & prototype )
+{
+    if ( ! this->pFirst.valid () ) {
+        return S_casApp_noSupport;
+    }
+    gddStatus status = gddApplicationTypeTable::AppTable ().smartCopy (
+        & prototype, this->pFirst.get () );
+    return status ? S_cas_noConvert : S_casApp_success;
+}
+
+//
+// the gdd written is referenced, as a server tool which keeps
+// the value might do, and not copied
+//
+caStatus testArrayPV::write ( const casCtx &, const gdd & value )
+{
+    if ( ! this->pFirst.valid () ) {
+        this->pFirst = & value;
+    }
+    return S_casApp_success;
+}
+
+//
+// the PVs are deleted by the server
+//
+void testArrayPV::destroy ()
+{
+}
+
+testCachedPV::testCachedPV ( testServer & casIn ) :
+    cas ( casIn ), value ( 0.0 ), nRead ( 0u )
+{
+}
+
+const char * testCachedPV::getName () const
+{
+    return "casTest:cached";
+}
+
+aitEnum testCachedPV::bestExternalType () const
+{
+    return aitEnumFloat64;
+}
+
+bool testCachedPV::cachePostedEvents () const
+{
+    return true;
+}
+
+//
+// the limits and precision are only available from read()
+//
+caStatus testCachedPV::read ( const casCtx &, gdd & prototype )
+{
+    this->nRead++;
+    gddApplicationTypeTable & table = gddApplicationTypeTable::AppTable ();
+    gdd * pDD = table.getDD ( gddAppType_dbr_ctrl_double );
+    ( *pDD ) [ gddAppTypeIndex_dbr_ctrl_double_value ] = this->value;
+    ( *pDD ) [ gddAppTypeIndex_dbr_ctrl_double_precision ] = 3;
+    ( *pDD ) [ gddAppTypeIndex_dbr_ctrl_double_graphicLow ] = -10.0;
+    ( *pDD ) [ gddAppTypeIndex_dbr_ctrl_double_graphicHigh ] = 10.0;
+    gddStatus status = table.smartCopy ( & prototype, pDD );
+    pDD->unreference ();
+    return status ? S_cas_noConvert : S_casApp_success;
+}
+
+caStatus testCachedPV::write ( const casCtx &, const gdd & valueIn )
+{
+    aitFloat64 newValue;
+    valueIn.getConvert ( newValue );
+    this->postValue ( newValue );
+    return S_casApp_success;
+}
+
+void testCachedPV::postValue ( aitFloat64 valueIn )
+{
+    this->value = valueIn;
+    gdd * pDD = new gddScalar ( gddAppType_value, aitEnumFloat64 );
+    * pDD = valueIn;
+    casEventMask select ( this->cas.valueEventMask () |
+        this->cas.logEventMask () );
+    this->postEvent ( select, *pDD );
+    pDD->unreference ();
+}
+
+//
+// the PVs are deleted by the server
+//
+void testCachedPV::destroy ()
+{
+}
+
+unsigned testCachedPV::readCount () const
+{
+    return this->nRead;
+}
+
+testAsyncReadIO::testAsyncReadIO ( const casCtx & ctx, testAsyncPV & pv,
+        gdd & prototype ) :
+    casAsyncReadIO ( ctx ), pProto ( & prototype ), pPV ( & pv )
+{
+    pv.pending.add ( *this );
+}
+
+//
+// deleted by the server when its response has been sent,
+// or when it is canceled
+//
+testAsyncReadIO::~testAsyncReadIO ()
+{
+    if ( this->pPV ) {
+        this->pPV->pending.remove ( *this );
+    }
+}
+
+testAsyncPV::testAsyncPV () :
+    nRead ( 0u )
+{
+}
+
+const char * testAsyncPV::getName () const
+{
+    return "casTest:async";
+}
+
+aitEnum testAsyncPV::bestExternalType () const
+{
+    return aitEnumFloat64;
+}
+
+bool testAsyncPV::coalesceReads () const
+{
+    return true;
+}
+
+caStatus testAsyncPV::read ( const casCtx & ctx, gdd & prototype )
+{
+    this->nRead++;
+    new testAsyncReadIO ( ctx, *this, prototype );
+    return S_casApp_asyncCompletion;
+}
+
+//
+// the PVs are deleted by the server
+//
+void testAsyncPV::destroy ()
+{
+}
+
+unsigned testAsyncPV::takeReadCount ()
+{
+    unsigned n = this->nRead;
+    this->nRead = 0u;
+    return n;
+}
+
+unsigned testAsyncPV::pendingCount () const
+{
+    return this->pending.count ();
+}
+
+//
+// each read completes with its own prototype
+//
+void testAsyncPV::complete ( aitFloat64 valueIn )
+{
+    gddApplicationTypeTable & table = gddApplicationTypeTable::AppTable ();
+    gdd * pDD = new gddScalar ( gddAppType_value, aitEnumFloat64 );
+    * pDD = valueIn;
+    while ( testAsyncReadIO * pIO = this->pending.get () ) {
+        pIO->pPV = 0;
+        gddStatus status = table.smartCopy ( pIO->pProto.get (), pDD );
+        pIO->postIOCompletion ( status ? S_cas_noConvert : S_casApp_success,
+            *pIO->pProto );
+    }
+    pDD->unreference ();
+}
+
+testPropertyPV::testPropertyPV ( testServer & casIn ) :
+    cas ( casIn ), value ( 0.0 )
+{
+}
+
+const char * testPropertyPV::getName () const
+{
+    return "casTest:property";
+}
+
+aitEnum testPropertyPV::bestExternalType () const
+{
+    return aitEnumFloat64;
+}
+
+caStatus testPropertyPV::read ( const casCtx &, gdd & prototype )
+{
+    gdd * pDD = new gddScalar ( gddAppType_value, aitEnumFloat64 );
+    * pDD = this->value;
+    gddStatus status = gddApplicationTypeTable::AppTable ().smartCopy (
+        & prototype, pDD );
+    pDD->unreference ();
+    return status ? S_cas_noConvert : S_casApp_success;
+}
+
+//
+// the PVs are deleted by the server
+//
+void testPropertyPV::destroy ()
+{
+}
+
+void testPropertyPV::postProperties ()
+{
+    gdd * pDD = gddApplicationTypeTable::AppTable ().getDD (
+        gddAppType_dbr_ctrl_double );
+    aitString units = "mV";
+    ( *pDD ) [ gddAppTypeIndex_dbr_ctrl_double_value ] = this->value;
+    ( *pDD ) [ gddAppTypeIndex_dbr_ctrl_double_precision ] = 4;
+    ( *pDD ) [ gddAppTypeIndex_dbr_ctrl_double_graphicLow ] = -5.0;
+    ( *pDD ) [ gddAppTypeIndex_dbr_ctrl_double_graphicHigh ] = 5.0;
+    ( *pDD ) [ gddAppTypeIndex_dbr_ctrl_double_units ].put ( units );
+    this->postEvent ( this->cas.propertyEventMask (), *pDD );
+    pDD->unreference ();
+}
+
+void testPropertyPV::postValue ( aitFloat64 valueIn )
+{
+    this->value = valueIn;
+    gdd * pDD = new gddScalar ( gddAppType_value, aitEnumFloat64 );
+    * pDD = valueIn;
+    casEventMask select ( this->cas.valueEventMask () |
+        this->cas.logEventMask () );
+    this->postEvent ( select, *pDD );
+    pDD->unreference ();
+}
+
+testServer::testServer () :
+    cachedPV ( *this ), propertyPV ( *this )
+{
+}
+
+casPV * testServer::find ( const char * pPVName )
+{
+    if ( strcmp ( pPVName, this->arrayPV.getName () ) == 0 ) {
+        return & this->arrayPV;
+    }
+    if ( strcmp ( pPVName, this->cachedPV.getName () ) == 0 ) {
+        return & this->cachedPV;
+    }
+    if ( strcmp ( pPVName, this->asyncPV.getName () ) == 0 ) {
+        return & this->asyncPV;
+    }
+    if ( strcmp ( pPVName, this->propertyPV.getName () ) == 0 ) {
+        return & this->propertyPV;
+    }
+    return 0;
+}
+
+pvExistReturn testServer::pvExistTest ( const casCtx &,
+        const caNetAddr &, const char * pPVName )
+{
+    if ( this->find ( pPVName ) ) {
+        return pverExistsHere;
+    }
+    return pverDoesNotExistHere;
+}
+
+pvAttachReturn testServer::pvAttach ( const casCtx &, const char * pPVName )
+{
+    casPV * pPV = this->find ( pPVName );
+    if ( pPV ) {
+        return *pPV;
+    }
+    return S_casApp_pvNotFound;
+}
+
+//
+// run by the server's thread for a test which uses the PVs, or the
+// server, from the thread which calls fileDescriptorManager.process()
+//
+typedef void testJob ( testServer &, void * pArg );
+
+struct testServerArgs {
+    epicsEvent ready;
+    epicsEvent done;
+    epicsEvent jobDone;
+    testServer * pCAS;
+    testJob * volatile pJob;
+    void * pJobArg;
+    volatile bool exit;
+    bool ok;
+};
+
+//
+// the server's file descriptor manager is only used by this thread
+//
+extern "C" void testServerThread ( void * pArg )
+{
+    testServerArgs & args = * static_cast < testServerArgs * > ( pArg );
+    testServer * pCAS = 0;
+    try {
+        pCAS = new testServer;
+    }
+    catch ( ... ) {
+        errlogPrintf ( "casServerTest: unable to create the server\n" );
+    }
+    args.pCAS = pCAS;
+    args.ok = pCAS != 0;
+    args.ready.signal ();
+    if ( pCAS ) {
+        while ( ! args.exit ) {
+            fileDescriptorManager.process ( 0.01 );
+            if ( args.pJob ) {
+                ( *args.pJob ) ( *pCAS, args.pJobArg );
+                args.pJob = 0;
+                args.jobDone.signal ();
+            }
+        }
+        delete pCAS;
+    }
+    args.done.signal ();
+}
+
+static void testRunJob ( testServerArgs & args, testJob * pJob, void * pArg )
+{
+    args.pJobArg = pArg;
+    args.pJob = pJob;
+    args.jobDone.wait ();
+}
+
+//
+// A CA client of the server in its own thread. A request is
+// answered by waiting for the response with its id, and the
+// messages received before it are discarded.
+//
+class testClient {
+public:
+    testClient ();
+    ~testClient ();
+    bool connect ();
+    bool createChannel ( const char * pName, ca_uint32_t & sid );
+    bool clearChannel ( ca_uint32_t sid );
+    bool write ( ca_uint32_t sid, unsigned dbrType, unsigned count,
+        const void * pValue );
+    bool readNotify ( ca_uint32_t sid, unsigned dbrType, unsigned count,
+        ca_uint32_t & ioid );
+    bool subscribe ( ca_uint32_t sid, unsigned dbrType, unsigned count,
+        unsigned short mask, ca_uint32_t & subid );
+    //
+    // returns when the requests sent before it have been
+    // processed by the server
+    //
+    bool echo ();
+    //
+    // Waits for the response with the command and id specified,
+    // and returns its status, and its value converted to the
+    // host's byte order if it fits in the size specified.
+    //
+    bool response ( unsigned cmmd, ca_uint32_t id, int & status,
+        void * pValue, unsigned size );
+private:
+    SOCKET sock;
+    char * pBuf;
+    unsigned bufBegin;
+    unsigned bufEnd;
+    ca_uint32_t nextId;
+    bool send ( unsigned cmmd, unsigned dataType, unsigned count,
+        ca_uint32_t cid, ca_uint32_t available,
+        const void * pPayload, unsigned payloadSize );
+    bool nextMessage ( caHdr & hdr, unsigned & hdrSize,
+        unsigned & payloadSize );
+    bool fill ();
+    testClient ( const testClient & );
+    testClient & operator = ( const testClient & );
+};
+
+testClient::testClient () :
+    sock ( INVALID_SOCKET ), pBuf ( new char [ testClientBufSize ] ),
+    bufBegin ( 0u ), bufEnd ( 0u ), nextId ( 1u )
+{
+}
+
+testClient::~testClient ()
+{
+    if ( this->sock != INVALID_SOCKET ) {
+        epicsSocketDestroy ( this->sock );
+    }
+    delete [] this->pBuf;
+}
+
+bool testClient::connect ()
+{
+    this->sock = epicsSocketCreate ( AF_INET, SOCK_STREAM, IPPROTO_TCP );
+    if ( this->sock == INVALID_SOCKET ) {
+        return false;
+    }
+    osiSockAddr server;
+    memset ( & server, '\0', sizeof ( server ) );
+    server.ia.sin_family = AF_INET;
+    server.ia.sin_addr.s_addr = htonl ( INADDR_LOOPBACK );
+    server.ia.sin_port = htons ( testPortNumber );
+    if ( ::connect ( this->sock, & server.sa, sizeof ( server.ia ) ) < 0 ) {
+        return false;
+    }
+
+    // the priority is in the data type field, and the
+    // minor version in the count field
+    static const char userName[] = "casServerTest";
+    static const char hostName[] = "localhost";
+    return this->send ( CA_PROTO_VERSION, CA_PROTO_PRIORITY_MIN,
+            CA_MINOR_PROTOCOL_REVISION, 0u, 0u, 0, 0u ) &&
+        this->send ( CA_PROTO_CLIENT_NAME, 0u, 0u, 0u, 0u,
+            userName, sizeof ( userName ) ) &&
+        this->send ( CA_PROTO_HOST_NAME, 0u, 0u, 0u, 0u,
+            hostName, sizeof ( hostName ) );
+}
+
+//
+// the payloads are small enough for the header which isnt extended
+//
+bool testClient::send ( unsigned cmmd, unsigned dataType,
+        unsigned count, ca_uint32_t cid, ca_uint32_t available,
+        const void * pPayload, unsigned payloadSize )
+{
+    unsigned postSize = CA_MESSAGE_ALIGN ( payloadSize );
+    if ( postSize >= 0xffff || count >= 0xffff ) {
+        return false;
+    }
+    caHdr hdr;
+    hdr.m_cmmd = htons ( static_cast < ca_uint16_t > ( cmmd ) );
+    hdr.m_postsize = htons ( static_cast < ca_uint16_t > ( postSize ) );
+    hdr.m_dataType = htons ( static_cast < ca_uint16_t > ( dataType ) );
+    hdr.m_count = htons ( static_cast < ca_uint16_t > ( count ) );
+    hdr.m_cid = htonl ( cid );
+    hdr.m_available = htonl ( available );
+
+    unsigned size = sizeof ( hdr ) + postSize;
+    char * pMsg = new char [ size ];
+    memcpy ( pMsg, & hdr, sizeof ( hdr ) );
+    memset ( pMsg + sizeof ( hdr ), '\0', postSize );
+    if ( payloadSize ) {
+        memcpy ( pMsg + sizeof ( hdr ), pPayload, payloadSize );
+    }
+    unsigned sent = 0u;
+    while ( sent < size ) {
+        int status = ::send ( this->sock, pMsg + sent, size - sent, 0 );
+        if ( status <= 0 ) {
+            break;
+        }
+        sent += static_cast < unsigned > ( status );
+    }
+    delete [] pMsg;
+    return sent == size;
+}
+
+bool testClient::fill ()
+{
+    if ( this->bufBegin > 0u ) {
+        memmove ( this->pBuf, this->pBuf + this->bufBegin,
+            this->bufEnd - this->bufBegin );
+        this->bufEnd -= this->bufBegin;
+        this->bufBegin = 0u;
+    }
+    if ( this->bufEnd == testClientBufSize ) {
+        return false;
+    }
+    fd_set readable;
+    FD_ZERO ( & readable );
+    FD_SET ( this->sock, & readable );
+    struct timeval tv;
+    tv.tv_sec = static_cast < long > ( testTimeout );
+    tv.tv_usec = 0;
+    int status = select ( static_cast < int > ( this->sock ) + 1,
+        & readable, 0, 0, & tv );
+    if ( status <= 0 ) {
+        return false;
+    }
+    int nBytes = recv ( this->sock, this->pBuf + this->bufEnd,
+        testClientBufSize - this->bufEnd, 0 );
+    if ( nBytes <= 0 ) {
+        return false;
+    }
+    this->bufEnd += static_cast < unsigned > ( nBytes );
+    return true;
+}
+
+//
+// returns false if the buffer doesnt hold a complete message
+//
+bool testClient::nextMessage ( caHdr & hdr, unsigned & hdrSize,
+    unsigned & payloadSize )
+{
+    unsigned nBytes = this->bufEnd - this->bufBegin;
+    if ( nBytes < sizeof ( caHdr ) ) {
+        return false;
+    }
+    const char * pMsg = this->pBuf + this->bufBegin;
+    memcpy ( & hdr, pMsg, sizeof ( hdr ) );
+    hdr.m_cmmd = ntohs ( hdr.m_cmmd );
+    hdr.m_postsize = ntohs ( hdr.m_postsize );
+    hdr.m_dataType = ntohs ( hdr.m_dataType );
+    hdr.m_count = ntohs ( hdr.m_count );
+    hdr.m_cid = ntohl ( hdr.m_cid );
+    hdr.m_available = ntohl ( hdr.m_available );
+
+    hdrSize = sizeof ( caHdr );
+    payloadSize = hdr.m_postsize;
+    if ( hdr.m_postsize == 0xffff && hdr.m_count == 0u ) {
+        ca_uint32_t LWA[2];
+        if ( nBytes < sizeof ( caHdr ) + sizeof ( LWA ) ) {
+            return false;
+        }
+        memcpy ( LWA, pMsg + sizeof ( caHdr ), sizeof ( LWA ) );
+        hdrSize += sizeof ( LWA );
+        payloadSize = ntohl ( LWA[0] );
+    }
+    return nBytes >= hdrSize + payloadSize;
+}
+
+bool testClient::response ( unsigned cmmd, ca_uint32_t id,
+    int & status, void * pValue, unsigned size )
+{
+    while ( true ) {
+        caHdr hdr;
+        unsigned hdrSize, payloadSize;
+        while ( this->nextMessage ( hdr, hdrSize, payloadSize ) ) {
+            const char * pPayload = this->pBuf + this->bufBegin + hdrSize;
+            this->bufBegin += hdrSize + payloadSize;
+            if ( hdr.m_cmmd != cmmd || hdr.m_available != id ) {
+                continue;
+            }
+            // the status of a read or an update is in the cid field
+            status = static_cast < int > ( hdr.m_cid );
+            if ( pValue && status == ECA_NORMAL ) {
+                unsigned count = hdr.m_count;
+                if ( hdrSize > sizeof ( caHdr ) ) {
+                    ca_uint32_t largeCount;
+                    memcpy ( & largeCount, pPayload - sizeof ( largeCount ),
+                        sizeof ( largeCount ) );
+                    count = ntohl ( largeCount );
+                }
+                if ( hdr.m_dataType > LAST_BUFFER_TYPE ||
+                        dbr_size_n ( hdr.m_dataType, count ) > size ||
+                        dbr_size_n ( hdr.m_dataType, count ) > payloadSize ) {
+                    return false;
+                }
+                return caNetConvert ( hdr.m_dataType, pPayload, pValue,
+                    false, count ) == ECA_NORMAL;
+            }
+            return true;
+        }
+        if ( ! this->fill () ) {
+            return false;
+        }
+    }
+}
+
+//
+// the server id is in the available field of the response
+// and the client id in the cid field
+//
+bool testClient::createChannel ( const char * pName, ca_uint32_t & sid )
+{
+    ca_uint32_t cid = this->nextId++;
+    if ( ! this->send ( CA_PROTO_CREATE_CHAN, 0u, 0u, cid,
+            CA_MINOR_PROTOCOL_REVISION, pName, strlen ( pName ) + 1u ) ) {
+        return false;
+    }
+    while ( true ) {
+        caHdr hdr;
+        unsigned hdrSize, payloadSize;
+        while ( this->nextMessage ( hdr, hdrSize, payloadSize ) ) {
+            this->bufBegin += hdrSize + payloadSize;
+            if ( hdr.m_cmmd == CA_PROTO_CREATE_CH_FAIL && hdr.m_cid == cid ) {
+                return false;
+            }
+            if ( hdr.m_cmmd == CA_PROTO_CREATE_CHAN && hdr.m_cid == cid ) {
+                sid = hdr.m_available;
+                return true;
+            }
+        }
+        if ( ! this->fill () ) {
+            return false;
+        }
+    }
+}
+
+bool testClient::clearChannel ( ca_uint32_t sid )
+{
+    int status;
+    return this->send ( CA_PROTO_CLEAR_CHANNEL, 0u, 0u, sid, sid, 0, 0u ) &&
+        this->response ( CA_PROTO_CLEAR_CHANNEL, sid, status, 0, 0u );
+}
+
+bool testClient::write ( ca_uint32_t sid, unsigned dbrType,
+    unsigned count, const void * pValue )
+{
+    unsigned size = dbr_size_n ( dbrType, count );
+    char * pPayload = new char [ size ];
+    bool ok = caNetConvert ( dbrType, pValue, pPayload, true, count ) ==
+            ECA_NORMAL &&
+        this->send ( CA_PROTO_WRITE, dbrType, count, sid, 0u,
+            pPayload, size );
+    delete [] pPayload;
+    return ok;
+}
+
+bool testClient::readNotify ( ca_uint32_t sid, unsigned dbrType,
+    unsigned count, ca_uint32_t & ioid )
+{
+    ioid = this->nextId++;
+    return this->send ( CA_PROTO_READ_NOTIFY, dbrType, count,
+        sid, ioid, 0, 0u );
+}
+
+bool testClient::subscribe ( ca_uint32_t sid, unsigned dbrType,
+    unsigned count, unsigned short mask, ca_uint32_t & subid )
+{
+    subid = this->nextId++;
+    mon_info info;
+    memset ( & info, '\0', sizeof ( info ) );
+    info.m_mask = htons ( mask );
+    return this->send ( CA_PROTO_EVENT_ADD, dbrType, count,
+        sid, subid, & info, sizeof ( info ) );
+}
+
+bool testClient::echo ()
+{
+    int status;
+    return this->send ( CA_PROTO_ECHO, 0u, 0u, 0u, 0u, 0, 0u ) &&
+        this->response ( CA_PROTO_ECHO, 0u, status, 0, 0u );
+}
+
+static bool testConnect ( testClient & client, const char * pName,
+    ca_uint32_t & sid )
+{
+    bool ok = client.connect () && client.createChannel ( pName, sid );
+    testOk ( ok, "connected to %s", pName );
+    return ok;
+}
+
+//
+// A server tool which keeps a reference to the gdd written must
+// find its data unchanged after the next write, which is received
+// into the same client's buffers.
+//
+static void testRetainedWrite ()
+{
+    testClient client;
+    ca_uint32_t sid;
+    if ( ! testConnect ( client, "casTest:array", sid ) ) {
+        testSkip ( 2, "not connected" );
+        return;
+    }
+
+    dbr_double_t first[testArrayCount];
+    dbr_double_t second[testArrayCount];
+    dbr_double_t readBack[testArrayCount];
+    for ( unsigned i = 0u; i < testArrayCount; i++ ) {
+        first[i] = i + 1.0;
+        second[i] = - ( i + 1.0 );
+        readBack[i] = 0.0;
+    }
+    ca_uint32_t ioid;
+    int status = ECA_GETFAIL;
+    bool ok = client.write ( sid, DBR_DOUBLE, testArrayCount, first ) &&
+        client.write ( sid, DBR_DOUBLE, testArrayCount, second ) &&
+        client.readNotify ( sid, DBR_DOUBLE, testArrayCount, ioid ) &&
+        client.response ( CA_PROTO_READ_NOTIFY, ioid, status,
+            readBack, sizeof ( readBack ) );
+    testOk ( ok && status == ECA_NORMAL, "two array writes and a read" );
+    testOk ( memcmp ( first, readBack, sizeof ( first ) ) == 0,
+        "the array kept from the first write is unchanged" );
+}
+
+//
+// A DBR_CTRL_DOUBLE read of a PV which caches its posted events,
+// but hasnt posted the limits and precision, must be answered by
+// the server tool, and a DBR_DOUBLE read from the value posted.
+//
+static void testCachedControlRead ( testCachedPV & pv )
+{
+    testClient client;
+    ca_uint32_t sid;
+    if ( ! testConnect ( client, "casTest:cached", sid ) ) {
+        testSkip ( 6, "not connected" );
+        return;
+    }
+
+    dbr_double_t value = 2.5;
+    struct dbr_ctrl_double ctrl;
+    memset ( & ctrl, '\0', sizeof ( ctrl ) );
+    ca_uint32_t ioid;
+    int status = ECA_GETFAIL;
+    bool ok = client.write ( sid, DBR_DOUBLE, 1u, & value ) &&
+        client.readNotify ( sid, DBR_CTRL_DOUBLE, 1u, ioid ) &&
+        client.response ( CA_PROTO_READ_NOTIFY, ioid, status,
+            & ctrl, sizeof ( ctrl ) );
+    testOk ( ok && status == ECA_NORMAL,
+        "a value posted and a DBR_CTRL_DOUBLE read" );
+    testOk ( ctrl.value == 2.5, "the value is %g", ctrl.value );
+    testOk ( ctrl.precision == 3, "the precision is %d", ctrl.precision );
+    testOk ( ctrl.upper_disp_limit == 10.0, "the upper display limit is %g",
+        ctrl.upper_disp_limit );
+
+    unsigned nRead = pv.readCount ();
+    value = 0.0;
+    status = ECA_GETFAIL;
+    ok = client.readNotify ( sid, DBR_DOUBLE, 1u, ioid ) &&
+        client.response ( CA_PROTO_READ_NOTIFY, ioid, status,
+            & value, sizeof ( value ) );
+    testOk ( ok && status == ECA_NORMAL && value == 2.5,
+        "a DBR_DOUBLE read returns %g", value );
+    testOk ( pv.readCount () == nRead,
+        "the DBR_DOUBLE read was answered from the posted value" );
+}
+
+//
+// A DBR_CTRL_DOUBLE subscriber is sent the limits, precision, and
+// units of the last property event with each value posted alone,
+// and not the zeros of the value only event.
+//
+static void testPropertyCache ( testPropertyPV & pv )
+{
+    testClient client;
+    ca_uint32_t sid;
+    if ( ! testConnect ( client, "casTest:property", sid ) ) {
+        testSkip ( 5, "not connected" );
+        return;
+    }
+
+    struct dbr_ctrl_double ctrl;
+    memset ( & ctrl, '\0', sizeof ( ctrl ) );
+    ca_uint32_t subid;
+    int status = ECA_GETFAIL;
+    bool ok = client.subscribe ( sid, DBR_CTRL_DOUBLE, 1u, DBE_VALUE, subid ) &&
+        client.response ( CA_PROTO_EVENT_ADD, subid, status,
+            & ctrl, sizeof ( ctrl ) );
+    testOk ( ok && status == ECA_NORMAL && ctrl.precision == 0,
+        "the first update has the precision read, %d", ctrl.precision );
+
+    pv.postProperties ();
+    pv.postValue ( 1.5 );
+    memset ( & ctrl, '\0', sizeof ( ctrl ) );
+    status = ECA_GETFAIL;
+    ok = client.response ( CA_PROTO_EVENT_ADD, subid, status,
+        & ctrl, sizeof ( ctrl ) );
+    testOk ( ok && status == ECA_NORMAL && ctrl.value == 1.5,
+        "the value posted alone is %g", ctrl.value );
+    testOk ( ctrl.precision == 4, "its precision is %d", ctrl.precision );
+    testOk ( ctrl.upper_disp_limit == 5.0 && ctrl.lower_disp_limit == -5.0,
+        "its display limits are %g and %g", ctrl.lower_disp_limit,
+        ctrl.upper_disp_limit );
+    ctrl.units[sizeof ( ctrl.units ) - 1u] = '\0';
+    testOk ( strcmp ( ctrl.units, "mV" ) == 0, "its units are \"%s\"",
+        ctrl.units );
+}
+
+struct testAsyncState {
+    unsigned nRead;
+    unsigned nPending;
+    aitFloat64 value;
+};
+
+static void testAsyncCount ( testServer & cas, void * pArg )
+{
+    testAsyncState & state = * static_cast < testAsyncState * > ( pArg );
+    state.nRead = cas.asyncPV.takeReadCount ();
+    state.nPending = cas.asyncPV.pendingCount ();
+}
+
+static void testAsyncComplete ( testServer & cas, void * pArg )
+{
+    testAsyncState & state = * static_cast < testAsyncState * > ( pArg );
+    cas.asyncPV.complete ( state.value );
+}
+
+//
+// returns when the server has processed the read
+//
+static bool testStartRead ( testClient & client, ca_uint32_t sid,
+    unsigned dbrType, ca_uint32_t & ioid )
+{
+    return client.readNotify ( sid, dbrType, 1u, ioid ) && client.echo ();
+}
+
+//
+// Reads of a PV which coalesces them, by two clients, while the
+// server tool's asynchronous read is pending. A read of the same
+// application type and element count, but of another primitive
+// type, waits for the read in flight. A read of another application
+// type doesnt. The waiting read fails if the read in flight is
+// canceled, and the read in flight completes if the waiting read is
+// removed.
+//
+static void testCoalescedReads ( testServerArgs & args )
+{
+    testClient first;
+    testClient second;
+    ca_uint32_t firstSid, secondSid;
+    bool firstOK = testConnect ( first, "casTest:async", firstSid );
+    bool secondOK = testConnect ( second, "casTest:async", secondSid );
+    if ( ! firstOK || ! secondOK ) {
+        testSkip ( 9, "not connected" );
+        return;
+    }
+
+    testAsyncState state;
+    testRunJob ( args, testAsyncCount, & state );
+
+    ca_uint32_t firstIO, secondIO;
+    dbr_double_t doubleValue = 0.0;
+    dbr_float_t floatValue = 0.0f;
+    int firstStatus = ECA_GETFAIL;
+    int secondStatus = ECA_GETFAIL;
+    bool ok = testStartRead ( first, firstSid, DBR_DOUBLE, firstIO ) &&
+        testStartRead ( second, secondSid, DBR_FLOAT, secondIO );
+    testRunJob ( args, testAsyncCount, & state );
+    testOk ( ok && state.nRead == 1u && state.nPending == 1u,
+        "a DBR_FLOAT read joined the DBR_DOUBLE read in flight" );
+    state.value = 7.0;
+    testRunJob ( args, testAsyncComplete, & state );
+    ok = first.response ( CA_PROTO_READ_NOTIFY, firstIO, firstStatus,
+        & doubleValue, sizeof ( doubleValue ) );
+    testOk ( ok && firstStatus == ECA_NORMAL && doubleValue == 7.0,
+        "the read in flight completed with %g", doubleValue );
+    ok = second.response ( CA_PROTO_READ_NOTIFY, secondIO, secondStatus,
+        & floatValue, sizeof ( floatValue ) );
+    testOk ( ok && secondStatus == ECA_NORMAL && floatValue == 7.0f,
+        "the joined read completed with %g", floatValue );
+
+    struct dbr_ctrl_double ctrl;
+    ok = testStartRead ( first, firstSid, DBR_DOUBLE, firstIO ) &&
+        testStartRead ( second, secondSid, DBR_CTRL_DOUBLE, secondIO );
+    testRunJob ( args, testAsyncCount, & state );
+    testOk ( ok && state.nRead == 2u && state.nPending == 2u,
+        "a DBR_CTRL_DOUBLE read didnt join the DBR_DOUBLE read in flight" );
+    state.value = 8.0;
+    testRunJob ( args, testAsyncComplete, & state );
+    ok = first.response ( CA_PROTO_READ_NOTIFY, firstIO, firstStatus,
+            & doubleValue, sizeof ( doubleValue ) ) &&
+        second.response ( CA_PROTO_READ_NOTIFY, secondIO, secondStatus,
+            & ctrl, sizeof ( ctrl ) );
+    testOk ( ok && firstStatus == ECA_NORMAL && secondStatus == ECA_NORMAL,
+        "both reads completed" );
+
+    ok = testStartRead ( first, firstSid, DBR_DOUBLE, firstIO ) &&
+        testStartRead ( second, secondSid, DBR_DOUBLE, secondIO ) &&
+        first.clearChannel ( firstSid );
+    secondStatus = ECA_NORMAL;
+    ok = ok && second.response ( CA_PROTO_READ_NOTIFY, secondIO,
+        secondStatus, 0, 0u );
+    testOk ( ok && secondStatus == ECA_GETFAIL,
+        "the joined read failed when the read in flight was canceled" );
+    testRunJob ( args, testAsyncCount, & state );
+    testOk ( state.nRead == 1u && state.nPending == 0u,
+        "the server tool's read was destroyed with its channel" );
+
+    ok = first.createChannel ( "casTest:async", firstSid ) &&
+        testStartRead ( first, firstSid, DBR_DOUBLE, firstIO ) &&
+        testStartRead ( second, secondSid, DBR_FLOAT, secondIO ) &&
+        second.clearChannel ( secondSid );
+    state.value = 9.0;
+    testRunJob ( args, testAsyncComplete, & state );
+    ok = ok && first.response ( CA_PROTO_READ_NOTIFY, firstIO,
+        firstStatus, & doubleValue, sizeof ( doubleValue ) );
+    testOk ( ok && firstStatus == ECA_NORMAL && doubleValue == 9.0,
+        "the read in flight completed after the joined read was removed" );
+    testOk ( second.echo (), "the client of the removed read is served" );
+}
+
+//
+// records the callbacks of a casDirect channel
+//
+class testDirectNotify : public casDirectChannelNotify,
+    public casDirectSubscriptionNotify, public casDirectReadNotify {
+public:
+    testDirectNotify ();
+    void connectNotify ( caStatus status );
+    void disconnectNotify ();
+    void update ( const gdd & value );
+    void readCompletion ( const gdd & value );
+    void readException ( caStatus status );
+    unsigned nConnect;
+    unsigned nUpdate;
+    unsigned nRead;
+    caStatus status;
+    aitFloat64 value;
+private:
+    testDirectNotify ( const testDirectNotify & );
+    testDirectNotify & operator = ( const testDirectNotify & );
+};
+
+//
+// the value is a member of the container read, and
+// is posted alone
+//
+static aitFloat64 testValueOf ( const gdd & dd )
+{
+    aitFloat64 value = 0.0;
+    if ( dd.isContainer () ) {
+        aitUint32 index;
+        if ( gddApplicationTypeTable::AppTable ().mapAppToIndex (
+                dd.applicationType (), gddAppType_value, index ) == 0 ) {
+            dd.getDD ( index )->getConvert ( value );
+        }
+    }
+    else {
+        dd.getConvert ( value );
+    }
+    return value;
+}
+
+testDirectNotify::testDirectNotify () :
+    nConnect ( 0u ), nUpdate ( 0u ), nRead ( 0u ),
+    status ( S_cas_internal ), value ( 0.0 )
+{
+}
+
+void testDirectNotify::connectNotify ( caStatus statusIn )
+{
+    this->nConnect++;
+    this->status = statusIn;
+}
+
+void testDirectNotify::disconnectNotify ()
+{
+}
+
+void testDirectNotify::update ( const gdd & valueIn )
+{
+    this->nUpdate++;
+    this->value = testValueOf ( valueIn );
+}
+
+void testDirectNotify::readCompletion ( const gdd & valueIn )
+{
+    this->nRead++;
+    this->status = S_cas_success;
+    this->value = testValueOf ( valueIn );
+}
+
+void testDirectNotify::readException ( caStatus statusIn )
+{
+    this->nRead++;
+    this->status = statusIn;
+}
+
+//
+// processes the server's events until the count reaches the
+// target, or the time allowed expires
+//
+static bool testDirectWait ( const unsigned & n, unsigned target )
+{
+    for ( double waited = 0.0; waited < testTimeout; waited += 0.01 ) {
+        if ( n >= target ) {
+            return true;
+        }
+        fileDescriptorManager.process ( 0.01 );
+    }
+    return n >= target;
+}
+
+//
+// A casDirect, in the server's thread, connects to the PVs, reads
+// them whether they complete their reads now, later, or from the
+// value posted, and is sent the value posted to a subscription.
+//
+static void testDirect ( testServer & cas, void * )
+{
+    casDirect direct ( cas, "casServerTest", "localhost" );
+    testDirectNotify propertyNotify;
+    testDirectNotify asyncNotify;
+    testDirectNotify cachedNotify;
+    testDirectNotify missingNotify;
+    casDirectId propertyChan, asyncChan, cachedChan, missingChan;
+    bool ok = direct.createChannel ( "casTest:property", propertyNotify,
+            propertyChan ) == S_cas_success &&
+        direct.createChannel ( "casTest:async", asyncNotify,
+            asyncChan ) == S_cas_success &&
+        direct.createChannel ( "casTest:cached", cachedNotify,
+            cachedChan ) == S_cas_success &&
+        testDirectWait ( propertyNotify.nConnect, 1u ) &&
+        testDirectWait ( asyncNotify.nConnect, 1u ) &&
+        testDirectWait ( cachedNotify.nConnect, 1u );
+    testOk ( ok && propertyNotify.status == S_cas_success &&
+        asyncNotify.status == S_cas_success &&
+        cachedNotify.status == S_cas_success,
+        "casDirect channels connected" );
+    if ( ! ok ) {
+        testSkip ( 7, "not connected" );
+        return;
+    }
+
+    ok = direct.createChannel ( "casTest:missing", missingNotify,
+            missingChan ) == S_cas_success &&
+        testDirectWait ( missingNotify.nConnect, 1u );
+    testOk ( ok && missingNotify.status != S_cas_success &&
+        direct.destroyChannel ( missingChan ) == S_cas_success,
+        "a channel to a PV which doesnt exist failed to connect" );
+
+    cas.propertyPV.postValue ( 2.0 );
+    ok = direct.read ( propertyChan, propertyNotify ) == S_cas_success &&
+        testDirectWait ( propertyNotify.nRead, 1u );
+    testOk ( ok && propertyNotify.status == S_cas_success &&
+        propertyNotify.value == 2.0,
+        "a read completed by the server tool now returned %g",
+        propertyNotify.value );
+
+    ok = direct.read ( asyncChan, asyncNotify ) == S_cas_success &&
+        asyncNotify.nRead == 0u && cas.asyncPV.pendingCount () == 1u;
+    cas.asyncPV.complete ( 5.0 );
+    ok = ok && testDirectWait ( asyncNotify.nRead, 1u );
+    testOk ( ok && asyncNotify.status == S_cas_success &&
+        asyncNotify.value == 5.0,
+        "a read completed by the server tool later returned %g",
+        asyncNotify.value );
+
+    casDirectId subscription;
+    ok = direct.subscribe ( propertyChan, cas.valueEventMask (),
+            propertyNotify, subscription ) == S_cas_success &&
+        testDirectWait ( propertyNotify.nUpdate, 1u );
+    cas.propertyPV.postValue ( 3.0 );
+    ok = ok && testDirectWait ( propertyNotify.nUpdate, 2u );
+    testOk ( ok && propertyNotify.value == 3.0,
+        "the subscription was sent the value posted, %g",
+        propertyNotify.value );
+    testOk ( direct.cancelSubscription ( subscription ) == S_cas_success,
+        "the subscription was canceled" );
+
+    unsigned nRead = cas.cachedPV.readCount ();
+    cas.cachedPV.postValue ( 6.0 );
+    ok = direct.read ( cachedChan, cachedNotify ) == S_cas_success &&
+        testDirectWait ( cachedNotify.nRead, 1u );
+    testOk ( ok && cachedNotify.status == S_cas_success &&
+        cachedNotify.value == 6.0 && cas.cachedPV.readCount () == nRead,
+        "a read of the PV caching its events returned the value posted, %g",
+        cachedNotify.value );
+
+    testOk ( direct.destroyChannel ( propertyChan ) == S_cas_success &&
+        direct.destroyChannel ( asyncChan ) == S_cas_success &&
+        direct.destroyChannel ( cachedChan ) == S_cas_success &&
+        direct.destroyChannel ( cachedChan ) == S_cas_badResourceId,
+        "the channels were destroyed once" );
+}
+
+MAIN ( casServerTest )
+{
+    testPlan ( 35 );
+
+    epicsEnvSet ( "EPICS_CAS_INTF_ADDR_LIST", "127.0.0.1" );
+    epicsEnvSet ( "EPICS_CAS_SERVER_PORT", testPort );
+    epicsEnvSet ( "EPICS_CAS_AUTO_BEACON_ADDR_LIST", "NO" );
+    epicsEnvSet ( "EPICS_CAS_BEACON_ADDR_LIST", "127.0.0.1" );
+
+    testServerArgs args;
+    args.pCAS = 0;
+    args.pJob = 0;
+    args.pJobArg = 0;
+    args.exit = false;
+    args.ok = false;
+    epicsThreadCreate ( "casServerTest", epicsThreadPriorityMedium,
+        epicsThreadGetStackSize ( epicsThreadStackBig ),
+        testServerThread, & args );
+    args.ready.wait ();
+    if ( ! args.ok ) {
+        testAbort ( "the server wasnt created" );
+    }
+
+    osiSockAttach ();
+    testRetainedWrite ();
+    testCachedControlRead ( args.pCAS->cachedPV );
+    testCoalescedReads ( args );
+    testPropertyCache ( args.pCAS->propertyPV );
+    testRunJob ( args, testDirect, 0 );
+
+    args.exit = true;
+    args.done.wait ();
+    osiSockRelease ();
+    return testDone ();
+}
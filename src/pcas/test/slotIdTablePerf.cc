@@ -0,0 +1,165 @@
+/*************************************************************************\
+* Copyright (c) 2002 The University of Chicago, as Operator of Argonne
+*     National Laboratory.
+* Copyright (c) 2002 The Regents of the University of California, as
+*     Operator of Los Alamos National Laboratory.
+* EPICS BASE is distributed subject to a Software License Agreement found
+* in file LICENSE that is included with this distribution.
+\*************************************************************************/
+//
+// slotIdTablePerf.cc
+//
+// timing of the server channel id table, slotIdTable, and of the
+// chronIntIdResTable which it replaced
+//
+
+#include <stdio.h>
+
+#include "epicsTime.h"
+#include "resourceLib.h"
+#include "slotIdTable.h"
+
+static const unsigned nLookups = 1000000u;
+static const unsigned nChurn = 100000u;
+static const unsigned nTrials = 5u;
+
+class slotChan : public slotIdRes {
+};
+
+class hashChan : public chronIntIdRes < hashChan > {
+};
+
+//
+// the ids are looked up in a scattered order, as the requests
+// of a client with many channels arrive
+//
+static inline unsigned scatter ( unsigned i, unsigned n )
+{
+    return ( i * 2654435761u ) % n;
+}
+
+static double best ( double delay, unsigned trial, double trialDelay )
+{
+    return ( trial == 0u || trialDelay < delay ) ? trialDelay : delay;
+}
+
+static void lookupPerf ( unsigned nChan )
+{
+    slotIdTable < slotChan > slotTable;
+    chronIntIdResTable < hashChan > hashTable;
+    slotChan * pSlotChan = new slotChan [ nChan ];
+    hashChan * pHashChan = new hashChan [ nChan ];
+    epicsUInt32 * pSlotIds = new epicsUInt32 [ nChan ];
+    chronIntIdT * pHashIds = new chronIntIdT [ nChan ];
+    for ( unsigned i = 0u; i < nChan; i++ ) {
+        slotTable.idAssignAdd ( pSlotChan[i] );
+        pSlotIds[i] = pSlotChan[i].getId ();
+        hashTable.idAssignAdd ( pHashChan[i] );
+        pHashIds[i] = pHashChan[i].getId ();
+    }
+
+    unsigned nMissing = 0u;
+    double slotDelay = 0.0;
+    for ( unsigned trial = 0u; trial < nTrials; trial++ ) {
+        epicsTime begin = epicsTime::getCurrent ();
+        for ( unsigned j = 0u; j < nLookups; j++ ) {
+            if ( ! slotTable.lookup ( pSlotIds[scatter ( j, nChan )] ) ) {
+                nMissing++;
+            }
+        }
+        slotDelay = best ( slotDelay, trial,
+            epicsTime::getCurrent () - begin );
+    }
+
+    double hashDelay = 0.0;
+    for ( unsigned trial = 0u; trial < nTrials; trial++ ) {
+        epicsTime begin = epicsTime::getCurrent ();
+        for ( unsigned j = 0u; j < nLookups; j++ ) {
+            chronIntId id ( pHashIds[scatter ( j, nChan )] );
+            if ( ! hashTable.lookup ( id ) ) {
+                nMissing++;
+            }
+        }
+        hashDelay = best ( hashDelay, trial,
+            epicsTime::getCurrent () - begin );
+    }
+
+    printf ( "\t%7u channels %8.1f nS slot, %8.1f nS hash per lookup%s\n",
+        nChan, slotDelay * 1e9 / nLookups, hashDelay * 1e9 / nLookups,
+        nMissing ? " (lookup failed)" : "" );
+
+    for ( unsigned i = 0u; i < nChan; i++ ) {
+        slotTable.remove ( pSlotChan[i] );
+        hashTable.remove ( pHashChan[i] );
+    }
+    delete [] pHashIds;
+    delete [] pSlotIds;
+    delete [] pHashChan;
+    delete [] pSlotChan;
+}
+
+//
+// a channel is destroyed and another created, as clients
+// which connect and disconnect repeatedly do
+//
+static void churnPerf ( unsigned nChan )
+{
+    slotIdTable < slotChan > slotTable;
+    chronIntIdResTable < hashChan > hashTable;
+    slotChan * pSlotChan = new slotChan [ nChan ];
+    hashChan * pHashChan = new hashChan [ nChan ];
+    for ( unsigned i = 0u; i < nChan; i++ ) {
+        slotTable.idAssignAdd ( pSlotChan[i] );
+        hashTable.idAssignAdd ( pHashChan[i] );
+    }
+
+    double slotDelay = 0.0;
+    for ( unsigned trial = 0u; trial < nTrials; trial++ ) {
+        epicsTime begin = epicsTime::getCurrent ();
+        for ( unsigned j = 0u; j < nChurn; j++ ) {
+            slotChan & chan = pSlotChan[scatter ( j, nChan )];
+            slotTable.remove ( chan );
+            slotTable.idAssignAdd ( chan );
+        }
+        slotDelay = best ( slotDelay, trial,
+            epicsTime::getCurrent () - begin );
+    }
+
+    double hashDelay = 0.0;
+    for ( unsigned trial = 0u; trial < nTrials; trial++ ) {
+        epicsTime begin = epicsTime::getCurrent ();
+        for ( unsigned j = 0u; j < nChurn; j++ ) {
+            hashChan & chan = pHashChan[scatter ( j, nChan )];
+            hashTable.remove ( chan );
+            hashTable.idAssignAdd ( chan );
+        }
+        hashDelay = best ( hashDelay, trial,
+            epicsTime::getCurrent () - begin );
+    }
+
+    printf ( "\t%7u channels %8.1f nS slot, %8.1f nS hash per remove and add\n",
+        nChan, slotDelay * 1e9 / nChurn, hashDelay * 1e9 / nChurn );
+
+    for ( unsigned i = 0u; i < nChan; i++ ) {
+        slotTable.remove ( pSlotChan[i] );
+        hashTable.remove ( pHashChan[i] );
+    }
+    delete [] pHashChan;
+    delete [] pSlotChan;
+}
+
+int main ()
+{
+    static const unsigned nChan[] = { 16u, 1000u, 100000u };
+    static const unsigned nSizes = sizeof ( nChan ) / sizeof ( nChan[0] );
+
+    printf ( "channel id lookup\n" );
+    for ( unsigned i = 0u; i < nSizes; i++ ) {
+        lookupPerf ( nChan[i] );
+    }
+    printf ( "channel id remove and add\n" );
+    for ( unsigned i = 0u; i < nSizes; i++ ) {
+        churnPerf ( nChan[i] );
+    }
+    return 0;
+}